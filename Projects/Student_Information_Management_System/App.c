@@ -1,5 +1,168 @@
 
 #include"App.h"
+#include <string.h>
+
+/* Reads a line of course IDs separated by spaces or commas into a mask */
+static Course_Mask_t Read_Course_Mask(const char* prompt)
+{
+    char line[100];
+    Course_Mask_t mask = 0;
+
+    printf("%s", prompt);
+    if (!fgets(line, sizeof(line), stdin))
+        return 0;
+
+    for (char* token = my_strtok(line, " ,\n"); token; token = my_strtok(NULL, " ,\n"))
+    {
+        int course_id = atoi(token);
+        if (course_id >= 1 && course_id <= MAX_COURSE_ID)
+            mask |= (Course_Mask_t)(1u << course_id);
+    }
+    return mask;
+}
+
+/* Reads one answer of the update prompts; true unless it keeps the old value (empty or 0) */
+static bool Read_Update_Field(char* input, int size)
+{
+    if (!fgets(input, size, stdin))
+        return false;
+    input[strcspn(input, "\n")] = 0;
+    return my_strlen(input) > 0 && my_memcmp(input, "0", my_strlen(input)) != 0;
+}
+
+/* Prompts for the new values of a student and collects the fields to change */
+static Update_Mask_t Prompt_Student_Update(const Student_t* current, Student_Update_t* values)
+{
+    Update_Mask_t fields = 0;
+    char input[100];
+
+    printf("\nUpdating Student ID: %u\n", (unsigned)current->id);
+    printf("Leave field unchanged by entering 0 or empty.\n");
+
+    /* ---------- First Name ---------- */
+    printf("Current First Name: %s\nEnter new First Name: ", current->first_name);
+    if (Read_Update_Field(input, sizeof(input)))
+    {
+        my_strncpy(values->first_name, input, sizeof(values->first_name) - 1);
+        values->first_name[sizeof(values->first_name) - 1] = 0;
+        fields |= UPDATE_FIRST_NAME;
+    }
+
+    /* ---------- Last Name ---------- */
+    printf("Current Last Name: %s\nEnter new Last Name: ", current->last_name);
+    if (Read_Update_Field(input, sizeof(input)))
+    {
+        my_strncpy(values->last_name, input, sizeof(values->last_name) - 1);
+        values->last_name[sizeof(values->last_name) - 1] = 0;
+        fields |= UPDATE_LAST_NAME;
+    }
+
+    /* ---------- GPA ---------- */
+    printf("Current GPA: %.2f\nEnter new GPA: ", current->GPA);
+    if (Read_Update_Field(input, sizeof(input)))
+    {
+        float gpa_val = atof(input);
+        if (gpa_val >= 0.0f && gpa_val <= 4.0f)
+        {
+            values->GPA = gpa_val;
+            fields |= UPDATE_GPA;
+        }
+        else
+        {
+            printf("Invalid GPA! Keeping previous value.\n");
+        }
+    }
+
+    /* ---------- Courses ---------- */
+    printf("Current Courses (%d): ", current->course_count);
+    for (int i = 0; i < current->course_count; i++)
+        printf("%u ", current->courses[i]);
+    printf("\nEnter number of new courses : ");
+    if (Read_Update_Field(input, sizeof(input)))
+    {
+        int new_count = atoi(input);
+        if (new_count > 0 && new_count <= MAX_COURSES)
+        {
+            values->course_count = new_count;
+            for (int i = 0; i < new_count; i++)
+            {
+                while (1)
+                {
+                    printf("Enter course %d (1-%d): ", i + 1, MAX_COURSES);
+                    if (!fgets(input, sizeof(input), stdin))
+                        return 0;
+                    int cid = atoi(input);
+                    if (cid >= 1 && cid <= MAX_COURSES)
+                    {
+                        values->courses[i] = cid;
+                        break;
+                    }
+                    else
+                    {
+                        printf("Invalid Course ID. Try again.\n");
+                    }
+                }
+            }
+            fields |= UPDATE_COURSES;
+        }
+        else
+        {
+            printf("Invalid number of courses. Keeping old courses.\n");
+        }
+    }
+    return fields;
+}
+
+/* Turns a list like "id,gpa" into export columns: all for an empty list, 0 for an unknown name */
+static Export_Columns_t Parse_Export_Columns(char* list)
+{
+    Export_Columns_t columns = 0;
+
+    for (char* token = my_strtok(list, " ,\n"); token; token = my_strtok(NULL, " ,\n"))
+    {
+        if (strcmp(token, "all") == 0)          columns |= EXPORT_COLUMNS_ALL;
+        else if (strcmp(token, "id") == 0)      columns |= EXPORT_COLUMN_ID;
+        else if (strcmp(token, "first") == 0)   columns |= EXPORT_COLUMN_FIRST_NAME;
+        else if (strcmp(token, "last") == 0)    columns |= EXPORT_COLUMN_LAST_NAME;
+        else if (strcmp(token, "gpa") == 0)     columns |= EXPORT_COLUMN_GPA;
+        else if (strcmp(token, "courses") == 0) columns |= EXPORT_COLUMN_COURSES;
+        else return 0;
+    }
+    return (columns) ? columns : EXPORT_COLUMNS_ALL;
+}
+
+/* Exports with the format and columns given by name, and reports the outcome */
+static F_Return_t Export_By_Name(const char* export_file, const char* format_name, char* column_list)
+{
+    Export_Format_t format;
+    uint32_t exported = 0;
+
+    if (strcmp(format_name, "csv") == 0)
+        format = EXPORT_FORMAT_CSV;
+    else if (strcmp(format_name, "binary") == 0)
+        format = EXPORT_FORMAT_BINARY;
+    else
+    {
+        printf("Unknown export format %s (csv or binary).\n", format_name);
+        return F_INVALID_FIELD;
+    }
+
+    Export_Columns_t columns = Parse_Export_Columns(column_list);
+    if (columns == 0)
+    {
+        printf("Unknown export column (id, first, last, gpa, courses or all).\n");
+        return F_INVALID_FIELD;
+    }
+
+    double start = Platform_Time_Seconds();
+    F_Return_t status = Export_Students(export_file, format, columns, &exported);
+    if (status == F_OK)
+        printf("Exported %u students to %s in %.2f s.\n", (unsigned)exported, export_file, Platform_Time_Seconds() - start);
+    else
+        printf("Error exporting students.\n");
+    return status;
+}
+
 /**
  * @brief  Runs the main application loop of the Student Management System.
  *
@@ -14,6 +177,13 @@ void App_System() {
     char fname[50];
     Course_t course;
     Student_t student;
+    F_Return_t status;
+
+    if (System_Init() != F_OK)
+    {
+        printf("Failed to initialize the student database.\n");
+        return;
+    }
 
     while (1)
     {
@@ -28,7 +198,15 @@ void App_System() {
         printf("==  8. Show All Students                                                         ==\n");
         printf("==  9. Delete All Students                                                       ==\n");
         printf("==  10. Restore Database from Backup                                             ==\n");
-        printf("==  11. Exit                                                                     ==\n");
+        printf("==  11. Compact Database                                                         ==\n");
+        printf("==  12. Get Students By Course Combination                                       ==\n");
+        printf("==  13. Search Students By Name                                                  ==\n");
+        printf("==  14. Get Students By GPA Range                                                ==\n");
+        printf("==  15. Get Top Students By GPA                                                  ==\n");
+        printf("==  16. Post GPA Changes                                                         ==\n");
+        printf("==  17. Show Cache Statistics                                                    ==\n");
+        printf("==  18. Export Students                                                          ==\n");
+        printf("==  19. Exit                                                                     ==\n");
         printf("===================================================================================\n");
         printf("Enter your choice: ");
         scanf("%d", &choice);
@@ -46,14 +224,17 @@ void App_System() {
             student.last_name[strcspn(student.last_name, "\n")] = 0;
             printf("GPA: "); scanf("%f", &student.GPA);
             printf("Number of courses: "); scanf("%hhu", &student.course_count);
-            for (int i = 0; i < student.course_count; i++)
+            for (int i = 0; i < student.course_count && i < MAX_COURSES; i++)
             {
                 printf("Course %d: ", i + 1);
                 scanf("%hhu", &student.courses[i]);
             }
             student.is_active = 1;
-            if (Add_Student_Manually(&student) == F_OK)
+            status = Add_Student_Manually(&student);
+            if (status == F_OK)
                 printf("Student added successfully.\n");
+            else if (status == F_INVALID_FIELD)
+                printf("Invalid student details, nothing added.\n");
             else
                 printf("Error adding student.\n");
             getchar(); // consume newline
@@ -62,13 +243,18 @@ void App_System() {
         case 2:
         {
             char filename[100];
+            char reject_file[120];
+            Import_Report_t report = { 0 };
             printf("Enter import filename: ");
-            scanf("%s", filename);
+            scanf("%99s", filename);
             getchar();
-            if (Add_Student_From_File(filename) == F_OK)
+            snprintf(reject_file, sizeof(reject_file), "%s%s", filename, APP_REJECT_FILE_SUFFIX);
+            if (Add_Student_From_File(filename, reject_file, &report) == F_OK)
                 printf("Students imported successfully.\n");
             else
                 printf("Error importing students.\n");
+            if (report.rejected > 0)
+                printf("Rejected records listed in %s\n", reject_file);
         }
         break;
 
@@ -102,10 +288,20 @@ void App_System() {
             printf("Enter Student ID to update: ");
             scanf("%u", &id);
             getchar();
-            if (Update_Student(id) == F_OK)
-                printf("Student updated successfully.\n");
-            else
+            if (Find_Student_By_ID(id, &student) != F_OK)
+            {
                 printf("Student not found.\n");
+                break;
+            }
+            {
+                /* Prompts run before the update, no record is held while the user types */
+                Student_Update_t values;
+                Update_Mask_t fields = Prompt_Student_Update(&student, &values);
+                if (Update_Student(id, fields, &values) == F_OK)
+                    printf("Student updated successfully.\n");
+                else
+                    printf("Failed to update student.\n");
+            }
             break;
 
         case 7:
@@ -137,8 +333,134 @@ void App_System() {
                 printf("Failed to restore database.\n");
             break;
 
-        case 11:
+        case 11: // Reclaim space of deleted students
+            if (Compact_Database(COMPACTION_STEP_RECORDS) != F_OK)
+                printf("Failed to compact database.\n");
+            break;
+
+        case 12: // Students taking some courses but not others
+        {
+            Course_Mask_t all_of = Read_Course_Mask("Courses taken (IDs separated by spaces): ");
+            Course_Mask_t none_of = Read_Course_Mask("Courses not taken (empty for none): ");
+            if (Get_Students_By_Courses(all_of, none_of) != F_OK)
+                printf("No students found for this course combination.\n");
+        }
+        break;
+
+        case 13: // Type-ahead search on first and last names
+        {
+            uint32_t ids[NAME_SEARCH_MAX_RESULTS];
+            uint32_t found = 0;
+            char text[MAX_NAME_LENGTH];
+            printf("Enter part of a name: ");
+            if (!fgets(text, sizeof(text), stdin))
+                break;
+            text[strcspn(text, "\n")] = 0;
+            printf("Match anywhere in the name? (y/n): ");
+            Name_Match_t match = (getchar() == 'y') ? NAME_MATCH_SUBSTRING : NAME_MATCH_PREFIX;
+            getchar();
+            if (Search_Students_By_Name(text, match, ids, NAME_SEARCH_MAX_RESULTS, &found) != F_OK)
+                printf("No students found.\n");
+            for (uint32_t i = 0; i < found; i++)
+            {
+                if (Find_Student_By_ID(ids[i], &student) == F_OK)
+                    Print_Student(&student);
+            }
+        }
+        break;
+
+        case 14: // Students between two GPAs, lowest first
+        {
+            float min_gpa, max_gpa;
+            printf("Lowest GPA: "); scanf("%f", &min_gpa);
+            printf("Highest GPA: "); scanf("%f", &max_gpa);
+            getchar();
+            if (Get_Students_By_GPA_Range(min_gpa, max_gpa) != F_OK)
+                printf("No students found in this GPA range.\n");
+        }
+        break;
+
+        case 15: // Best students, highest GPA first
+        {
+            unsigned int count = 0;
+            printf("Number of students: "); scanf("%u", &count);
+            getchar();
+            if (Get_Top_Students_By_GPA(count) != F_OK)
+                printf("No students to rank.\n");
+        }
+        break;
+
+        case 16: // Grade posting: all changes commit together or not at all
+        {
+            char line[100];
+            unsigned int entered_id;
+            unsigned int staged = 0;
+            Student_Update_t values;
+            if (Transaction_Begin() != F_OK)
+            {
+                printf("Another transaction is open, nothing posted.\n");
+                break;
+            }
+            printf("Enter \"ID GPA\" per line, empty line to post:\n");
+            while (fgets(line, sizeof(line), stdin) && sscanf(line, "%u %f", &entered_id, &values.GPA) == 2)
+            {
+                id = entered_id;
+                if (!(values.GPA >= 0.0f && values.GPA <= 4.0f))
+                {
+                    printf("GPA of student %u must be from 0.0 to 4.0, skipped.\n", entered_id);
+                    continue;
+                }
+                if (Find_Student_By_ID(id, &student) != F_OK)
+                {
+                    printf("Student %u not found, skipped.\n", entered_id);
+                    continue;
+                }
+                /* Only the GPA is staged, merged into the record at commit */
+                if (Transaction_Update(id, UPDATE_GPA, &values) == F_OK)
+                    staged++;
+            }
+            if (Transaction_Commit() == F_OK)
+                printf("%u GPA changes posted.\n", staged);
+            else
+                printf("Failed to post GPA changes, none applied.\n");
+        }
+        break;
+
+        case 17: // How well the record cache serves lookups
+        {
+            Record_Cache_Stats_t stats;
+            uint64_t lookups;
+            Record_Cache_Get_Stats(&stats);
+            lookups = stats.hits + stats.misses;
+            printf("Lookups:   %llu\n", (unsigned long long)lookups);
+            printf("Hits:      %llu (%.1f%%)\n", (unsigned long long)stats.hits,
+                   (lookups) ? 100.0 * (double)stats.hits / (double)lookups : 0.0);
+            printf("Misses:    %llu\n", (unsigned long long)stats.misses);
+            printf("Evictions: %llu\n", (unsigned long long)stats.evictions);
+            printf("Cached:    %u of %u records, %u dirty\n",
+                   (unsigned)stats.cached, (unsigned)stats.capacity, (unsigned)stats.dirty);
+        }
+        break;
+
+        case 18: // Roster dump in the import format, or packed binary
+        {
+            char filename[100];
+            char format[20];
+            char columns[100] = "";
+            printf("Enter export filename: ");
+            scanf("%99s", filename);
+            printf("Format (csv or binary): ");
+            scanf("%19s", format);
+            getchar();
+            printf("Columns (id,first,last,gpa,courses or all, empty for all): ");
+            fgets(columns, sizeof(columns), stdin);
+            Export_By_Name(filename, format, columns);
+        }
+        break;
+
+        case 19:
             printf("Exiting program.\n");
+            System_Deinit();
             return;
 
         default:
@@ -146,3 +468,83 @@ void App_System() {
         }
     }
 }
+
+F_Return_t App_Export(const char* export_file, const char* format, const char* columns)
+{
+    char column_list[100] = "";
+
+    if (System_Init() != F_OK)
+    {
+        printf("Failed to initialize the student database.\n");
+        return F_FILE_OPEN_ERROR;
+    }
+    if (columns)
+        snprintf(column_list, sizeof(column_list), "%s", columns);
+
+    F_Return_t status = Export_By_Name(export_file, format, column_list);
+    System_Deinit();
+    return status;
+}
+
+void App_Benchmark(const char* address, double seconds)
+{
+    static Student_t page[BENCHMARK_ID_COUNT];
+    static uint32_t ids[BENCHMARK_ID_COUNT];
+    static F_Return_t results[BENCHMARK_ID_COUNT];
+    Client_t client;
+    Student_t student;
+    uint32_t count = 0;
+    uint32_t queries = 0;
+
+    if (Client_Connect(&client, address) != F_OK)
+    {
+        printf("No server on %s.\n", address);
+        return;
+    }
+    if (Client_List(&client, 0, page, BENCHMARK_ID_COUNT, &count) != F_OK)
+    {
+        printf("The server has no students to look up.\n");
+        Client_Close(&client);
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++)
+        ids[i] = page[i].id;
+
+    /* One round trip per lookup */
+    double started = Platform_Time_Seconds();
+    double elapsed = 0.0;
+    while (elapsed < seconds)
+    {
+        /* Read the clock every 256 round trips, not on each */
+        for (uint32_t i = 0; i < 256; i++, queries++)
+        {
+            if (Client_Find_By_ID(&client, ids[queries % count], &student) != F_OK)
+            {
+                printf("Lookup failed after %u queries.\n", (unsigned)queries);
+                Client_Close(&client);
+                return;
+            }
+        }
+        elapsed = Platform_Time_Seconds() - started;
+    }
+    printf("Single:  %u queries in %.2f s: %.0f queries per second\n", (unsigned)queries, elapsed, (double)queries / elapsed);
+
+    /* One round trip per batch of every ID */
+    queries = 0;
+    started = Platform_Time_Seconds();
+    elapsed = 0.0;
+    while (elapsed < seconds)
+    {
+        if (Client_Find_By_IDs(&client, ids, count, page, results) != F_OK)
+        {
+            printf("Batch lookup failed after %u queries.\n", (unsigned)queries);
+            Client_Close(&client);
+            return;
+        }
+        queries += count;
+        elapsed = Platform_Time_Seconds() - started;
+    }
+    printf("Batched: %u queries in %.2f s: %.0f queries per second, %u per request\n",
+           (unsigned)queries, elapsed, (double)queries / elapsed, (unsigned)count);
+    Client_Close(&client);
+}
@@ -2,6 +2,15 @@
 #define _App_H
 
 #include"System.h"
+#include"Storage.h"
+#include"Transaction.h"
+#include"Record_Cache.h"
+#include"Client.h"
+#include"Platform.h"
+
+#define NAME_SEARCH_MAX_RESULTS    20    /* Students listed per name search */
+#define BENCHMARK_ID_COUNT         1024  /* Distinct IDs the benchmark looks up */
+#define APP_REJECT_FILE_SUFFIX     ".rejects.csv"  /* Reject file of an import, next to the imported file */
 
 /**
  * @brief  Runs the main application loop of the Student Management System.
@@ -14,6 +23,31 @@
 
 void App_System();
 
+/**
+ * @brief  Measures how many lookups by ID a server answers per second.
+ *
+ * @details
+ * - Fetches the first BENCHMARK_ID_COUNT students and looks
+ *   them up in turn, one round trip each, for the given time.
+ * - Then looks them all up again and again in one batch request
+ *   each, for the same time.
+ *
+ * @param  address "unix:<path>" or "tcp:<port>" of the server.
+ * @param  seconds How long to run.
+ */
+void App_Benchmark(const char* address, double seconds);
+
+/**
+ * @brief  Exports the database without the menu, for scheduled dumps.
+ *
+ * @param  export_file Path of the file to create.
+ * @param  format      "csv" or "binary".
+ * @param  columns     Column names separated by commas: id, first,
+ *                     last, gpa, courses or all. NULL for all.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t App_Export(const char* export_file, const char* format, const char* columns);
+
 
 
 
@@ -0,0 +1,454 @@
+#include "Client.h"
+#include "Protocol.h"
+
+#define CLIENT_INITIAL_CAPACITY   4096
+
+static F_Return_t Lost(Client_t* client)
+{
+    Client_Close(client);
+    return F_CONNECTION_ERROR;
+}
+
+static F_Return_t Reserve(Client_t* client, uint32_t bytes)
+{
+    uint32_t capacity = client->capacity ? client->capacity : CLIENT_INITIAL_CAPACITY;
+
+    if (bytes <= client->capacity)
+        return F_OK;
+    while (capacity < bytes)
+        capacity *= 2;
+
+    uint8_t* grown = realloc(client->buffer, capacity);
+    if (!grown)
+        return F_NOT_OK;
+    client->buffer = grown;
+    client->capacity = capacity;
+    return F_OK;
+}
+
+static F_Return_t Receive_All(Client_t* client, uint8_t* buffer, uint32_t size)
+{
+    while (size > 0)
+    {
+        long got = Platform_Receive(&client->socket, buffer, size);
+        if (got <= 0)
+            return F_NOT_OK;
+        buffer += got;
+        size -= (uint32_t)got;
+    }
+    return F_OK;
+}
+
+/**
+ * @brief  Sends the request whose payload is in the buffer after
+ *         the header room and receives its reply.
+ *
+ * @details
+ * - The reply payload replaces the request after the header room.
+ *
+ * @return The server's status, or F_CONNECTION_ERROR.
+ */
+static F_Return_t Exchange(Client_t* client, Protocol_Op_t op, uint32_t length, Protocol_Header_t* reply)
+{
+    Protocol_Header_t request;
+
+    if (!client->socket.open)
+        return F_CONNECTION_ERROR;
+
+    request.length = length;
+    request.op = (uint8_t)op;
+    request.status = 0;
+    request.tag = client->next_tag++;
+    Protocol_Put_Header(client->buffer, &request);
+
+    if (Platform_Send(&client->socket, client->buffer, PROTOCOL_HEADER_SIZE + length) != 0)
+        return Lost(client);
+    if (Receive_All(client, client->buffer, PROTOCOL_HEADER_SIZE) != F_OK)
+        return Lost(client);
+
+    Protocol_Get_Header(client->buffer, reply);
+    if (reply->tag != request.tag || reply->op != request.op || reply->length > PROTOCOL_MAX_PAYLOAD)
+        return Lost(client);
+    if (Reserve(client, PROTOCOL_HEADER_SIZE + reply->length) != F_OK
+        || Receive_All(client, client->buffer + PROTOCOL_HEADER_SIZE, reply->length) != F_OK)
+        return Lost(client);
+
+    return (F_Return_t)reply->status;
+}
+
+/* Requests with no result: the reply must be empty */
+static F_Return_t Exchange_Empty(Client_t* client, Protocol_Op_t op, uint32_t length)
+{
+    Protocol_Header_t reply;
+    F_Return_t status = Exchange(client, op, length, &reply);
+
+    if (status != F_CONNECTION_ERROR && reply.length != 0)
+        return Lost(client);
+    return status;
+}
+
+/* Unpacks a student list reply into the caller's array */
+static F_Return_t Exchange_List(Client_t* client, Protocol_Op_t op, uint32_t length,
+                                Student_t* students, uint32_t max, uint32_t* count)
+{
+    Protocol_Header_t reply;
+    F_Return_t status = Exchange(client, op, length, &reply);
+
+    *count = 0;
+    if (status != F_OK)
+        return status;
+
+    const uint8_t* payload = client->buffer + PROTOCOL_HEADER_SIZE;
+    if (reply.length < 4)
+        return Lost(client);
+    uint32_t found = Protocol_Get_U32(payload);
+    if (found > max || reply.length != 4 + found * PROTOCOL_STUDENT_SIZE)
+        return Lost(client);
+
+    for (uint32_t i = 0; i < found; i++)
+        Protocol_Get_Student(payload + 4 + i * PROTOCOL_STUDENT_SIZE, &students[i]);
+    *count = found;
+    return F_OK;
+}
+
+static uint32_t Page_Size(uint32_t max)
+{
+    return (max > PROTOCOL_MAX_RESULTS) ? PROTOCOL_MAX_RESULTS : max;
+}
+
+static uint32_t Batch_Size(uint32_t remaining)
+{
+    return (remaining > PROTOCOL_MAX_BATCH) ? PROTOCOL_MAX_BATCH : remaining;
+}
+
+/**
+ * @brief  Connects a client to a server.
+ *
+ * @param  client  Client to initialize.
+ * @param  address "unix:<path>" or "tcp:<port>".
+ * @return F_OK on success, F_CONNECTION_ERROR if no server answers.
+ */
+F_Return_t Client_Connect(Client_t* client, const char* address)
+{
+    if (!client || !address)
+        return F_NOT_OK;
+
+    my_memset(client, 0, sizeof(Client_t));
+    client->next_tag = 1;
+    if (Reserve(client, CLIENT_INITIAL_CAPACITY) != F_OK)
+        return F_NOT_OK;
+    if (Platform_Connect(address, &client->socket) != 0)
+        return Lost(client);
+    return F_OK;
+}
+
+/**
+ * @brief  Closes the connection and frees the client's buffer.
+ *
+ * @param  client Client to close, may already be closed.
+ */
+void Client_Close(Client_t* client)
+{
+    if (!client)
+        return;
+
+    Platform_Close_Socket(&client->socket);
+    free(client->buffer);
+    client->buffer = NULL;
+    client->capacity = 0;
+}
+
+/**
+ * @brief  Sends an empty request, to check or time a round trip.
+ *
+ * @param  client Connected client.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Client_Ping(Client_t* client)
+{
+    if (!client)
+        return F_NOT_OK;
+    return Exchange_Empty(client, PROTOCOL_OP_PING, 0);
+}
+
+/**
+ * @brief  Adds a student, as Add_Student_Manually.
+ *
+ * @details
+ * - The server rejects the values the file import rejects with
+ *   F_INVALID_FIELD.
+ *
+ * @param  client  Connected client.
+ * @param  student Student to add.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Client_Add(Client_t* client, const Student_t* student)
+{
+    if (!client || !student || !client->socket.open)
+        return F_NOT_OK;
+
+    Protocol_Put_Student(client->buffer + PROTOCOL_HEADER_SIZE, student);
+    return Exchange_Empty(client, PROTOCOL_OP_ADD, PROTOCOL_STUDENT_SIZE);
+}
+
+/**
+ * @brief  Adds many students, PROTOCOL_MAX_BATCH per request.
+ *
+ * @details
+ * - The server adds each batch under one exclusive lock and
+ *   syncs the database once per batch.
+ *
+ * @param  client   Connected client.
+ * @param  students Students to add.
+ * @param  count    Number of students.
+ * @param  results  Array of count statuses, as Client_Add returns.
+ * @return F_OK if every batch was answered, otherwise error code.
+ */
+F_Return_t Client_Add_Many(Client_t* client, const Student_t* students, uint32_t count, F_Return_t* results)
+{
+    Protocol_Header_t reply;
+
+    if (!client || !students || !results || !client->socket.open)
+        return F_NOT_OK;
+
+    for (uint32_t done = 0; done < count;)
+    {
+        uint32_t batch = Batch_Size(count - done);
+        if (Reserve(client, PROTOCOL_HEADER_SIZE + 4 + batch * PROTOCOL_STUDENT_SIZE) != F_OK)
+            return F_NOT_OK;
+
+        uint8_t* payload = client->buffer + PROTOCOL_HEADER_SIZE;
+        Protocol_Put_U32(payload, batch);
+        for (uint32_t i = 0; i < batch; i++)
+            Protocol_Put_Student(payload + 4 + i * PROTOCOL_STUDENT_SIZE, &students[done + i]);
+
+        F_Return_t status = Exchange(client, PROTOCOL_OP_ADD_MANY, 4 + batch * PROTOCOL_STUDENT_SIZE, &reply);
+        if (status != F_OK)
+            return status;
+
+        const uint8_t* entry = client->buffer + PROTOCOL_HEADER_SIZE;
+        if (reply.length != 4 + batch || Protocol_Get_U32(entry) != batch)
+            return Lost(client);
+        for (uint32_t i = 0; i < batch; i++)
+            results[done + i] = (F_Return_t)entry[4 + i];
+        done += batch;
+    }
+    return F_OK;
+}
+
+/**
+ * @brief  Finds a student by ID, as Find_Student_By_ID.
+ *
+ * @param  client  Connected client.
+ * @param  id      Student ID.
+ * @param  student Filled with the record if found.
+ * @return F_OK if found, otherwise error code.
+ */
+F_Return_t Client_Find_By_ID(Client_t* client, uint32_t id, Student_t* student)
+{
+    Protocol_Header_t reply;
+
+    if (!client || !student || !client->socket.open)
+        return F_NOT_OK;
+
+    Protocol_Put_U32(client->buffer + PROTOCOL_HEADER_SIZE, id);
+    F_Return_t status = Exchange(client, PROTOCOL_OP_FIND_ID, 4, &reply);
+    if (status != F_OK)
+        return status;
+    if (reply.length != PROTOCOL_STUDENT_SIZE)
+        return Lost(client);
+
+    Protocol_Get_Student(client->buffer + PROTOCOL_HEADER_SIZE, student);
+    return F_OK;
+}
+
+/**
+ * @brief  Looks up many students by ID, PROTOCOL_MAX_BATCH per request.
+ *
+ * @details
+ * - The server answers each request with one pass over its ID
+ *   index, so this costs a round trip per batch, not per ID.
+ *
+ * @param  client   Connected client.
+ * @param  ids      IDs to look up.
+ * @param  count    Number of IDs.
+ * @param  students Array of count students, filled where found.
+ * @param  results  Array of count statuses, F_OK or F_ID_NOT_FOUND.
+ * @return F_OK if every batch was answered, otherwise error code.
+ */
+F_Return_t Client_Find_By_IDs(Client_t* client, const uint32_t* ids, uint32_t count,
+                              Student_t* students, F_Return_t* results)
+{
+    Protocol_Header_t reply;
+
+    if (!client || !ids || !students || !results || !client->socket.open)
+        return F_NOT_OK;
+
+    for (uint32_t done = 0; done < count;)
+    {
+        uint32_t batch = Batch_Size(count - done);
+        if (Reserve(client, PROTOCOL_HEADER_SIZE + 4 + batch * 4) != F_OK)
+            return F_NOT_OK;
+
+        uint8_t* payload = client->buffer + PROTOCOL_HEADER_SIZE;
+        Protocol_Put_U32(payload, batch);
+        for (uint32_t i = 0; i < batch; i++)
+            Protocol_Put_U32(payload + 4 + i * 4, ids[done + i]);
+
+        F_Return_t status = Exchange(client, PROTOCOL_OP_FIND_IDS, 4 + batch * 4, &reply);
+        if (status != F_OK)
+            return status;
+
+        const uint8_t* entry = client->buffer + PROTOCOL_HEADER_SIZE + 4;
+        if (reply.length != 4 + batch * (1 + PROTOCOL_STUDENT_SIZE) || Protocol_Get_U32(entry - 4) != batch)
+            return Lost(client);
+        for (uint32_t i = 0; i < batch; i++, entry += 1 + PROTOCOL_STUDENT_SIZE)
+        {
+            results[done + i] = (F_Return_t)entry[0];
+            if (entry[0] == F_OK)
+                Protocol_Get_Student(entry + 1, &students[done + i]);
+        }
+        done += batch;
+    }
+    return F_OK;
+}
+
+/**
+ * @brief  Fetches a page of the students with a first name.
+ *
+ * @details
+ * - At most max students, and never more than
+ *   PROTOCOL_MAX_RESULTS; ask again from offset + count for
+ *   the next page.
+ *
+ * @param  client   Connected client.
+ * @param  fname    First name, exact match.
+ * @param  offset   Number of matches to skip.
+ * @param  students Array of max students to fill.
+ * @param  max      Capacity of students.
+ * @param  count    Set to the number of students filled.
+ * @return F_OK on success, F_FNAME_NOT_FOUND for an empty page, otherwise error code.
+ */
+F_Return_t Client_Find_By_First_Name(Client_t* client, const char* fname, uint32_t offset,
+                                     Student_t* students, uint32_t max, uint32_t* count)
+{
+    if (!client || !fname || !students || max == 0 || !count || !client->socket.open)
+        return F_NOT_OK;
+
+    uint32_t length = my_strlen(fname);
+    if (length == 0 || length >= MAX_NAME_LENGTH)
+        return F_INVALID_FIELD;
+
+    uint8_t* payload = client->buffer + PROTOCOL_HEADER_SIZE;
+    Protocol_Put_U32(payload, offset);
+    Protocol_Put_U32(payload + 4, Page_Size(max));
+    my_memcpy(payload + 8, fname, length);
+    return Exchange_List(client, PROTOCOL_OP_FIND_NAME, 8 + length, students, max, count);
+}
+
+/**
+ * @brief  Fetches a page of the students taking every course of
+ *         one mask and none of another.
+ *
+ * @param  client   Connected client.
+ * @param  all_of   Courses every student must take.
+ * @param  none_of  Courses no student may take.
+ * @param  offset   Number of matches to skip.
+ * @param  students Array of max students to fill.
+ * @param  max      Capacity of students.
+ * @param  count    Set to the number of students filled.
+ * @return F_OK on success, F_COURSE_NOT_FOUND for an empty page, otherwise error code.
+ */
+F_Return_t Client_Find_By_Courses(Client_t* client, Course_Mask_t all_of, Course_Mask_t none_of, uint32_t offset,
+                                  Student_t* students, uint32_t max, uint32_t* count)
+{
+    if (!client || !students || max == 0 || !count || !client->socket.open)
+        return F_NOT_OK;
+
+    uint8_t* payload = client->buffer + PROTOCOL_HEADER_SIZE;
+    Protocol_Put_U16(payload, all_of);
+    Protocol_Put_U16(payload + 2, none_of);
+    Protocol_Put_U32(payload + 4, offset);
+    Protocol_Put_U32(payload + 8, Page_Size(max));
+    return Exchange_List(client, PROTOCOL_OP_FIND_COURSES, 12, students, max, count);
+}
+
+/**
+ * @brief  Fetches a page of all active students in slot order.
+ *
+ * @param  client   Connected client.
+ * @param  offset   Number of students to skip.
+ * @param  students Array of max students to fill.
+ * @param  max      Capacity of students.
+ * @param  count    Set to the number of students filled.
+ * @return F_OK on success, F_FILE_IS_EMPTY for an empty page, otherwise error code.
+ */
+F_Return_t Client_List(Client_t* client, uint32_t offset, Student_t* students, uint32_t max, uint32_t* count)
+{
+    if (!client || !students || max == 0 || !count || !client->socket.open)
+        return F_NOT_OK;
+
+    uint8_t* payload = client->buffer + PROTOCOL_HEADER_SIZE;
+    Protocol_Put_U32(payload, offset);
+    Protocol_Put_U32(payload + 4, Page_Size(max));
+    return Exchange_List(client, PROTOCOL_OP_LIST, 8, students, max, count);
+}
+
+/**
+ * @brief  Updates fields of a student, as Update_Student.
+ *
+ * @param  client Connected client.
+ * @param  id     Student ID.
+ * @param  fields Update_Field_t bits of the fields to change.
+ * @param  values New values, only the fields in the mask are read.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Client_Update(Client_t* client, uint32_t id, Update_Mask_t fields, const Student_Update_t* values)
+{
+    Student_t student;
+
+    if (!client || !values || !client->socket.open)
+        return F_NOT_OK;
+
+    /* The new values travel as a student carrying the ID */
+    my_memset(&student, 0, sizeof(Student_t));
+    student.id = id;
+    my_memcpy(student.first_name, values->first_name, MAX_NAME_LENGTH);
+    my_memcpy(student.last_name, values->last_name, MAX_NAME_LENGTH);
+    student.GPA = values->GPA;
+    my_memcpy(student.courses, values->courses, MAX_COURSES);
+    student.course_count = values->course_count;
+
+    client->buffer[PROTOCOL_HEADER_SIZE] = fields;
+    Protocol_Put_Student(client->buffer + PROTOCOL_HEADER_SIZE + 1, &student);
+    return Exchange_Empty(client, PROTOCOL_OP_UPDATE, 1 + PROTOCOL_STUDENT_SIZE);
+}
+
+/**
+ * @brief  Deletes a student, as Delete_Student.
+ *
+ * @param  client Connected client.
+ * @param  id     Student ID.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Client_Delete(Client_t* client, uint32_t id)
+{
+    if (!client || !client->socket.open)
+        return F_NOT_OK;
+
+    Protocol_Put_U32(client->buffer + PROTOCOL_HEADER_SIZE, id);
+    return Exchange_Empty(client, PROTOCOL_OP_DELETE, 4);
+}
+
+/**
+ * @brief  Asks the server to stop once it has answered.
+ *
+ * @param  client Connected client.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Client_Shutdown(Client_t* client)
+{
+    if (!client)
+        return F_NOT_OK;
+    return Exchange_Empty(client, PROTOCOL_OP_SHUTDOWN, 0);
+}
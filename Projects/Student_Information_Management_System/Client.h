@@ -0,0 +1,182 @@
+#ifndef _Client_H_
+#define _Client_H_
+
+/* ============================================================
+ *  Database Client
+ *
+ *  Description:
+ *  Connection to a Server.h process. Every call sends one
+ *  request frame, one per batch for the multi-item calls, and
+ *  waits for its reply, and returns the status the server's
+ *  System API call returned.
+ *
+ *  A lost or unusable connection returns F_CONNECTION_ERROR
+ *  and closes the client; Client_Connect opens it again.
+ * ============================================================ */
+
+#include"System.h"
+#include"Platform_Socket.h"
+
+typedef struct
+{
+    Platform_Socket_t socket;
+    uint32_t next_tag;              /* Tag of the next request */
+    uint8_t* buffer;                /* Request, then reply frame */
+    uint32_t capacity;
+} Client_t;
+
+/**
+ * @brief  Connects a client to a server.
+ *
+ * @param  client  Client to initialize.
+ * @param  address "unix:<path>" or "tcp:<port>".
+ * @return F_OK on success, F_CONNECTION_ERROR if no server answers.
+ */
+F_Return_t Client_Connect(Client_t* client, const char* address);
+
+/**
+ * @brief  Closes the connection and frees the client's buffer.
+ *
+ * @param  client Client to close, may already be closed.
+ */
+void Client_Close(Client_t* client);
+
+/**
+ * @brief  Sends an empty request, to check or time a round trip.
+ *
+ * @param  client Connected client.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Client_Ping(Client_t* client);
+
+/**
+ * @brief  Adds a student, as Add_Student_Manually.
+ *
+ * @details
+ * - The server rejects the values the file import rejects with
+ *   F_INVALID_FIELD.
+ *
+ * @param  client  Connected client.
+ * @param  student Student to add.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Client_Add(Client_t* client, const Student_t* student);
+
+/**
+ * @brief  Adds many students, PROTOCOL_MAX_BATCH per request.
+ *
+ * @details
+ * - The server adds each batch under one exclusive lock and
+ *   syncs the database once per batch.
+ *
+ * @param  client   Connected client.
+ * @param  students Students to add.
+ * @param  count    Number of students.
+ * @param  results  Array of count statuses, as Client_Add returns.
+ * @return F_OK if every batch was answered, otherwise error code.
+ */
+F_Return_t Client_Add_Many(Client_t* client, const Student_t* students, uint32_t count, F_Return_t* results);
+
+/**
+ * @brief  Finds a student by ID, as Find_Student_By_ID.
+ *
+ * @param  client  Connected client.
+ * @param  id      Student ID.
+ * @param  student Filled with the record if found.
+ * @return F_OK if found, otherwise error code.
+ */
+F_Return_t Client_Find_By_ID(Client_t* client, uint32_t id, Student_t* student);
+
+/**
+ * @brief  Looks up many students by ID, PROTOCOL_MAX_BATCH per request.
+ *
+ * @details
+ * - The server answers each request with one pass over its ID
+ *   index, so this costs a round trip per batch, not per ID.
+ *
+ * @param  client   Connected client.
+ * @param  ids      IDs to look up.
+ * @param  count    Number of IDs.
+ * @param  students Array of count students, filled where found.
+ * @param  results  Array of count statuses, F_OK or F_ID_NOT_FOUND.
+ * @return F_OK if every batch was answered, otherwise error code.
+ */
+F_Return_t Client_Find_By_IDs(Client_t* client, const uint32_t* ids, uint32_t count,
+                              Student_t* students, F_Return_t* results);
+
+/**
+ * @brief  Fetches a page of the students with a first name.
+ *
+ * @details
+ * - At most max students, and never more than
+ *   PROTOCOL_MAX_RESULTS; ask again from offset + count for
+ *   the next page.
+ *
+ * @param  client   Connected client.
+ * @param  fname    First name, exact match.
+ * @param  offset   Number of matches to skip.
+ * @param  students Array of max students to fill.
+ * @param  max      Capacity of students.
+ * @param  count    Set to the number of students filled.
+ * @return F_OK on success, F_FNAME_NOT_FOUND for an empty page, otherwise error code.
+ */
+F_Return_t Client_Find_By_First_Name(Client_t* client, const char* fname, uint32_t offset,
+                                     Student_t* students, uint32_t max, uint32_t* count);
+
+/**
+ * @brief  Fetches a page of the students taking every course of
+ *         one mask and none of another.
+ *
+ * @param  client   Connected client.
+ * @param  all_of   Courses every student must take.
+ * @param  none_of  Courses no student may take.
+ * @param  offset   Number of matches to skip.
+ * @param  students Array of max students to fill.
+ * @param  max      Capacity of students.
+ * @param  count    Set to the number of students filled.
+ * @return F_OK on success, F_COURSE_NOT_FOUND for an empty page, otherwise error code.
+ */
+F_Return_t Client_Find_By_Courses(Client_t* client, Course_Mask_t all_of, Course_Mask_t none_of, uint32_t offset,
+                                  Student_t* students, uint32_t max, uint32_t* count);
+
+/**
+ * @brief  Fetches a page of all active students in slot order.
+ *
+ * @param  client   Connected client.
+ * @param  offset   Number of students to skip.
+ * @param  students Array of max students to fill.
+ * @param  max      Capacity of students.
+ * @param  count    Set to the number of students filled.
+ * @return F_OK on success, F_FILE_IS_EMPTY for an empty page, otherwise error code.
+ */
+F_Return_t Client_List(Client_t* client, uint32_t offset, Student_t* students, uint32_t max, uint32_t* count);
+
+/**
+ * @brief  Updates fields of a student, as Update_Student.
+ *
+ * @param  client Connected client.
+ * @param  id     Student ID.
+ * @param  fields Update_Field_t bits of the fields to change.
+ * @param  values New values, only the fields in the mask are read.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Client_Update(Client_t* client, uint32_t id, Update_Mask_t fields, const Student_Update_t* values);
+
+/**
+ * @brief  Deletes a student, as Delete_Student.
+ *
+ * @param  client Connected client.
+ * @param  id     Student ID.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Client_Delete(Client_t* client, uint32_t id);
+
+/**
+ * @brief  Asks the server to stop once it has answered.
+ *
+ * @param  client Connected client.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Client_Shutdown(Client_t* client);
+
+#endif // !_Client_H_
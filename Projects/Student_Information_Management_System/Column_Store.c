@@ -0,0 +1,376 @@
+#include "Column_Store.h"
+#include "Indexes.h"
+#include "Storage.h"
+#include "Platform.h"
+
+/* ============================================================
+ *                    On-Disk Layout
+ *
+ *  The header is followed by one segment per column. Every
+ *  segment holds capacity entries, so the offset of a slot in
+ *  any column is segment start + slot * column width.
+ * ============================================================ */
+typedef struct
+{
+    uint32_t magic;                 /* COLUMN_MAGIC */
+    uint32_t generation;            /* Database generation covered by the columns */
+    uint32_t record_count;          /* Slots filled from the database */
+    uint32_t capacity;              /* Slots reserved in every segment */
+    uint32_t is_clean;              /* 1 when closed after the last change */
+} Column_Header_t;
+
+typedef enum
+{
+    COLUMN_ID = 0,
+    COLUMN_GPA,
+    COLUMN_COURSES,
+    COLUMN_ACTIVE,
+    COLUMN_FIRST_NAME,
+    COLUMN_LAST_NAME,
+    COLUMN_COUNT
+} Column_t;
+
+/* Segments are ordered by decreasing alignment so every entry stays aligned */
+static const size_t Column_Width[COLUMN_COUNT] =
+{
+    sizeof(uint32_t),
+    sizeof(float),
+    sizeof(Course_Mask_t),
+    sizeof(uint8_t),
+    MAX_NAME_LENGTH,
+    MAX_NAME_LENGTH
+};
+
+static FILE* column_fp = NULL;
+static Column_Header_t column_header;
+static Platform_Map_t column_map = { 0 };
+static uint32_t mapped_capacity = 0;
+
+static size_t Segment_Offset(Column_t column, uint32_t capacity)
+{
+    size_t offset = COLUMN_HEADER_SIZE;
+    for (uint32_t i = 0; i < (uint32_t)column; i++)
+        offset += Column_Width[i] * capacity;
+    return offset;
+}
+
+static F_Return_t Write_Header(void)
+{
+    if (fseek(column_fp, 0, SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(&column_header, sizeof(Column_Header_t), 1, column_fp) != 1)
+        return F_FILE_WRITE_ERROR;
+    fflush(column_fp);
+    return F_OK;
+}
+
+static void Unmap_Columns(void)
+{
+    Platform_Unmap_File(&column_map);
+    mapped_capacity = 0;
+}
+
+/* Writes the value of one column for a run of consecutive slots */
+static F_Return_t Write_Column(Column_t column, uint32_t first_slot, const void* values, uint32_t count)
+{
+    long offset = (long)(Segment_Offset(column, column_header.capacity) + Column_Width[column] * first_slot);
+
+    if (fseek(column_fp, offset, SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(values, Column_Width[column], count, column_fp) != count)
+        return F_FILE_WRITE_ERROR;
+    return F_OK;
+}
+
+/* Splits a run of records into the column segments, one write per column */
+static F_Return_t Write_Records(uint32_t first_slot, const Student_t* students, uint32_t count, uint8_t* scratch)
+{
+    F_Return_t status = F_OK;
+
+    for (uint32_t column = 0; column < COLUMN_COUNT && status == F_OK; column++)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const Student_t* student = &students[i];
+            void* entry = scratch + i * Column_Width[column];
+
+            switch ((Column_t)column)
+            {
+            case COLUMN_ID:         *(uint32_t*)entry = student->id; break;
+            case COLUMN_GPA:        *(float*)entry = student->GPA; break;
+            case COLUMN_COURSES:    *(Course_Mask_t*)entry = Column_Course_Mask(student); break;
+            case COLUMN_ACTIVE:     *(uint8_t*)entry = student->is_active; break;
+            case COLUMN_FIRST_NAME: my_memcpy(entry, student->first_name, MAX_NAME_LENGTH); break;
+            case COLUMN_LAST_NAME:  my_memcpy(entry, student->last_name, MAX_NAME_LENGTH); break;
+            default: break;
+            }
+        }
+        status = Write_Column((Column_t)column, first_slot, scratch, count);
+    }
+    return status;
+}
+
+/**
+ * @brief  Recreates the column file with the given capacity.
+ *
+ * @details
+ * - Reads the database in batches and writes each batch into
+ *   all segments, so every segment is written sequentially.
+ */
+static F_Return_t Build_Columns(uint32_t capacity)
+{
+    uint32_t record_count = 0, got = 0;
+    F_Return_t status;
+
+    status = Storage_Record_Count(&record_count);
+    if (status != F_OK)
+        return status;
+
+    if (capacity < record_count)
+        capacity = record_count;
+    capacity = (capacity / COLUMN_CAPACITY_STEP + 1) * COLUMN_CAPACITY_STEP;
+
+    /* A mapped file cannot be truncated */
+    Unmap_Columns();
+    if (column_fp)
+        fclose(column_fp);
+    column_fp = fopen(COLUMN_FILE_NAME, "wb+");
+    if (!column_fp)
+        return F_FILE_OPEN_ERROR;
+
+    my_memset(&column_header, 0, sizeof(column_header));
+    column_header.magic = COLUMN_MAGIC;
+    column_header.capacity = capacity;
+
+    /* Reserve every segment up front, zero-filled */
+    if (Platform_Truncate_File(column_fp, (long)Segment_Offset(COLUMN_COUNT, capacity)) != 0)
+        return F_FILE_WRITE_ERROR;
+    status = Write_Header();
+
+    Student_t* batch = malloc(COLUMN_CAPACITY_STEP * sizeof(Student_t));
+    uint8_t* scratch = malloc(COLUMN_CAPACITY_STEP * MAX_NAME_LENGTH);
+    if (!batch || !scratch)
+        status = F_NOT_OK;
+
+    for (uint32_t slot = 0; status == F_OK && slot < record_count; slot += got)
+    {
+        status = Storage_Read_Batch(slot, COLUMN_CAPACITY_STEP, batch, &got);
+        if (status == F_OK && got == 0)
+            break;
+        if (status == F_OK)
+            status = Write_Records(slot, batch, got, scratch);
+    }
+
+    free(batch);
+    free(scratch);
+    if (status != F_OK)
+        return status;
+
+    column_header.record_count = record_count;
+    Storage_Get_Generation(&column_header.generation);
+    column_header.is_clean = 1;
+    return Write_Header();
+}
+
+/**
+ * @brief  Builds the course bitmap of a record.
+ *
+ * @param  student Record to read the course list from.
+ * @return Mask with one bit set per enrolled course ID.
+ */
+Course_Mask_t Column_Course_Mask(const Student_t* student)
+{
+    Course_Mask_t mask = 0;
+
+    for (uint32_t i = 0; i < student->course_count && i < MAX_COURSES; i++)
+    {
+        if (student->courses[i] <= MAX_COURSE_ID)
+            mask |= (Course_Mask_t)(1u << student->courses[i]);
+    }
+    return mask;
+}
+
+/**
+ * @brief  Rebuilds every column from the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t Column_Store_Rebuild(void)
+{
+    F_Return_t status;
+
+    if (!COLUMN_STORE_ENABLED)
+        return F_OK;
+
+    /* Other processes still hold the old file open */
+    status = Build_Columns(0);
+    if (status == F_OK)
+        status = Storage_Touch();
+    return status;
+}
+
+/**
+ * @brief  Opens the column file, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the columns from the database file when the column
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the columns are ready, otherwise error code.
+ */
+F_Return_t Column_Store_Open(void)
+{
+    uint32_t record_count = 0;
+    uint32_t generation = 0;
+
+    if (!COLUMN_STORE_ENABLED || column_fp)
+        return F_OK;
+
+    if (Storage_Record_Count(&record_count) != F_OK ||
+        Storage_Get_Generation(&generation) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    column_fp = fopen(COLUMN_FILE_NAME, "rb+");
+    if (column_fp)
+    {
+        if (fread(&column_header, sizeof(Column_Header_t), 1, column_fp) == 1 &&
+            column_header.magic == COLUMN_MAGIC &&
+            column_header.is_clean &&
+            column_header.record_count == record_count &&
+            column_header.generation == generation)
+        {
+            return F_OK;
+        }
+        printf("Student column store is stale, rebuilding...\n");
+    }
+
+    return Column_Store_Rebuild();
+}
+
+/**
+ * @brief  Stamps the column file as clean and closes it.
+ */
+void Column_Store_Close(void)
+{
+    if (!column_fp)
+        return;
+
+    Unmap_Columns();
+    Column_Store_Flush();
+    fclose(column_fp);
+    column_fp = NULL;
+}
+
+/**
+ * @brief  Stamps the column file clean without closing it.
+ *
+ * @details
+ * - Lets other processes map the columns as they stand instead
+ *   of rebuilding them; the next change marks them dirty again.
+ * - Does nothing if the column file is not open.
+ */
+void Column_Store_Flush(void)
+{
+    if (!column_fp)
+        return;
+
+    if (Storage_Record_Count(&column_header.record_count) == F_OK &&
+        Storage_Get_Generation(&column_header.generation) == F_OK)
+    {
+        column_header.is_clean = 1;
+        Write_Header();
+    }
+}
+
+/**
+ * @brief  Unmaps and closes the column file without writing to it.
+ */
+void Column_Store_Discard(void)
+{
+    if (!column_fp)
+        return;
+
+    Unmap_Columns();
+    fclose(column_fp);
+    column_fp = NULL;
+}
+
+/**
+ * @brief  Copies one record into the columns of its slot.
+ *
+ * @details
+ * - Must be called after every write of a database slot.
+ * - Grows the segments when the slot is beyond their capacity.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record now stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Column_Store_Set(uint32_t slot, const Student_t* student)
+{
+    uint8_t scratch[MAX_NAME_LENGTH];
+    F_Return_t status;
+
+    if (!student)
+        return F_NOT_OK;
+    if (!COLUMN_STORE_ENABLED)
+        return F_OK;
+
+    status = Column_Store_Open();
+    if (status != F_OK)
+        return status;
+
+    /* The record is already in the database, a rebuild picks it up */
+    if (slot >= column_header.capacity)
+        return Build_Columns(2 * column_header.capacity);
+
+    status = Indexes_Mark_Dirty(column_fp, COLUMN_FILE_NAME, &column_header, sizeof(Column_Header_t), &column_header.is_clean);
+    if (status != F_OK)
+        return status;
+
+    status = Write_Records(slot, student, 1, scratch);
+    if (status == F_OK && slot >= column_header.record_count)
+        column_header.record_count = slot + 1;
+    return status;
+}
+
+/**
+ * @brief  Maps the column segments for scanning.
+ *
+ * @param  view Pointer to store the column arrays.
+ * @return F_OK on success, F_NOT_OK if the column store is disabled
+ *         or cannot be mapped; callers then scan the row file.
+ */
+F_Return_t Column_Store_Map(Column_View_t* view)
+{
+    uint32_t record_count = 0;
+
+    if (!view || !COLUMN_STORE_ENABLED)
+        return F_NOT_OK;
+    if (Column_Store_Open() != F_OK || Storage_Record_Count(&record_count) != F_OK)
+        return F_NOT_OK;
+
+    /* Pending column writes must reach the file before it is read through the map */
+    fflush(column_fp);
+
+    if (!column_map.data || mapped_capacity != column_header.capacity)
+    {
+        Unmap_Columns();
+        if (Platform_Map_File(COLUMN_FILE_NAME, Segment_Offset(COLUMN_COUNT, column_header.capacity), &column_map) != 0)
+            return F_NOT_OK;
+        mapped_capacity = column_header.capacity;
+    }
+
+    const uint8_t* base = column_map.data;
+    view->ids = (const uint32_t*)(base + Segment_Offset(COLUMN_ID, mapped_capacity));
+    view->gpa = (const float*)(base + Segment_Offset(COLUMN_GPA, mapped_capacity));
+    view->courses = (const Course_Mask_t*)(base + Segment_Offset(COLUMN_COURSES, mapped_capacity));
+    view->is_active = base + Segment_Offset(COLUMN_ACTIVE, mapped_capacity);
+    view->first_names = (const char(*)[MAX_NAME_LENGTH])(base + Segment_Offset(COLUMN_FIRST_NAME, mapped_capacity));
+    view->last_names = (const char(*)[MAX_NAME_LENGTH])(base + Segment_Offset(COLUMN_LAST_NAME, mapped_capacity));
+
+    /* Compaction shrinks the database without shrinking the columns */
+    view->count = (column_header.record_count < record_count) ? column_header.record_count : record_count;
+    return F_OK;
+}
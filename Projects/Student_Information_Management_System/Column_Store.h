@@ -0,0 +1,116 @@
+#ifndef _Column_Store_H_
+#define _Column_Store_H_
+
+/* ============================================================
+ *  Columnar Student Store
+ *
+ *  Description:
+ *  Struct-of-arrays copy of the student database kept in its
+ *  own file. Every field lives in a separate segment (ids, GPA,
+ *  course bitmap, active flag, names) indexed by record slot,
+ *  so scans that filter on one field only touch that column
+ *  instead of dragging whole Student_t records through memory.
+ *  The row file stays the source of truth; the column file is
+ *  rebuilt from it whenever it is missing or stale.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define COLUMN_STORE_ENABLED       1                           /* 0: queries scan the row file */
+#define COLUMN_FILE_NAME           "Students_Information.col"
+#define COLUMN_MAGIC               0x4C4F4353UL                /* "SCOL" */
+#define COLUMN_HEADER_SIZE         64                          /* Bytes reserved for the header */
+#define COLUMN_CAPACITY_STEP       4096                        /* Slots added when a segment grows */
+
+/**
+ * @brief  Read-only view of the mapped column segments.
+ *
+ * @details
+ * - Entry i of every array belongs to record slot i.
+ * - Valid until the next Column_Store call that grows the file,
+ *   Column_Store_Rebuild or Column_Store_Close.
+ */
+typedef struct
+{
+    const uint32_t* ids;
+    const float* gpa;
+    const Course_Mask_t* courses;
+    const uint8_t* is_active;
+    const char (*first_names)[MAX_NAME_LENGTH];
+    const char (*last_names)[MAX_NAME_LENGTH];
+    uint32_t count;                 /* Slots covered by the view */
+} Column_View_t;
+
+/**
+ * @brief  Opens the column file, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the columns from the database file when the column
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the columns are ready, otherwise error code.
+ */
+F_Return_t Column_Store_Open(void);
+
+/**
+ * @brief  Stamps the column file as clean and closes it.
+ */
+void Column_Store_Close(void);
+
+/**
+ * @brief  Stamps the column file clean without closing it.
+ *
+ * @details
+ * - Lets other processes map the columns as they stand instead
+ *   of rebuilding them; the next change marks them dirty again.
+ * - Does nothing if the column file is not open.
+ */
+void Column_Store_Flush(void);
+
+/**
+ * @brief  Unmaps and closes the column file without writing to it.
+ */
+void Column_Store_Discard(void);
+
+/**
+ * @brief  Rebuilds every column from the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t Column_Store_Rebuild(void);
+
+/**
+ * @brief  Copies one record into the columns of its slot.
+ *
+ * @details
+ * - Must be called after every write of a database slot.
+ * - Grows the segments when the slot is beyond their capacity.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record now stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Column_Store_Set(uint32_t slot, const Student_t* student);
+
+/**
+ * @brief  Maps the column segments for scanning.
+ *
+ * @param  view Pointer to store the column arrays.
+ * @return F_OK on success, F_NOT_OK if the column store is disabled
+ *         or cannot be mapped; callers then scan the row file.
+ */
+F_Return_t Column_Store_Map(Column_View_t* view);
+
+/**
+ * @brief  Builds the course bitmap of a record.
+ *
+ * @param  student Record to read the course list from.
+ * @return Mask with one bit set per enrolled course ID.
+ */
+Course_Mask_t Column_Course_Mask(const Student_t* student);
+
+#endif // !_Column_Store_H_
@@ -0,0 +1,666 @@
+#include "Course_Index.h"
+#include "Indexes.h"
+#include "Column_Store.h"
+#include "Storage.h"
+#include <string.h>
+
+/* ============================================================
+ *                    In-Memory Layout
+ *
+ *  A bitmap is a sorted list of containers. Container key k
+ *  covers slots k * 65536 .. k * 65536 + 65535 and keeps the
+ *  low 16 bits of each slot either in a sorted array (up to
+ *  COURSE_ARRAY_MAX entries) or in a bitmap of 65536 bits.
+ *
+ *  On disk the header is followed, for every bitmap, by its
+ *  container count and then key, cardinality, type (array or
+ *  bitmap) and payload of each container.
+ * ============================================================ */
+typedef struct
+{
+    uint32_t magic;                 /* COURSE_INDEX_MAGIC */
+    uint32_t generation;            /* Database generation covered by the index */
+    uint32_t is_clean;              /* 1 when saved after the last change */
+} Course_Index_Header_t;
+
+typedef struct
+{
+    uint32_t key;                   /* Slot >> 16 */
+    uint32_t cardinality;           /* Slots present in the container */
+    uint32_t capacity;              /* Entries allocated in array */
+    uint16_t* array;                /* Sorted low halves, NULL for bitmaps */
+    uint64_t* words;                /* COURSE_BITMAP_WORDS words, NULL for arrays */
+} Container_t;
+
+typedef struct
+{
+    Container_t* containers;        /* Sorted by key */
+    uint32_t count;
+    uint32_t capacity;
+} Bitmap_t;
+
+/* bitmaps[0] holds every active slot, bitmaps[n] the slots taking course n */
+static Bitmap_t bitmaps[MAX_COURSE_ID + 1];
+static Course_Index_Header_t index_header;
+static bool index_loaded = false;
+
+/* Position of the lowest set bit through a de Bruijn sequence */
+static const uint8_t Lowest_Bit_Table[64] =
+{
+    0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+    62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+    63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+    46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+};
+
+static uint32_t Lowest_Bit(uint64_t word)
+{
+    return Lowest_Bit_Table[((word & (0 - word)) * 0x03F79D71B4CB0A89ULL) >> 58];
+}
+
+static void Container_Free(Container_t* container)
+{
+    free(container->array);
+    free(container->words);
+    my_memset(container, 0, sizeof(Container_t));
+}
+
+static void Bitmap_Clear(Bitmap_t* bitmap)
+{
+    for (uint32_t i = 0; i < bitmap->count; i++)
+        Container_Free(&bitmap->containers[i]);
+    free(bitmap->containers);
+    my_memset(bitmap, 0, sizeof(Bitmap_t));
+}
+
+/* Binary search for a container key; pos receives the insertion point */
+static Container_t* Find_Container(const Bitmap_t* bitmap, uint32_t key, uint32_t* pos)
+{
+    uint32_t low = 0, high = bitmap->count;
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+        if (bitmap->containers[mid].key < key)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (pos)
+        *pos = low;
+    return (low < bitmap->count && bitmap->containers[low].key == key) ? &bitmap->containers[low] : NULL;
+}
+
+/* Index of the first array entry greater than or equal to value */
+static uint32_t Array_Lower_Bound(const Container_t* container, uint16_t value)
+{
+    uint32_t low = 0, high = container->cardinality;
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+        if (container->array[mid] < value)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+/* Expands any container into a plain bitmap */
+static void Container_Words(const Container_t* container, uint64_t* words)
+{
+    if (container->words)
+    {
+        memcpy(words, container->words, COURSE_BITMAP_WORDS * sizeof(uint64_t));
+        return;
+    }
+
+    my_memset(words, 0, COURSE_BITMAP_WORDS * sizeof(uint64_t));
+    for (uint32_t i = 0; i < container->cardinality; i++)
+        words[container->array[i] >> 6] |= 1ULL << (container->array[i] & 63);
+}
+
+static F_Return_t Array_To_Bitmap(Container_t* container)
+{
+    uint64_t* words = malloc(COURSE_BITMAP_WORDS * sizeof(uint64_t));
+    if (!words)
+        return F_NOT_OK;
+
+    Container_Words(container, words);
+    free(container->array);
+    container->array = NULL;
+    container->capacity = 0;
+    container->words = words;
+    return F_OK;
+}
+
+static F_Return_t Bitmap_To_Array(Container_t* container)
+{
+    uint16_t* array = malloc(COURSE_ARRAY_MAX * sizeof(uint16_t));
+    uint32_t count = 0;
+    if (!array)
+        return F_NOT_OK;
+
+    for (uint32_t w = 0; w < COURSE_BITMAP_WORDS; w++)
+    {
+        for (uint64_t word = container->words[w]; word; word &= word - 1)
+            array[count++] = (uint16_t)(w * 64 + Lowest_Bit(word));
+    }
+    free(container->words);
+    container->words = NULL;
+    container->array = array;
+    container->capacity = COURSE_ARRAY_MAX;
+    return F_OK;
+}
+
+static F_Return_t Bitmap_Add(Bitmap_t* bitmap, uint32_t slot)
+{
+    uint32_t key = slot >> 16;
+    uint16_t value = (uint16_t)(slot & 0xFFFF);
+    uint32_t pos;
+
+    Container_t* container = Find_Container(bitmap, key, &pos);
+    if (!container)
+    {
+        if (bitmap->count == bitmap->capacity)
+        {
+            uint32_t capacity = (bitmap->capacity) ? 2 * bitmap->capacity : 4;
+            Container_t* grown = realloc(bitmap->containers, capacity * sizeof(Container_t));
+            if (!grown)
+                return F_NOT_OK;
+            bitmap->containers = grown;
+            bitmap->capacity = capacity;
+        }
+        memmove(&bitmap->containers[pos + 1], &bitmap->containers[pos], (bitmap->count - pos) * sizeof(Container_t));
+        bitmap->count++;
+        container = &bitmap->containers[pos];
+        my_memset(container, 0, sizeof(Container_t));
+        container->key = key;
+    }
+
+    if (container->words)
+    {
+        uint64_t bit = 1ULL << (value & 63);
+        if (!(container->words[value >> 6] & bit))
+        {
+            container->words[value >> 6] |= bit;
+            container->cardinality++;
+        }
+        return F_OK;
+    }
+
+    uint32_t index = Array_Lower_Bound(container, value);
+    if (index < container->cardinality && container->array[index] == value)
+        return F_OK;
+
+    /* A full array becomes a bitmap */
+    if (container->cardinality == COURSE_ARRAY_MAX)
+    {
+        if (Array_To_Bitmap(container) != F_OK)
+            return F_NOT_OK;
+        return Bitmap_Add(bitmap, slot);
+    }
+
+    if (container->cardinality == container->capacity)
+    {
+        uint32_t capacity = (container->capacity) ? 2 * container->capacity : 8;
+        uint16_t* grown = realloc(container->array, capacity * sizeof(uint16_t));
+        if (!grown)
+            return F_NOT_OK;
+        container->array = grown;
+        container->capacity = capacity;
+    }
+    memmove(&container->array[index + 1], &container->array[index], (container->cardinality - index) * sizeof(uint16_t));
+    container->array[index] = value;
+    container->cardinality++;
+    return F_OK;
+}
+
+static void Bitmap_Remove(Bitmap_t* bitmap, uint32_t slot)
+{
+    uint16_t value = (uint16_t)(slot & 0xFFFF);
+    uint32_t pos;
+
+    Container_t* container = Find_Container(bitmap, slot >> 16, &pos);
+    if (!container)
+        return;
+
+    if (container->words)
+    {
+        uint64_t bit = 1ULL << (value & 63);
+        if (!(container->words[value >> 6] & bit))
+            return;
+        container->words[value >> 6] &= ~bit;
+        container->cardinality--;
+
+        /* Convert back well below the limit so a slot toggling at the edge doesn't thrash */
+        if (container->cardinality <= COURSE_ARRAY_MAX / 2)
+            Bitmap_To_Array(container);
+    }
+    else
+    {
+        uint32_t index = Array_Lower_Bound(container, value);
+        if (index >= container->cardinality || container->array[index] != value)
+            return;
+        memmove(&container->array[index], &container->array[index + 1], (container->cardinality - index - 1) * sizeof(uint16_t));
+        container->cardinality--;
+    }
+
+    if (container->cardinality == 0)
+    {
+        Container_Free(container);
+        memmove(&bitmap->containers[pos], &bitmap->containers[pos + 1], (bitmap->count - pos - 1) * sizeof(Container_t));
+        bitmap->count--;
+    }
+}
+
+static void Clear_All(void)
+{
+    for (uint32_t c = 0; c <= MAX_COURSE_ID; c++)
+        Bitmap_Clear(&bitmaps[c]);
+}
+
+static F_Return_t Write_Header(FILE* fp)
+{
+    if (fseek(fp, 0, SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(&index_header, sizeof(Course_Index_Header_t), 1, fp) != 1)
+        return F_FILE_WRITE_ERROR;
+    return F_OK;
+}
+
+/* Writes all bitmaps and stamps the file clean for the current generation */
+static F_Return_t Save_Index(void)
+{
+    F_Return_t status = F_OK;
+
+    FILE* fp = fopen(COURSE_INDEX_FILE_NAME, "wb");
+    if (!fp)
+        return F_FILE_OPEN_ERROR;
+
+    index_header.magic = COURSE_INDEX_MAGIC;
+    index_header.is_clean = 0;
+    Storage_Get_Generation(&index_header.generation);
+    status = Write_Header(fp);
+
+    for (uint32_t c = 0; c <= MAX_COURSE_ID && status == F_OK; c++)
+    {
+        const Bitmap_t* bitmap = &bitmaps[c];
+        if (fwrite(&bitmap->count, sizeof(uint32_t), 1, fp) != 1)
+            status = F_FILE_WRITE_ERROR;
+
+        for (uint32_t i = 0; i < bitmap->count && status == F_OK; i++)
+        {
+            const Container_t* container = &bitmap->containers[i];
+            uint32_t is_bitmap = (container->words != NULL);
+            bool written;
+
+            written = fwrite(&container->key, sizeof(uint32_t), 1, fp) == 1 &&
+                      fwrite(&container->cardinality, sizeof(uint32_t), 1, fp) == 1 &&
+                      fwrite(&is_bitmap, sizeof(uint32_t), 1, fp) == 1;
+            if (written && is_bitmap)
+                written = fwrite(container->words, sizeof(uint64_t), COURSE_BITMAP_WORDS, fp) == COURSE_BITMAP_WORDS;
+            else if (written)
+                written = fwrite(container->array, sizeof(uint16_t), container->cardinality, fp) == container->cardinality;
+            if (!written)
+                status = F_FILE_WRITE_ERROR;
+        }
+    }
+
+    if (status == F_OK)
+    {
+        index_header.is_clean = 1;
+        status = Write_Header(fp);
+    }
+    fclose(fp);
+    return status;
+}
+
+/* Reads one container payload written by Save_Index */
+static F_Return_t Load_Container(FILE* fp, Container_t* container)
+{
+    uint32_t is_bitmap;
+
+    if (fread(&container->key, sizeof(uint32_t), 1, fp) != 1 ||
+        fread(&container->cardinality, sizeof(uint32_t), 1, fp) != 1 ||
+        fread(&is_bitmap, sizeof(uint32_t), 1, fp) != 1)
+        return F_FILE_READ_ERROR;
+    if (container->cardinality == 0 || container->cardinality > (is_bitmap ? 65536 : COURSE_ARRAY_MAX))
+        return F_FILE_READ_ERROR;
+
+    if (is_bitmap)
+    {
+        container->words = malloc(COURSE_BITMAP_WORDS * sizeof(uint64_t));
+        if (!container->words)
+            return F_NOT_OK;
+        if (fread(container->words, sizeof(uint64_t), COURSE_BITMAP_WORDS, fp) != COURSE_BITMAP_WORDS)
+            return F_FILE_READ_ERROR;
+    }
+    else
+    {
+        container->capacity = container->cardinality;
+        container->array = malloc(container->capacity * sizeof(uint16_t));
+        if (!container->array)
+            return F_NOT_OK;
+        if (fread(container->array, sizeof(uint16_t), container->cardinality, fp) != container->cardinality)
+            return F_FILE_READ_ERROR;
+    }
+    return F_OK;
+}
+
+/* Reads the bitmaps of a clean index file written for the current generation */
+static F_Return_t Load_Index(void)
+{
+    Course_Index_Header_t stored;
+    uint32_t generation = 0;
+    F_Return_t status = F_OK;
+
+    if (Storage_Get_Generation(&generation) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    FILE* fp = fopen(COURSE_INDEX_FILE_NAME, "rb");
+    if (!fp)
+        return F_FILE_OPEN_ERROR;
+
+    if (fread(&stored, sizeof(stored), 1, fp) != 1 || stored.magic != COURSE_INDEX_MAGIC ||
+        !stored.is_clean || stored.generation != generation)
+    {
+        fclose(fp);
+        return F_FILE_READ_ERROR;
+    }
+
+    for (uint32_t c = 0; c <= MAX_COURSE_ID && status == F_OK; c++)
+    {
+        Bitmap_t* bitmap = &bitmaps[c];
+        uint32_t count;
+
+        if (fread(&count, sizeof(uint32_t), 1, fp) != 1)
+        {
+            status = F_FILE_READ_ERROR;
+            break;
+        }
+        bitmap->capacity = (count) ? count : 4;
+        bitmap->containers = calloc(bitmap->capacity, sizeof(Container_t));
+        if (!bitmap->containers)
+        {
+            status = F_NOT_OK;
+            break;
+        }
+
+        for (uint32_t i = 0; i < count && status == F_OK; i++)
+        {
+            bitmap->count++;
+            status = Load_Container(fp, &bitmap->containers[i]);
+        }
+    }
+
+    fclose(fp);
+    if (status != F_OK)
+    {
+        Clear_All();
+        return status;
+    }
+
+    index_header = stored;
+    return F_OK;
+}
+
+/**
+ * @brief  Rebuilds every course bitmap from the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t Course_Index_Rebuild(void)
+{
+    Student_t buffer[256];
+    uint32_t record_count = 0, got = 0;
+    F_Return_t status;
+
+    Clear_All();
+    index_loaded = true;
+
+    status = Storage_Record_Count(&record_count);
+    for (uint32_t slot = 0; status == F_OK && slot < record_count; slot += got)
+    {
+        status = Storage_Read_Batch(slot, 256, buffer, &got);
+        if (status != F_OK || got == 0)
+            break;
+
+        /* Slots arrive in increasing order, so every add appends */
+        for (uint32_t i = 0; i < got && status == F_OK; i++)
+        {
+            if (!buffer[i].is_active)
+                continue;
+
+            Course_Mask_t mask = Column_Course_Mask(&buffer[i]) | 1;
+            for (uint32_t c = 0; c <= MAX_COURSE_ID && status == F_OK; c++)
+            {
+                if (mask & (1u << c))
+                    status = Bitmap_Add(&bitmaps[c], slot + i);
+            }
+        }
+    }
+
+    if (status != F_OK)
+        return status;
+    return Save_Index();
+}
+
+/**
+ * @brief  Loads the course index, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the bitmaps from the database file when the index
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the index is ready, otherwise error code.
+ */
+F_Return_t Course_Index_Open(void)
+{
+    if (index_loaded)
+        return F_OK;
+
+    if (Load_Index() == F_OK)
+    {
+        index_loaded = true;
+        return F_OK;
+    }
+
+    FILE* fp = fopen(COURSE_INDEX_FILE_NAME, "rb");
+    if (fp)
+    {
+        fclose(fp);
+        printf("Course index is stale, rebuilding...\n");
+    }
+    return Course_Index_Rebuild();
+}
+
+/**
+ * @brief  Saves the bitmaps, stamps the index clean and frees it.
+ */
+void Course_Index_Close(void)
+{
+    if (!index_loaded)
+        return;
+
+    /* A clean index on disk already matches memory, it only needs the current generation */
+    if (index_header.is_clean)
+        Course_Index_Flush();
+    else
+        Save_Index();
+
+    Clear_All();
+    index_loaded = false;
+}
+
+/**
+ * @brief  Stamps an unchanged course index file with the current generation.
+ *
+ * @details
+ * - Lets other processes load the bitmaps after a change that
+ *   left every course list alone, instead of rebuilding them.
+ * - Does nothing if the bitmaps are not loaded or changed since
+ *   they were saved; Course_Index_Close saves them then.
+ */
+void Course_Index_Flush(void)
+{
+    if (index_loaded && index_header.is_clean)
+        Indexes_Stamp_Generation(COURSE_INDEX_FILE_NAME, &index_header, sizeof(Course_Index_Header_t), &index_header.generation);
+}
+
+/**
+ * @brief  Frees the bitmaps without saving them.
+ */
+void Course_Index_Discard(void)
+{
+    if (!index_loaded)
+        return;
+
+    Clear_All();
+    index_loaded = false;
+}
+
+/**
+ * @brief  Updates the bitmaps for the record now stored in a slot.
+ *
+ * @details
+ * - Active records are added to the bitmap of every course they
+ *   take and removed from the others.
+ * - Deleted records are removed from all bitmaps.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record now stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Course_Index_Set(uint32_t slot, const Student_t* student)
+{
+    F_Return_t status;
+
+    if (!student)
+        return F_NOT_OK;
+
+    status = Course_Index_Open();
+    if (status == F_OK)
+        status = Indexes_Mark_Dirty(NULL, COURSE_INDEX_FILE_NAME, &index_header, sizeof(Course_Index_Header_t), &index_header.is_clean);
+    if (status != F_OK)
+        return status;
+
+    /* Bit 0 is the active bitmap; course ID 0 is never a real course */
+    Course_Mask_t mask = (student->is_active) ? (Course_Mask_t)(Column_Course_Mask(student) | 1) : 0;
+
+    for (uint32_t c = 0; c <= MAX_COURSE_ID && status == F_OK; c++)
+    {
+        if (mask & (1u << c))
+            status = Bitmap_Add(&bitmaps[c], slot);
+        else
+            Bitmap_Remove(&bitmaps[c], slot);
+    }
+    return status;
+}
+
+/**
+ * @brief  Removes a slot from all bitmaps.
+ *
+ * @param  slot Record slot number.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Course_Index_Remove(uint32_t slot)
+{
+    F_Return_t status = Course_Index_Open();
+    if (status == F_OK)
+        status = Indexes_Mark_Dirty(NULL, COURSE_INDEX_FILE_NAME, &index_header, sizeof(Course_Index_Header_t), &index_header.is_clean);
+    if (status != F_OK)
+        return status;
+
+    for (uint32_t c = 0; c <= MAX_COURSE_ID; c++)
+        Bitmap_Remove(&bitmaps[c], slot);
+    return F_OK;
+}
+
+/**
+ * @brief  Visits the active students matching a course combination.
+ *
+ * @details
+ * - Matches students taking every course in all_of and none of
+ *   the courses in none_of.
+ * - Slots are visited in increasing order.
+ *
+ * @param  all_of  Courses the student must take.
+ * @param  none_of Courses the student must not take.
+ * @param  visit   Callback for every matching slot.
+ * @param  context Pointer forwarded to the callback.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Course_Index_Query(Course_Mask_t all_of, Course_Mask_t none_of, Course_Index_Visit_t visit, void* context)
+{
+    uint64_t* words;
+    uint64_t* other;
+    F_Return_t status;
+
+    if (!visit)
+        return F_NOT_OK;
+
+    status = Course_Index_Open();
+    if (status != F_OK)
+        return status;
+
+    words = malloc(2 * COURSE_BITMAP_WORDS * sizeof(uint64_t));
+    if (!words)
+        return F_NOT_OK;
+    other = words + COURSE_BITMAP_WORDS;
+
+    /* Start from the active slots of each container and narrow down */
+    const Bitmap_t* active = &bitmaps[0];
+    for (uint32_t i = 0; i < active->count; i++)
+    {
+        uint32_t key = active->containers[i].key;
+        bool empty = false;
+
+        Container_Words(&active->containers[i], words);
+
+        for (uint32_t c = 1; c <= MAX_COURSE_ID && !empty; c++)
+        {
+            Course_Mask_t bit = (Course_Mask_t)(1u << c);
+            if (!((all_of | none_of) & bit))
+                continue;
+
+            const Container_t* container = Find_Container(&bitmaps[c], key, NULL);
+            if (!container)
+            {
+                /* Nobody in this range takes course c */
+                empty = (all_of & bit) != 0;
+                continue;
+            }
+
+            const uint64_t* mask = container->words;
+            if (!mask)
+            {
+                Container_Words(container, other);
+                mask = other;
+            }
+
+            if (all_of & bit)
+            {
+                for (uint32_t w = 0; w < COURSE_BITMAP_WORDS; w++)
+                    words[w] &= mask[w];
+            }
+            else
+            {
+                for (uint32_t w = 0; w < COURSE_BITMAP_WORDS; w++)
+                    words[w] &= ~mask[w];
+            }
+        }
+        if (empty)
+            continue;
+
+        for (uint32_t w = 0; w < COURSE_BITMAP_WORDS; w++)
+        {
+            for (uint64_t word = words[w]; word; word &= word - 1)
+                visit((key << 16) | (w * 64 + Lowest_Bit(word)), context);
+        }
+    }
+
+    free(words);
+    return F_OK;
+}
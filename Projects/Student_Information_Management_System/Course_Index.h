@@ -0,0 +1,112 @@
+#ifndef _Course_Index_H_
+#define _Course_Index_H_
+
+/* ============================================================
+ *  Course Membership Bitmap Index
+ *
+ *  Description:
+ *  One compressed bitmap of record slots per course ID, plus
+ *  one bitmap of all active slots. Bitmaps are split into
+ *  containers of 65536 slots that are stored either as a
+ *  sorted array (sparse) or as a plain bitmap (dense), so
+ *  course combinations are answered with word-wide AND and
+ *  AND-NOT operations instead of scanning the records.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define COURSE_INDEX_FILE_NAME     "Students_Information.cix"
+#define COURSE_INDEX_MAGIC         0x58494353UL    /* "SCIX" */
+#define COURSE_ARRAY_MAX           4096            /* Largest array container */
+#define COURSE_BITMAP_WORDS        1024            /* 64-bit words per bitmap container */
+
+/**
+ * @brief  Called by Course_Index_Query for every matching slot.
+ *
+ * @param  slot    Record slot of a matching student.
+ * @param  context Pointer passed to Course_Index_Query.
+ */
+typedef void (*Course_Index_Visit_t)(uint32_t slot, void* context);
+
+/**
+ * @brief  Loads the course index, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the bitmaps from the database file when the index
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the index is ready, otherwise error code.
+ */
+F_Return_t Course_Index_Open(void);
+
+/**
+ * @brief  Saves the bitmaps, stamps the index clean and frees it.
+ */
+void Course_Index_Close(void);
+
+/**
+ * @brief  Stamps an unchanged course index file with the current generation.
+ *
+ * @details
+ * - Lets other processes load the bitmaps after a change that
+ *   left every course list alone, instead of rebuilding them.
+ * - Does nothing if the bitmaps are not loaded or changed since
+ *   they were saved; Course_Index_Close saves them then.
+ */
+void Course_Index_Flush(void);
+
+/**
+ * @brief  Frees the bitmaps without saving them.
+ */
+void Course_Index_Discard(void);
+
+/**
+ * @brief  Rebuilds every course bitmap from the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t Course_Index_Rebuild(void);
+
+/**
+ * @brief  Updates the bitmaps for the record now stored in a slot.
+ *
+ * @details
+ * - Active records are added to the bitmap of every course they
+ *   take and removed from the others.
+ * - Deleted records are removed from all bitmaps.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record now stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Course_Index_Set(uint32_t slot, const Student_t* student);
+
+/**
+ * @brief  Removes a slot from all bitmaps.
+ *
+ * @param  slot Record slot number.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Course_Index_Remove(uint32_t slot);
+
+/**
+ * @brief  Visits the active students matching a course combination.
+ *
+ * @details
+ * - Matches students taking every course in all_of and none of
+ *   the courses in none_of.
+ * - Slots are visited in increasing order.
+ *
+ * @param  all_of  Courses the student must take.
+ * @param  none_of Courses the student must not take.
+ * @param  visit   Callback for every matching slot.
+ * @param  context Pointer forwarded to the callback.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Course_Index_Query(Course_Mask_t all_of, Course_Mask_t none_of, Course_Index_Visit_t visit, void* context);
+
+#endif // !_Course_Index_H_
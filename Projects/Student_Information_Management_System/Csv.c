@@ -0,0 +1,335 @@
+#include "Csv.h"
+#include <string.h>
+
+#define MANTISSA_LIMIT    1000000000000000000ULL    /* 10^18, one more digit still fits 64 bits */
+
+static const double Powers_Of_Ten[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * @brief  Finds the line break ending the record at the start of text.
+ *
+ * @details
+ * - Line breaks inside a quoted field belong to the record. A
+ *   quote opens a field only as its first character, and "" in
+ *   a quoted field is a quote.
+ *
+ * @return true with end at the line break, false if the text ends first.
+ */
+static bool Find_Record_End(const char* text, size_t length, size_t* end, uint32_t* lines)
+{
+    const char* newline = memchr(text, '\n', length);
+    size_t limit = newline ? (size_t)(newline - text) : length;
+
+    *lines = 1;
+
+    /* Most records hold no quote: the first line break ends them */
+    if (!memchr(text, '"', limit))
+    {
+        *end = limit;
+        return newline != NULL;
+    }
+
+    bool quoted = false;
+    bool field_start = true;
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = text[i];
+
+        if (quoted)
+        {
+            if (c == '"')
+            {
+                if (i + 1 < length && text[i + 1] == '"')
+                    i++;
+                else
+                    quoted = false;
+            }
+            else if (c == '\n')
+            {
+                (*lines)++;
+            }
+            continue;
+        }
+
+        if (c == '\n')
+        {
+            *end = i;
+            return true;
+        }
+        if (c == '"' && field_start)
+            quoted = true;
+        field_start = (c == ',');
+    }
+
+    *end = length;
+    return false;
+}
+
+/* Splits a complete record, without its line break, into fields */
+static void Split_Fields(char* text, size_t end, Csv_Record_t* record)
+{
+    size_t pos = 0;
+
+    if (end > 0 && text[end - 1] == '\r')
+        end--;
+    record->count = 0;
+
+    while (1)
+    {
+        char* field = text + pos;
+        size_t length;
+
+        if (pos < end && text[pos] == '"')
+        {
+            /* Unquote in place: the content moves onto the opening quote */
+            size_t out = pos;
+            pos++;
+            while (pos < end)
+            {
+                if (text[pos] == '"')
+                {
+                    if (pos + 1 < end && text[pos + 1] == '"')
+                    {
+                        text[out++] = '"';
+                        pos += 2;
+                        continue;
+                    }
+                    pos++;
+                    break;
+                }
+                text[out++] = text[pos++];
+            }
+
+            /* Text between the closing quote and the comma is kept */
+            while (pos < end && text[pos] != ',')
+                text[out++] = text[pos++];
+            length = out - (size_t)(field - text);
+        }
+        else
+        {
+            const char* comma = memchr(field, ',', end - pos);
+            size_t stop = comma ? (size_t)(comma - text) : end;
+            length = stop - pos;
+            pos = stop;
+        }
+
+        if (record->count < CSV_MAX_FIELDS)
+        {
+            record->fields[record->count].data = field;
+            record->fields[record->count].length = (uint32_t)length;
+        }
+        record->count++;
+
+        if (pos >= end)
+            break;
+        pos++;  /* Past the comma */
+    }
+}
+
+/**
+ * @brief  Splits the record at the start of a text into fields.
+ *
+ * @details
+ * - Field spans point into text; quoted fields are unquoted in
+ *   place, so the text must be writable and outlive the spans.
+ * - An empty line is a record with one empty field.
+ *
+ * @param  text     Text starting at a record.
+ * @param  length   Bytes in text.
+ * @param  at_end   true if no input follows the text.
+ * @param  record   Filled with the fields of the record.
+ * @param  consumed Set to the bytes of the record and its line break.
+ * @return CSV_RECORD, CSV_INCOMPLETE if !at_end and the record may
+ *         continue past the text, CSV_END if at_end and the text
+ *         is empty, or CSV_ERROR for a missing argument.
+ */
+Csv_Result_t Csv_Split(char* text, size_t length, bool at_end, Csv_Record_t* record, size_t* consumed)
+{
+    size_t end;
+    uint32_t lines;
+
+    if (!record || !consumed || (length > 0 && !text))
+        return CSV_ERROR;
+    if (length == 0)
+        return at_end ? CSV_END : CSV_INCOMPLETE;
+
+    bool terminated = Find_Record_End(text, length, &end, &lines);
+    if (!terminated && !at_end)
+        return CSV_INCOMPLETE;
+
+    /* Unquoting writes to the text, so only complete records are split */
+    Split_Fields(text, end, record);
+    record->lines = lines;
+    *consumed = terminated ? end + 1 : length;
+    return CSV_RECORD;
+}
+
+/**
+ * @brief  Measures the complete records at the start of a text.
+ *
+ * @details
+ * - Lets a text be cut into blocks of whole records, to be split
+ *   independently, without splitting it first.
+ *
+ * @param  text   Text starting at a record.
+ * @param  length Bytes in text.
+ * @return Bytes taken by the records ended by a line break, 0 if
+ *         the first record does not end in the text.
+ */
+size_t Csv_Complete_Length(const char* text, size_t length)
+{
+    size_t last = length;
+    size_t pos = 0;
+    size_t end;
+    uint32_t lines;
+
+    if (!text)
+        return 0;
+    while (last > 0 && text[last - 1] != '\n')
+        last--;
+    if (last == 0)
+        return 0;
+
+    /* Without quotes every line break ends a record */
+    if (!memchr(text, '"', last))
+        return last;
+
+    while (pos < length && Find_Record_End(text + pos, length - pos, &end, &lines))
+        pos += end + 1;
+    return pos;
+}
+
+static void Trim(Csv_Span_t* span)
+{
+    while (span->length > 0 && (span->data[0] == ' ' || span->data[0] == '\t'))
+    {
+        span->data++;
+        span->length--;
+    }
+    while (span->length > 0 && (span->data[span->length - 1] == ' ' || span->data[span->length - 1] == '\t'))
+        span->length--;
+}
+
+/**
+ * @brief  Parses an unsigned decimal integer.
+ *
+ * @details
+ * - Spaces and tabs around the digits are allowed.
+ *
+ * @param  span  Field to parse.
+ * @param  value Set to the value on success.
+ * @return true if the whole field is a number below 2^32.
+ */
+bool Csv_Parse_U32(Csv_Span_t span, uint32_t* value)
+{
+    uint64_t result = 0;
+
+    Trim(&span);
+    if (!value || span.length == 0)
+        return false;
+
+    for (uint32_t i = 0; i < span.length; i++)
+    {
+        uint32_t digit = (uint32_t)(unsigned char)span.data[i] - '0';
+        if (digit > 9)
+            return false;
+        result = result * 10 + digit;
+        if (result > 0xFFFFFFFFULL)
+            return false;
+    }
+
+    *value = (uint32_t)result;
+    return true;
+}
+
+/**
+ * @brief  Parses a decimal number with optional sign, fraction
+ *         and exponent.
+ *
+ * @details
+ * - Spaces and tabs around the number are allowed.
+ *
+ * @param  span  Field to parse.
+ * @param  value Set to the value on success.
+ * @return true if the whole field is a number.
+ */
+bool Csv_Parse_Float(Csv_Span_t span, float* value)
+{
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    uint32_t digits = 0;
+    bool negative = false;
+    uint32_t i = 0;
+
+    Trim(&span);
+    if (!value || span.length == 0)
+        return false;
+
+    if (span.data[i] == '+' || span.data[i] == '-')
+        negative = (span.data[i++] == '-');
+
+    /* Digits past 18 only scale the value */
+    for (; i < span.length && span.data[i] >= '0' && span.data[i] <= '9'; i++, digits++)
+    {
+        if (mantissa < MANTISSA_LIMIT)
+            mantissa = mantissa * 10 + (uint32_t)(span.data[i] - '0');
+        else
+            exponent++;
+    }
+    if (i < span.length && span.data[i] == '.')
+    {
+        for (i++; i < span.length && span.data[i] >= '0' && span.data[i] <= '9'; i++, digits++)
+        {
+            if (mantissa < MANTISSA_LIMIT)
+            {
+                mantissa = mantissa * 10 + (uint32_t)(span.data[i] - '0');
+                exponent--;
+            }
+        }
+    }
+    if (digits == 0)
+        return false;
+
+    if (i < span.length && (span.data[i] == 'e' || span.data[i] == 'E'))
+    {
+        bool exponent_negative = false;
+        int written = 0;
+        uint32_t exponent_digits = 0;
+
+        i++;
+        if (i < span.length && (span.data[i] == '+' || span.data[i] == '-'))
+            exponent_negative = (span.data[i++] == '-');
+        for (; i < span.length && span.data[i] >= '0' && span.data[i] <= '9'; i++, exponent_digits++)
+        {
+            if (written < 10000)
+                written = written * 10 + (span.data[i] - '0');
+        }
+        if (exponent_digits == 0)
+            return false;
+        exponent += exponent_negative ? -written : written;
+    }
+    if (i != span.length)
+        return false;
+
+    /* Exact for up to 15 digits and small exponents, the usual case */
+    double result = (double)mantissa;
+    if (exponent < 0)
+    {
+        for (; exponent < -22; exponent += 22)
+            result /= 1e22;
+        result /= Powers_Of_Ten[-exponent];
+    }
+    else
+    {
+        for (; exponent > 22; exponent -= 22)
+            result *= 1e22;
+        result *= Powers_Of_Ten[exponent];
+    }
+
+    *value = (float)(negative ? -result : result);
+    return true;
+}
@@ -0,0 +1,106 @@
+#ifndef _Csv_H_
+#define _Csv_H_
+
+/* ============================================================
+ *  CSV Tokenizer
+ *
+ *  Description:
+ *  Splits comma separated records into fields without copying
+ *  them: a field is a span pointing into the caller's text, and
+ *  numbers are parsed straight from spans. Quoted fields may
+ *  hold commas, line breaks and "" for a quote; they are
+ *  unquoted in place. Lines end with LF or CRLF and may be of
+ *  any length.
+ *
+ *  Every function works only on the text it is given, so
+ *  several threads can parse at once.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define CSV_MAX_FIELDS       32           /* Field spans kept per record */
+
+/* A field: length bytes at data, not NUL terminated */
+typedef struct
+{
+    const char* data;
+    uint32_t length;
+} Csv_Span_t;
+
+typedef struct
+{
+    Csv_Span_t fields[CSV_MAX_FIELDS];
+    uint32_t count;                 /* Fields in the record, may exceed CSV_MAX_FIELDS */
+    uint32_t lines;                 /* Lines the record spans, more than 1 with quoted line breaks */
+} Csv_Record_t;
+
+typedef enum
+{
+    CSV_RECORD = 0,                 /* A record was split */
+    CSV_INCOMPLETE,                 /* The text ends inside the record, more input is needed */
+    CSV_END,                        /* No record left */
+    CSV_ERROR                       /* A required argument is missing */
+} Csv_Result_t;
+
+/**
+ * @brief  Splits the record at the start of a text into fields.
+ *
+ * @details
+ * - Field spans point into text; quoted fields are unquoted in
+ *   place, so the text must be writable and outlive the spans.
+ * - An empty line is a record with one empty field.
+ *
+ * @param  text     Text starting at a record.
+ * @param  length   Bytes in text.
+ * @param  at_end   true if no input follows the text.
+ * @param  record   Filled with the fields of the record.
+ * @param  consumed Set to the bytes of the record and its line break.
+ * @return CSV_RECORD, CSV_INCOMPLETE if !at_end and the record may
+ *         continue past the text, CSV_END if at_end and the text
+ *         is empty, or CSV_ERROR for a missing argument.
+ */
+Csv_Result_t Csv_Split(char* text, size_t length, bool at_end, Csv_Record_t* record, size_t* consumed);
+
+/**
+ * @brief  Measures the complete records at the start of a text.
+ *
+ * @details
+ * - Lets a text be cut into blocks of whole records, to be split
+ *   independently, without splitting it first.
+ *
+ * @param  text   Text starting at a record.
+ * @param  length Bytes in text.
+ * @return Bytes taken by the records ended by a line break, 0 if
+ *         the first record does not end in the text.
+ */
+size_t Csv_Complete_Length(const char* text, size_t length);
+
+/**
+ * @brief  Parses an unsigned decimal integer.
+ *
+ * @details
+ * - Spaces and tabs around the digits are allowed.
+ *
+ * @param  span  Field to parse.
+ * @param  value Set to the value on success.
+ * @return true if the whole field is a number below 2^32.
+ */
+bool Csv_Parse_U32(Csv_Span_t span, uint32_t* value);
+
+/**
+ * @brief  Parses a decimal number with optional sign, fraction
+ *         and exponent.
+ *
+ * @details
+ * - Spaces and tabs around the number are allowed.
+ *
+ * @param  span  Field to parse.
+ * @param  value Set to the value on success.
+ * @return true if the whole field is a number.
+ */
+bool Csv_Parse_Float(Csv_Span_t span, float* value);
+
+#endif // !_Csv_H_
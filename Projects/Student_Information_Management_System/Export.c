@@ -0,0 +1,264 @@
+#include "Export.h"
+#include "Storage.h"
+
+/* Longest record in either format: both names fully quoted, every course listed */
+#define EXPORT_RECORD_MAX_BYTES   (4 * MAX_NAME_LENGTH + 4 * MAX_COURSES + 64)
+
+#if EXPORT_BUFFER_SIZE < 2 * EXPORT_RECORD_MAX_BYTES
+#error "EXPORT_BUFFER_SIZE must hold at least two records"
+#endif
+
+/* Length of a stored name, which fills its array when it has no terminator */
+static uint32_t Name_Length(const char* name)
+{
+    uint32_t length = 0;
+
+    while (length < MAX_NAME_LENGTH - 1 && name[length] != '\0')
+        length++;
+    return length;
+}
+
+/* ============================================================
+ *                    CSV Fields
+ * ============================================================ */
+static char* Put_Decimal(char* out, uint32_t value)
+{
+    char digits[10];
+    uint32_t count = 0;
+
+    do
+    {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    while (count > 0)
+        *out++ = digits[--count];
+    return out;
+}
+
+/* Quotes a name only if the importer would otherwise split it */
+static char* Put_Name(char* out, const char* name)
+{
+    uint32_t length = Name_Length(name);
+    bool quote = false;
+
+    for (uint32_t i = 0; i < length && !quote; i++)
+        quote = (name[i] == ',' || name[i] == '"' || name[i] == '\n' || name[i] == '\r');
+
+    if (!quote)
+    {
+        my_memcpy(out, name, (int)length);
+        return out + length;
+    }
+
+    *out++ = '"';
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (name[i] == '"')
+            *out++ = '"';
+        *out++ = name[i];
+    }
+    *out++ = '"';
+    return out;
+}
+
+/*
+ * Two decimals, the way GPAs are entered, whenever they read back
+ * as the same float; otherwise enough digits to round-trip.
+ */
+static char* Put_GPA(char* out, float gpa)
+{
+    if (gpa >= 0.0f && gpa < 1000.0f)
+    {
+        uint32_t hundredths = (uint32_t)(gpa * 100.0f + 0.5f);
+        if ((float)(hundredths / 100.0) == gpa)
+        {
+            out = Put_Decimal(out, hundredths / 100);
+            *out++ = '.';
+            *out++ = (char)('0' + (hundredths / 10) % 10);
+            *out++ = (char)('0' + hundredths % 10);
+            return out;
+        }
+    }
+    return out + sprintf(out, "%.9g", gpa);
+}
+
+static char* Put_CSV_Record(char* out, const Student_t* student, Export_Columns_t columns)
+{
+    const char* start = out;
+
+    if (columns & EXPORT_COLUMN_ID)
+        out = Put_Decimal(out, student->id);
+    if (columns & EXPORT_COLUMN_FIRST_NAME)
+    {
+        if (out != start) *out++ = ',';
+        out = Put_Name(out, student->first_name);
+    }
+    if (columns & EXPORT_COLUMN_LAST_NAME)
+    {
+        if (out != start) *out++ = ',';
+        out = Put_Name(out, student->last_name);
+    }
+    if (columns & EXPORT_COLUMN_GPA)
+    {
+        if (out != start) *out++ = ',';
+        out = Put_GPA(out, student->GPA);
+    }
+    if (columns & EXPORT_COLUMN_COURSES)
+    {
+        uint8_t count = (student->course_count < MAX_COURSES) ? student->course_count : MAX_COURSES;
+
+        if (out != start) *out++ = ',';
+        out = Put_Decimal(out, count);
+        for (uint8_t i = 0; i < count; i++)
+        {
+            *out++ = ',';
+            out = Put_Decimal(out, student->courses[i]);
+        }
+    }
+    *out++ = '\n';
+    return out;
+}
+
+/* ============================================================
+ *                    Binary Fields
+ * ============================================================ */
+static char* Put_U32_LE(char* out, uint32_t value)
+{
+    out[0] = (char)(value & 0xFF);
+    out[1] = (char)((value >> 8) & 0xFF);
+    out[2] = (char)((value >> 16) & 0xFF);
+    out[3] = (char)((value >> 24) & 0xFF);
+    return out + 4;
+}
+
+static char* Put_Binary_Header(char* out, Export_Columns_t columns, uint32_t count)
+{
+    out = Put_U32_LE(out, EXPORT_BINARY_MAGIC);
+    out = Put_U32_LE(out, EXPORT_BINARY_VERSION);
+    out = Put_U32_LE(out, columns);
+    return Put_U32_LE(out, count);
+}
+
+static char* Put_Binary_Name(char* out, const char* name)
+{
+    uint32_t length = Name_Length(name);
+
+    *out++ = (char)length;
+    my_memcpy(out, name, (int)length);
+    return out + length;
+}
+
+static char* Put_Binary_Record(char* out, const Student_t* student, Export_Columns_t columns)
+{
+    if (columns & EXPORT_COLUMN_ID)
+        out = Put_U32_LE(out, student->id);
+    if (columns & EXPORT_COLUMN_FIRST_NAME)
+        out = Put_Binary_Name(out, student->first_name);
+    if (columns & EXPORT_COLUMN_LAST_NAME)
+        out = Put_Binary_Name(out, student->last_name);
+    if (columns & EXPORT_COLUMN_GPA)
+    {
+        unsigned int bits;          /* 32 bits, like the float */
+        my_memcpy(&bits, &student->GPA, (int)sizeof(bits));
+        out = Put_U32_LE(out, bits);
+    }
+    if (columns & EXPORT_COLUMN_COURSES)
+    {
+        uint8_t count = (student->course_count < MAX_COURSES) ? student->course_count : MAX_COURSES;
+
+        *out++ = (char)count;
+        my_memcpy(out, student->courses, count);
+        out += count;
+    }
+    return out;
+}
+
+static bool Write_All(FILE* fp, const char* buffer, size_t length)
+{
+    return fwrite(buffer, 1, length, fp) == length;
+}
+
+/**
+ * @brief  Writes every active student to a file.
+ *
+ * @details
+ * - Reads the records through the storage mapping, in slot
+ *   order; the caller holds the read lock.
+ * - Creates or truncates the file.
+ *
+ * @param  export_file Path of the file to create.
+ * @param  format      EXPORT_FORMAT_CSV or EXPORT_FORMAT_BINARY.
+ * @param  columns     Export_Column_t bits of the fields to write.
+ * @param  exported    Set to the number of students written, may be NULL.
+ * @return F_OK on success, F_INVALID_FIELD for an unknown format or
+ *         no column, otherwise error code.
+ */
+F_Return_t Export_To_File(const char* export_file, Export_Format_t format, Export_Columns_t columns, uint32_t* exported)
+{
+    const Student_t* records;
+    uint32_t count;
+    uint32_t written = 0;
+    bool binary = (format == EXPORT_FORMAT_BINARY);
+
+    if (exported)
+        *exported = 0;
+    if (!export_file)
+        return F_NOT_OK;
+    columns &= EXPORT_COLUMNS_ALL;
+    if ((format != EXPORT_FORMAT_CSV && !binary) || columns == 0)
+        return F_INVALID_FIELD;
+
+    F_Return_t status = Storage_Map(&records, &count);
+    if (status != F_OK)
+        return status;
+
+    FILE* export_fp = fopen(export_file, "wb");
+    if (!export_fp)
+        return F_FILE_OPEN_ERROR;
+
+    /* The buffer is the only write buffer, stdio's would add a copy */
+    setvbuf(export_fp, NULL, _IONBF, 0);
+    char* buffer = malloc(EXPORT_BUFFER_SIZE);
+    if (!buffer)
+    {
+        fclose(export_fp);
+        return F_NOT_OK;
+    }
+
+    /* The record count is filled in once it is known */
+    char* out = (binary) ? Put_Binary_Header(buffer, columns, 0) : buffer;
+    for (uint32_t slot = 0; slot < count && status == F_OK; slot++)
+    {
+        if (!records[slot].is_active)
+            continue;
+
+        if ((size_t)(out - buffer) > EXPORT_BUFFER_SIZE - EXPORT_RECORD_MAX_BYTES)
+        {
+            if (!Write_All(export_fp, buffer, (size_t)(out - buffer)))
+                status = F_FILE_WRITE_ERROR;
+            out = buffer;
+        }
+        out = (binary) ? Put_Binary_Record(out, &records[slot], columns)
+                       : Put_CSV_Record(out, &records[slot], columns);
+        written++;
+    }
+    if (status == F_OK && !Write_All(export_fp, buffer, (size_t)(out - buffer)))
+        status = F_FILE_WRITE_ERROR;
+
+    if (status == F_OK && binary)
+    {
+        Put_Binary_Header(buffer, columns, written);
+        if (fseek(export_fp, 0, SEEK_SET) != 0 || !Write_All(export_fp, buffer, EXPORT_BINARY_HEADER_SIZE))
+            status = F_FILE_WRITE_ERROR;
+    }
+
+    if (fclose(export_fp) != 0 && status == F_OK)
+        status = F_FILE_WRITE_ERROR;
+    free(buffer);
+
+    if (exported && status == F_OK)
+        *exported = written;
+    return status;
+}
@@ -0,0 +1,53 @@
+#ifndef _Export_H_
+#define _Export_H_
+
+/* ============================================================
+ *  Bulk Export Engine
+ *
+ *  Description:
+ *  Writes the active students of the database to a file, as CSV
+ *  or as packed binary records. Records are formatted by hand
+ *  straight into one large buffer that is written with a single
+ *  call whenever it fills, so an export runs at disk speed.
+ *
+ *  CSV: one line per student, the selected fields in the order
+ *  ID, first name, last name, GPA, course count, courses. Names
+ *  holding a comma, quote or line break are quoted. There is no
+ *  header row: with every column the file can be imported again.
+ *
+ *  Binary, all integers little-endian:
+ *    header  magic (4), version (4), columns (4), record count (4)
+ *    record  the selected fields in the same order:
+ *            ID (4), first name (1 length + bytes),
+ *            last name (1 length + bytes), GPA (4, IEEE float),
+ *            course count (1) + one byte per course
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define EXPORT_BUFFER_SIZE        (1 << 20)        /* Bytes formatted per write call */
+#define EXPORT_BINARY_MAGIC       0x58455453UL     /* "STEX" */
+#define EXPORT_BINARY_VERSION     1
+#define EXPORT_BINARY_HEADER_SIZE 16
+
+/**
+ * @brief  Writes every active student to a file.
+ *
+ * @details
+ * - Reads the records through the storage mapping, in slot
+ *   order; the caller holds the read lock.
+ * - Creates or truncates the file.
+ *
+ * @param  export_file Path of the file to create.
+ * @param  format      EXPORT_FORMAT_CSV or EXPORT_FORMAT_BINARY.
+ * @param  columns     Export_Column_t bits of the fields to write.
+ * @param  exported    Set to the number of students written, may be NULL.
+ * @return F_OK on success, F_INVALID_FIELD for an unknown format or
+ *         no column, otherwise error code.
+ */
+F_Return_t Export_To_File(const char* export_file, Export_Format_t format, Export_Columns_t columns, uint32_t* exported);
+
+#endif // !_Export_H_
@@ -0,0 +1,538 @@
+#include "GPA_Index.h"
+#include "Indexes.h"
+#include "Storage.h"
+
+/* ============================================================
+ *                    In-Memory Layout
+ *
+ *  Nodes are ordered by (GPA, ID). Every node is linked forward
+ *  on its first `level` levels and backward on level 0, so the
+ *  list can be walked from either end. Levels are drawn with
+ *  probability 1/4 per extra level.
+ *
+ *  On disk the header is followed by the (GPA, ID, slot) entries
+ *  in key order, which lets the list be rebuilt by appending.
+ * ============================================================ */
+typedef struct
+{
+    uint32_t magic;                 /* GPA_INDEX_MAGIC */
+    uint32_t generation;            /* Database generation covered by the index */
+    uint32_t is_clean;              /* 1 when saved after the last change */
+    uint32_t count;                 /* Entries in the file */
+} GPA_Index_Header_t;
+
+typedef struct
+{
+    float gpa;
+    uint32_t id;
+    uint32_t slot;
+} GPA_Entry_t;
+
+typedef struct GPA_Node
+{
+    GPA_Entry_t entry;
+    struct GPA_Node* prev;          /* Level 0 predecessor, NULL for the first node */
+    uint32_t level;                 /* Forward links in next */
+    struct GPA_Node* next[];
+} GPA_Node_t;
+
+static GPA_Node_t* head = NULL;     /* Sentinel with GPA_SKIP_MAX_LEVEL links */
+static GPA_Node_t* tail = NULL;     /* Last node, NULL if the list is empty */
+static uint32_t list_level = 1;     /* Levels in use */
+static uint32_t random_state = 2463534242UL;
+static GPA_Index_Header_t index_header;
+static bool index_loaded = false;
+
+/* Orders nodes by GPA, then ID */
+static bool Entry_Less(const GPA_Entry_t* entry, float gpa, uint32_t id)
+{
+    return (entry->gpa < gpa) || (entry->gpa == gpa && entry->id < id);
+}
+
+static int Compare_Entries(const void* a, const void* b)
+{
+    const GPA_Entry_t* x = a;
+    const GPA_Entry_t* y = b;
+    if (Entry_Less(x, y->gpa, y->id))
+        return -1;
+    return Entry_Less(y, x->gpa, x->id) ? 1 : 0;
+}
+
+/* Xorshift draw, one more level for every zero pair of bits */
+static uint32_t Random_Level(void)
+{
+    uint32_t bits, level = 1;
+
+    random_state ^= (random_state << 13) & 0xFFFFFFFFUL;
+    random_state ^= random_state >> 17;
+    random_state ^= (random_state << 5) & 0xFFFFFFFFUL;
+
+    for (bits = random_state; level < GPA_SKIP_MAX_LEVEL && (bits & 3) == 0; bits >>= 2)
+        level++;
+    return level;
+}
+
+static GPA_Node_t* New_Node(const GPA_Entry_t* entry, uint32_t level)
+{
+    GPA_Node_t* node = malloc(sizeof(GPA_Node_t) + level * sizeof(GPA_Node_t*));
+    if (!node)
+        return NULL;
+
+    node->entry = *entry;
+    node->prev = NULL;
+    node->level = level;
+    for (uint32_t i = 0; i < level; i++)
+        node->next[i] = NULL;
+    return node;
+}
+
+static void Free_List(void)
+{
+    if (!head)
+        return;
+
+    GPA_Node_t* node = head->next[0];
+    while (node)
+    {
+        GPA_Node_t* next = node->next[0];
+        free(node);
+        node = next;
+    }
+    free(head);
+    head = NULL;
+    tail = NULL;
+    list_level = 1;
+    index_header.count = 0;
+}
+
+static F_Return_t Reset_List(void)
+{
+    GPA_Entry_t none = { 0 };
+
+    Free_List();
+    head = New_Node(&none, GPA_SKIP_MAX_LEVEL);
+    return (head) ? F_OK : F_NOT_OK;
+}
+
+/* Collects, per level, the last node ordered before (gpa, id) */
+static void Find_Path(float gpa, uint32_t id, GPA_Node_t** path)
+{
+    GPA_Node_t* node = head;
+
+    for (uint32_t level = list_level; level-- > 0;)
+    {
+        while (node->next[level] && Entry_Less(&node->next[level]->entry, gpa, id))
+            node = node->next[level];
+        path[level] = node;
+    }
+}
+
+/* Appends an entry known to sort after every node; last holds the per-level tails */
+static F_Return_t Append_Entry(const GPA_Entry_t* entry, GPA_Node_t** last)
+{
+    uint32_t level = Random_Level();
+    GPA_Node_t* node = New_Node(entry, level);
+    if (!node)
+        return F_NOT_OK;
+
+    for (uint32_t i = 0; i < level; i++)
+    {
+        last[i]->next[i] = node;
+        last[i] = node;
+    }
+    if (level > list_level)
+        list_level = level;
+
+    node->prev = tail;
+    tail = node;
+    index_header.count++;
+    return F_OK;
+}
+
+static F_Return_t Write_Header(FILE* fp)
+{
+    if (fseek(fp, 0, SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(&index_header, sizeof(GPA_Index_Header_t), 1, fp) != 1)
+        return F_FILE_WRITE_ERROR;
+    return F_OK;
+}
+
+/* Writes the entries in key order and stamps the file clean for the current generation */
+static F_Return_t Save_Index(void)
+{
+    GPA_Entry_t buffer[256];
+    uint32_t buffered = 0;
+
+    FILE* fp = fopen(GPA_INDEX_FILE_NAME, "wb");
+    if (!fp)
+        return F_FILE_OPEN_ERROR;
+
+    index_header.magic = GPA_INDEX_MAGIC;
+    index_header.is_clean = 0;
+    Storage_Get_Generation(&index_header.generation);
+
+    F_Return_t status = Write_Header(fp);
+    for (GPA_Node_t* node = head->next[0]; status == F_OK; node = node->next[0])
+    {
+        if (node)
+            buffer[buffered++] = node->entry;
+        if (buffered == 256 || (!node && buffered > 0))
+        {
+            if (fwrite(buffer, sizeof(GPA_Entry_t), buffered, fp) != buffered)
+                status = F_FILE_WRITE_ERROR;
+            buffered = 0;
+        }
+        if (!node)
+            break;
+    }
+    if (status == F_OK)
+    {
+        index_header.is_clean = 1;
+        status = Write_Header(fp);
+    }
+    fclose(fp);
+    return status;
+}
+
+/* Reads a clean list written for the current generation */
+static F_Return_t Load_Index(void)
+{
+    GPA_Index_Header_t stored;
+    GPA_Entry_t buffer[256];
+    GPA_Node_t* last[GPA_SKIP_MAX_LEVEL];
+    uint32_t generation = 0;
+    F_Return_t status;
+
+    if (Storage_Get_Generation(&generation) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    FILE* fp = fopen(GPA_INDEX_FILE_NAME, "rb");
+    if (!fp)
+        return F_FILE_OPEN_ERROR;
+
+    if (fread(&stored, sizeof(stored), 1, fp) != 1 || stored.magic != GPA_INDEX_MAGIC ||
+        !stored.is_clean || stored.generation != generation || Reset_List() != F_OK)
+    {
+        fclose(fp);
+        return F_FILE_READ_ERROR;
+    }
+
+    for (uint32_t i = 0; i < GPA_SKIP_MAX_LEVEL; i++)
+        last[i] = head;
+
+    status = F_OK;
+    for (uint32_t done = 0; done < stored.count && status == F_OK;)
+    {
+        uint32_t wanted = (stored.count - done < 256) ? stored.count - done : 256;
+        if (fread(buffer, sizeof(GPA_Entry_t), wanted, fp) != wanted)
+            status = F_FILE_READ_ERROR;
+
+        for (uint32_t i = 0; i < wanted && status == F_OK; i++)
+            status = Append_Entry(&buffer[i], last);
+        done += wanted;
+    }
+    fclose(fp);
+
+    if (status != F_OK)
+    {
+        Free_List();
+        return status;
+    }
+    index_header = stored;
+    return F_OK;
+}
+
+/**
+ * @brief  Rebuilds the list from the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t GPA_Index_Rebuild(void)
+{
+    Student_t buffer[256];
+    GPA_Node_t* last[GPA_SKIP_MAX_LEVEL];
+    GPA_Entry_t* entries = NULL;
+    uint32_t record_count = 0, live = 0, dead = 0, got = 0, entry_count = 0;
+    F_Return_t status;
+
+    status = Storage_Record_Count(&record_count);
+    if (status == F_OK)
+        status = Storage_Get_Counts(&live, &dead);
+    if (status == F_OK)
+        status = Reset_List();
+    if (status != F_OK)
+        return status;
+    index_loaded = true;
+
+    if (live > 0)
+    {
+        entries = malloc(live * sizeof(GPA_Entry_t));
+        if (!entries)
+            return F_NOT_OK;
+    }
+
+    for (uint32_t slot = 0; slot < record_count; slot += got)
+    {
+        status = Storage_Read_Batch(slot, 256, buffer, &got);
+        if (status != F_OK || got == 0)
+            break;
+
+        for (uint32_t i = 0; i < got && entry_count < live; i++)
+        {
+            if (!buffer[i].is_active)
+                continue;
+            entries[entry_count].gpa = buffer[i].GPA;
+            entries[entry_count].id = buffer[i].id;
+            entries[entry_count].slot = slot + i;
+            entry_count++;
+        }
+    }
+
+    /* Sort once and append, instead of one search per insert */
+    if (entry_count > 0)
+        qsort(entries, entry_count, sizeof(GPA_Entry_t), Compare_Entries);
+    for (uint32_t i = 0; i < GPA_SKIP_MAX_LEVEL; i++)
+        last[i] = head;
+    for (uint32_t i = 0; i < entry_count && status == F_OK; i++)
+        status = Append_Entry(&entries[i], last);
+    free(entries);
+
+    if (status != F_OK)
+        return status;
+    return Save_Index();
+}
+
+/**
+ * @brief  Loads the GPA index, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the list from the database file when the index
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the index is ready, otherwise error code.
+ */
+F_Return_t GPA_Index_Open(void)
+{
+    if (index_loaded)
+        return F_OK;
+
+    if (Load_Index() == F_OK)
+    {
+        index_loaded = true;
+        return F_OK;
+    }
+
+    FILE* fp = fopen(GPA_INDEX_FILE_NAME, "rb");
+    if (fp)
+    {
+        fclose(fp);
+        printf("GPA index is stale, rebuilding...\n");
+    }
+    return GPA_Index_Rebuild();
+}
+
+/**
+ * @brief  Saves the list, stamps the index clean and frees it.
+ */
+void GPA_Index_Close(void)
+{
+    if (!index_loaded)
+        return;
+
+    /* A clean index on disk already matches memory, it only needs the current generation */
+    if (index_header.is_clean)
+        GPA_Index_Flush();
+    else
+        Save_Index();
+
+    Free_List();
+    index_loaded = false;
+}
+
+/**
+ * @brief  Stamps an unchanged GPA index file with the current generation.
+ *
+ * @details
+ * - Lets other processes load the list after a change that
+ *   left every GPA alone, instead of rebuilding it.
+ * - Does nothing if the list is not loaded or changed since it
+ *   was saved; GPA_Index_Close saves it then.
+ */
+void GPA_Index_Flush(void)
+{
+    if (index_loaded && index_header.is_clean)
+        Indexes_Stamp_Generation(GPA_INDEX_FILE_NAME, &index_header, sizeof(GPA_Index_Header_t), &index_header.generation);
+}
+
+/**
+ * @brief  Frees the list without saving it.
+ */
+void GPA_Index_Discard(void)
+{
+    if (!index_loaded)
+        return;
+
+    Free_List();
+    index_loaded = false;
+}
+
+/**
+ * @brief  Adds an active student under its (GPA, ID) key.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t GPA_Index_Insert(uint32_t slot, const Student_t* student)
+{
+    GPA_Node_t* path[GPA_SKIP_MAX_LEVEL];
+    GPA_Entry_t entry;
+    F_Return_t status;
+
+    if (!student)
+        return F_NOT_OK;
+
+    status = GPA_Index_Open();
+    if (status == F_OK)
+        status = Indexes_Mark_Dirty(NULL, GPA_INDEX_FILE_NAME, &index_header, sizeof(GPA_Index_Header_t), &index_header.is_clean);
+    if (status != F_OK)
+        return status;
+
+    entry.gpa = student->GPA;
+    entry.id = student->id;
+    entry.slot = slot;
+    Find_Path(entry.gpa, entry.id, path);
+
+    /* An existing key only takes the new slot */
+    GPA_Node_t* next = path[0]->next[0];
+    if (next && next->entry.gpa == entry.gpa && next->entry.id == entry.id)
+    {
+        next->entry.slot = slot;
+        return F_OK;
+    }
+
+    uint32_t level = Random_Level();
+    GPA_Node_t* node = New_Node(&entry, level);
+    if (!node)
+        return F_NOT_OK;
+
+    for (; list_level < level; list_level++)
+        path[list_level] = head;
+    for (uint32_t i = 0; i < level; i++)
+    {
+        node->next[i] = path[i]->next[i];
+        path[i]->next[i] = node;
+    }
+
+    node->prev = (path[0] == head) ? NULL : path[0];
+    if (node->next[0])
+        node->next[0]->prev = node;
+    else
+        tail = node;
+    index_header.count++;
+    return F_OK;
+}
+
+/**
+ * @brief  Removes a student from under its (GPA, ID) key.
+ *
+ * @param  student Record as it was indexed.
+ * @return F_OK if the entry was removed, otherwise F_ID_NOT_FOUND.
+ */
+F_Return_t GPA_Index_Remove(const Student_t* student)
+{
+    GPA_Node_t* path[GPA_SKIP_MAX_LEVEL];
+    F_Return_t status;
+
+    if (!student)
+        return F_NOT_OK;
+
+    status = GPA_Index_Open();
+    if (status != F_OK)
+        return status;
+
+    Find_Path(student->GPA, student->id, path);
+    GPA_Node_t* node = path[0]->next[0];
+    if (!node || node->entry.gpa != student->GPA || node->entry.id != student->id)
+        return F_ID_NOT_FOUND;
+
+    status = Indexes_Mark_Dirty(NULL, GPA_INDEX_FILE_NAME, &index_header, sizeof(GPA_Index_Header_t), &index_header.is_clean);
+    if (status != F_OK)
+        return status;
+
+    for (uint32_t i = 0; i < node->level; i++)
+        path[i]->next[i] = node->next[i];
+    if (node->next[0])
+        node->next[0]->prev = node->prev;
+    else
+        tail = node->prev;
+    while (list_level > 1 && head->next[list_level - 1] == NULL)
+        list_level--;
+
+    free(node);
+    index_header.count--;
+    return F_OK;
+}
+
+/**
+ * @brief  Visits the students with min_gpa <= GPA <= max_gpa.
+ *
+ * @details
+ * - Students are visited by increasing GPA, then ID.
+ *
+ * @param  min_gpa Lowest GPA in range.
+ * @param  max_gpa Highest GPA in range.
+ * @param  visit   Callback for every student in range.
+ * @param  context Pointer forwarded to the callback.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t GPA_Index_Range(float min_gpa, float max_gpa, GPA_Index_Visit_t visit, void* context)
+{
+    GPA_Node_t* path[GPA_SKIP_MAX_LEVEL];
+
+    if (!visit)
+        return F_NOT_OK;
+
+    F_Return_t status = GPA_Index_Open();
+    if (status != F_OK)
+        return status;
+
+    /* IDs are unsigned, so (min_gpa, 0) sorts before every node at min_gpa */
+    Find_Path(min_gpa, 0, path);
+    for (GPA_Node_t* node = path[0]->next[0]; node && node->entry.gpa <= max_gpa; node = node->next[0])
+    {
+        if (!visit(node->entry.slot, context))
+            break;
+    }
+    return F_OK;
+}
+
+/**
+ * @brief  Visits the count students with the highest GPA.
+ *
+ * @details
+ * - Students are visited by decreasing GPA, then ID.
+ *
+ * @param  count   Number of students to visit.
+ * @param  visit   Callback for every student.
+ * @param  context Pointer forwarded to the callback.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t GPA_Index_Top(uint32_t count, GPA_Index_Visit_t visit, void* context)
+{
+    if (!visit)
+        return F_NOT_OK;
+
+    F_Return_t status = GPA_Index_Open();
+    if (status != F_OK)
+        return status;
+
+    for (GPA_Node_t* node = tail; node && count > 0; node = node->prev, count--)
+    {
+        if (!visit(node->entry.slot, context))
+            break;
+    }
+    return F_OK;
+}
@@ -0,0 +1,118 @@
+#ifndef _GPA_Index_H_
+#define _GPA_Index_H_
+
+/* ============================================================
+ *  GPA Skip List Index
+ *
+ *  Description:
+ *  Skip list over the (GPA, ID) pairs of all active students,
+ *  each node holding the record slot. Range scans walk forward
+ *  from the first GPA in range and top-K queries walk backward
+ *  from the tail, so both return students in GPA order without
+ *  scanning or sorting the database. The list is kept in
+ *  memory and saved in key order to its own file on shutdown.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define GPA_INDEX_FILE_NAME        "Students_Information.gix"
+#define GPA_INDEX_MAGIC            0x58494753UL    /* "SGIX" */
+#define GPA_SKIP_MAX_LEVEL         16              /* Enough for 4^16 students */
+
+/**
+ * @brief  Called by the GPA queries for every student in order.
+ *
+ * @param  slot    Record slot of the student.
+ * @param  context Pointer passed to the query.
+ * @return true to continue, false to stop the query.
+ */
+typedef bool (*GPA_Index_Visit_t)(uint32_t slot, void* context);
+
+/**
+ * @brief  Loads the GPA index, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the list from the database file when the index
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the index is ready, otherwise error code.
+ */
+F_Return_t GPA_Index_Open(void);
+
+/**
+ * @brief  Saves the list, stamps the index clean and frees it.
+ */
+void GPA_Index_Close(void);
+
+/**
+ * @brief  Stamps an unchanged GPA index file with the current generation.
+ *
+ * @details
+ * - Lets other processes load the list after a change that
+ *   left every GPA alone, instead of rebuilding it.
+ * - Does nothing if the list is not loaded or changed since it
+ *   was saved; GPA_Index_Close saves it then.
+ */
+void GPA_Index_Flush(void);
+
+/**
+ * @brief  Frees the list without saving it.
+ */
+void GPA_Index_Discard(void);
+
+/**
+ * @brief  Rebuilds the list from the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t GPA_Index_Rebuild(void);
+
+/**
+ * @brief  Adds an active student under its (GPA, ID) key.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t GPA_Index_Insert(uint32_t slot, const Student_t* student);
+
+/**
+ * @brief  Removes a student from under its (GPA, ID) key.
+ *
+ * @param  student Record as it was indexed.
+ * @return F_OK if the entry was removed, otherwise F_ID_NOT_FOUND.
+ */
+F_Return_t GPA_Index_Remove(const Student_t* student);
+
+/**
+ * @brief  Visits the students with min_gpa <= GPA <= max_gpa.
+ *
+ * @details
+ * - Students are visited by increasing GPA, then ID.
+ *
+ * @param  min_gpa Lowest GPA in range.
+ * @param  max_gpa Highest GPA in range.
+ * @param  visit   Callback for every student in range.
+ * @param  context Pointer forwarded to the callback.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t GPA_Index_Range(float min_gpa, float max_gpa, GPA_Index_Visit_t visit, void* context);
+
+/**
+ * @brief  Visits the count students with the highest GPA.
+ *
+ * @details
+ * - Students are visited by decreasing GPA, then ID.
+ *
+ * @param  count   Number of students to visit.
+ * @param  visit   Callback for every student.
+ * @param  context Pointer forwarded to the callback.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t GPA_Index_Top(uint32_t count, GPA_Index_Visit_t visit, void* context);
+
+#endif // !_GPA_Index_H_
@@ -0,0 +1,366 @@
+#include "ID_Filter.h"
+#include "Indexes.h"
+#include "Storage.h"
+
+/* ============================================================
+ *                    Layout
+ *
+ *  counter_count 4-bit counters, a power of two, two per byte.
+ *  An ID maps to ID_FILTER_HASHES counters by double hashing
+ *  of a 64-bit mix of the ID.
+ *
+ *  On disk the header is followed by the counter bytes.
+ * ============================================================ */
+typedef struct
+{
+    uint32_t magic;                 /* ID_FILTER_MAGIC */
+    uint32_t generation;            /* Database generation covered by the filter */
+    uint32_t is_clean;              /* 1 when saved after the last change */
+    uint32_t counter_count;         /* Number of 4-bit counters */
+    uint32_t id_count;              /* IDs counted, to know when to grow */
+} ID_Filter_Header_t;
+
+#define COUNTER_MAX    15
+
+static uint8_t* counters = NULL;
+static ID_Filter_Header_t filter_header;
+static bool filter_loaded = false;
+static bool needs_growth = false;
+
+static uint64_t Mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/* Fills the counter positions of an ID, computed in 64 bits so every build agrees */
+static void Positions(uint32_t id, uint64_t* positions)
+{
+    uint64_t hash = Mix((uint64_t)id + 1);
+    uint64_t h1 = hash & 0xFFFFFFFFULL;
+    uint64_t h2 = (hash >> 32) | 1;
+    uint64_t mask = (uint64_t)filter_header.counter_count - 1;
+
+    for (uint32_t i = 0; i < ID_FILTER_HASHES; i++)
+        positions[i] = (h1 + i * h2) & mask;
+}
+
+static uint32_t Counter_Get(uint64_t position)
+{
+    return (counters[position >> 1] >> ((position & 1) * 4)) & 0xF;
+}
+
+static void Counter_Set(uint64_t position, uint32_t value)
+{
+    uint32_t shift = (uint32_t)(position & 1) * 4;
+    counters[position >> 1] = (uint8_t)((counters[position >> 1] & ~(0xF << shift)) | (value << shift));
+}
+
+static void Count(uint32_t id)
+{
+    uint64_t positions[ID_FILTER_HASHES];
+
+    Positions(id, positions);
+    for (uint32_t i = 0; i < ID_FILTER_HASHES; i++)
+    {
+        uint32_t value = Counter_Get(positions[i]);
+        if (value < COUNTER_MAX)
+            Counter_Set(positions[i], value + 1);
+    }
+    filter_header.id_count++;
+}
+
+static void Free_Counters(void)
+{
+    free(counters);
+    counters = NULL;
+    filter_loaded = false;
+    needs_growth = false;
+}
+
+static F_Return_t Write_Header(FILE* fp)
+{
+    if (fseek(fp, 0, SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(&filter_header, sizeof(ID_Filter_Header_t), 1, fp) != 1)
+        return F_FILE_WRITE_ERROR;
+    return F_OK;
+}
+
+/* Writes the counters and stamps the file clean for the current generation */
+static F_Return_t Save_Filter(void)
+{
+    F_Return_t status;
+
+    FILE* fp = fopen(ID_FILTER_FILE_NAME, "wb");
+    if (!fp)
+        return F_FILE_OPEN_ERROR;
+
+    filter_header.magic = ID_FILTER_MAGIC;
+    filter_header.is_clean = 0;
+    Storage_Get_Generation(&filter_header.generation);
+    status = Write_Header(fp);
+
+    if (status == F_OK && fwrite(counters, 1, filter_header.counter_count / 2, fp) != filter_header.counter_count / 2)
+        status = F_FILE_WRITE_ERROR;
+
+    if (status == F_OK)
+    {
+        filter_header.is_clean = 1;
+        status = Write_Header(fp);
+    }
+    fclose(fp);
+    return status;
+}
+
+/* Reads the counters of a clean filter file written for the current generation */
+static F_Return_t Load_Filter(void)
+{
+    ID_Filter_Header_t stored;
+    uint32_t generation = 0;
+
+    if (Storage_Get_Generation(&generation) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    FILE* fp = fopen(ID_FILTER_FILE_NAME, "rb");
+    if (!fp)
+        return F_FILE_OPEN_ERROR;
+
+    /* The counter count must be a power of two for the position mask */
+    if (fread(&stored, sizeof(stored), 1, fp) != 1 || stored.magic != ID_FILTER_MAGIC ||
+        !stored.is_clean || stored.generation != generation ||
+        stored.counter_count < 2 || (stored.counter_count & (stored.counter_count - 1)) != 0)
+    {
+        fclose(fp);
+        return F_FILE_READ_ERROR;
+    }
+
+    counters = malloc(stored.counter_count / 2);
+    if (!counters)
+    {
+        fclose(fp);
+        return F_NOT_OK;
+    }
+    if (fread(counters, 1, stored.counter_count / 2, fp) != stored.counter_count / 2)
+    {
+        fclose(fp);
+        Free_Counters();
+        return F_FILE_READ_ERROR;
+    }
+
+    fclose(fp);
+    filter_header = stored;
+    return F_OK;
+}
+
+/**
+ * @brief  Rebuilds the filter from the active records of the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t ID_Filter_Rebuild(void)
+{
+    Student_t buffer[256];
+    uint32_t record_count = 0, got = 0;
+    uint32_t counter_count = 2;
+    F_Return_t status;
+
+    Free_Counters();
+
+    status = Storage_Record_Count(&record_count);
+    if (status != F_OK)
+        return status;
+
+    /* Sized for every slot, active or not, so it rarely has to grow */
+    uint64_t wanted = (uint64_t)((record_count > ID_FILTER_MIN_IDS) ? record_count : ID_FILTER_MIN_IDS) * ID_FILTER_COUNTERS_PER_ID;
+    while (counter_count < wanted)
+        counter_count *= 2;
+
+    counters = calloc(counter_count / 2, 1);
+    if (!counters)
+        return F_NOT_OK;
+    my_memset(&filter_header, 0, sizeof(ID_Filter_Header_t));
+    filter_header.counter_count = counter_count;
+    filter_loaded = true;
+
+    for (uint32_t slot = 0; status == F_OK && slot < record_count; slot += got)
+    {
+        status = Storage_Read_Batch(slot, 256, buffer, &got);
+        if (status != F_OK || got == 0)
+            break;
+
+        for (uint32_t i = 0; i < got; i++)
+        {
+            if (buffer[i].is_active)
+                Count(buffer[i].id);
+        }
+    }
+
+    if (status != F_OK)
+    {
+        Free_Counters();
+        return status;
+    }
+    return Save_Filter();
+}
+
+/**
+ * @brief  Loads the ID filter, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the filter from the database file when the filter
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the filter is ready, otherwise error code.
+ */
+F_Return_t ID_Filter_Open(void)
+{
+    if (filter_loaded)
+        return F_OK;
+
+    if (Load_Filter() == F_OK)
+    {
+        filter_loaded = true;
+        return F_OK;
+    }
+
+    FILE* fp = fopen(ID_FILTER_FILE_NAME, "rb");
+    if (fp)
+    {
+        fclose(fp);
+        printf("Student ID filter is stale, rebuilding...\n");
+    }
+    return ID_Filter_Rebuild();
+}
+
+/**
+ * @brief  Saves the counters, stamps the filter clean and frees it.
+ */
+void ID_Filter_Close(void)
+{
+    if (!filter_loaded)
+        return;
+
+    /* A clean filter on disk already matches memory, it only needs the current generation */
+    if (filter_header.is_clean)
+        ID_Filter_Flush();
+    else
+        Save_Filter();
+
+    Free_Counters();
+}
+
+/**
+ * @brief  Stamps an unchanged filter file with the current generation.
+ *
+ * @details
+ * - Lets other processes load the filter after a change that
+ *   left the IDs alone, instead of rebuilding it.
+ * - Does nothing if the filter is not loaded or changed since it
+ *   was saved; ID_Filter_Close saves it then.
+ */
+void ID_Filter_Flush(void)
+{
+    if (filter_loaded && filter_header.is_clean)
+        Indexes_Stamp_Generation(ID_FILTER_FILE_NAME, &filter_header, sizeof(ID_Filter_Header_t), &filter_header.generation);
+}
+
+/**
+ * @brief  Frees the counters without saving them.
+ */
+void ID_Filter_Discard(void)
+{
+    if (!filter_loaded)
+        return;
+
+    Free_Counters();
+}
+
+/**
+ * @brief  Counts an ID that became active.
+ *
+ * @param  id Student unique ID.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t ID_Filter_Add(uint32_t id)
+{
+    F_Return_t status = ID_Filter_Open();
+    if (status == F_OK)
+        status = Indexes_Mark_Dirty(NULL, ID_FILTER_FILE_NAME, &filter_header, sizeof(ID_Filter_Header_t), &filter_header.is_clean);
+    if (status != F_OK)
+        return status;
+
+    Count(id);
+
+    /* Grown at the next lookup, once the record is in the database */
+    if (filter_header.id_count > filter_header.counter_count / ID_FILTER_COUNTERS_PER_ID)
+        needs_growth = true;
+    return F_OK;
+}
+
+/**
+ * @brief  Uncounts an ID that is no longer active.
+ *
+ * @details
+ * - Only IDs counted by ID_Filter_Add or a rebuild may be removed,
+ *   otherwise other IDs could be reported absent.
+ *
+ * @param  id Student unique ID.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t ID_Filter_Remove(uint32_t id)
+{
+    uint64_t positions[ID_FILTER_HASHES];
+
+    F_Return_t status = ID_Filter_Open();
+    if (status == F_OK)
+        status = Indexes_Mark_Dirty(NULL, ID_FILTER_FILE_NAME, &filter_header, sizeof(ID_Filter_Header_t), &filter_header.is_clean);
+    if (status != F_OK)
+        return status;
+
+    /* A saturated counter may count more IDs than it shows, so it never drops */
+    Positions(id, positions);
+    for (uint32_t i = 0; i < ID_FILTER_HASHES; i++)
+    {
+        uint32_t value = Counter_Get(positions[i]);
+        if (value > 0 && value < COUNTER_MAX)
+            Counter_Set(positions[i], value - 1);
+    }
+    if (filter_header.id_count > 0)
+        filter_header.id_count--;
+    return F_OK;
+}
+
+/**
+ * @brief  Tells whether an ID may be active.
+ *
+ * @details
+ * - false means the ID is certainly not active.
+ * - true means it probably is and must be checked in the ID
+ *   index; also returned when the filter cannot be loaded.
+ *
+ * @param  id Student unique ID.
+ * @return false if the ID is certainly absent, otherwise true.
+ */
+bool ID_Filter_May_Contain(uint32_t id)
+{
+    uint64_t positions[ID_FILTER_HASHES];
+
+    if (needs_growth && ID_Filter_Rebuild() != F_OK)
+        return true;
+    if (ID_Filter_Open() != F_OK)
+        return true;
+
+    Positions(id, positions);
+    for (uint32_t i = 0; i < ID_FILTER_HASHES; i++)
+    {
+        if (Counter_Get(positions[i]) == 0)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,103 @@
+#ifndef _ID_Filter_H_
+#define _ID_Filter_H_
+
+/* ============================================================
+ *  Student ID Membership Filter
+ *
+ *  Description:
+ *  Counting Bloom filter over the active student IDs. Every ID
+ *  sets ID_FILTER_HASHES 4-bit counters; an ID with any of its
+ *  counters at zero is certainly not in the database, so most
+ *  new IDs are accepted without an ID index lookup. Counters
+ *  are decremented on delete, a saturated counter stays put.
+ *
+ *  The filter is sized from the record count when built and
+ *  rebuilt at twice the size once the IDs outgrow it, so the
+ *  false positive rate stays near 0.1%.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define ID_FILTER_FILE_NAME          "Students_Information.idf"
+#define ID_FILTER_MAGIC              0x46444953UL    /* "SIDF" */
+#define ID_FILTER_HASHES             6               /* Counters per ID */
+#define ID_FILTER_COUNTERS_PER_ID    16              /* Counters per expected ID, rounded up to a power of two */
+#define ID_FILTER_MIN_IDS            1024            /* IDs the smallest filter is sized for */
+
+/**
+ * @brief  Loads the ID filter, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the filter from the database file when the filter
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the filter is ready, otherwise error code.
+ */
+F_Return_t ID_Filter_Open(void);
+
+/**
+ * @brief  Saves the counters, stamps the filter clean and frees it.
+ */
+void ID_Filter_Close(void);
+
+/**
+ * @brief  Stamps an unchanged filter file with the current generation.
+ *
+ * @details
+ * - Lets other processes load the filter after a change that
+ *   left the IDs alone, instead of rebuilding it.
+ * - Does nothing if the filter is not loaded or changed since it
+ *   was saved; ID_Filter_Close saves it then.
+ */
+void ID_Filter_Flush(void);
+
+/**
+ * @brief  Frees the counters without saving them.
+ */
+void ID_Filter_Discard(void);
+
+/**
+ * @brief  Rebuilds the filter from the active records of the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t ID_Filter_Rebuild(void);
+
+/**
+ * @brief  Counts an ID that became active.
+ *
+ * @param  id Student unique ID.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t ID_Filter_Add(uint32_t id);
+
+/**
+ * @brief  Uncounts an ID that is no longer active.
+ *
+ * @details
+ * - Only IDs counted by ID_Filter_Add or a rebuild may be removed,
+ *   otherwise other IDs could be reported absent.
+ *
+ * @param  id Student unique ID.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t ID_Filter_Remove(uint32_t id);
+
+/**
+ * @brief  Tells whether an ID may be active.
+ *
+ * @details
+ * - false means the ID is certainly not active.
+ * - true means it probably is and must be checked in the ID
+ *   index; also returned when the filter cannot be loaded.
+ *
+ * @param  id Student unique ID.
+ * @return false if the ID is certainly absent, otherwise true.
+ */
+bool ID_Filter_May_Contain(uint32_t id);
+
+#endif // !_ID_Filter_H_
@@ -0,0 +1,672 @@
+#include "ID_Index.h"
+#include "Indexes.h"
+#include "Storage.h"
+#include <string.h>
+
+/* ============================================================
+ *                    On-Disk Layout
+ *
+ *  Page 0 holds the header, every other page holds one node.
+ *  Internal nodes: values[i] is the child holding keys smaller
+ *  than keys[i], values[key_count] holds the rest.
+ *  Leaf nodes: values[i] is the record slot of keys[i] and
+ *  next_leaf chains the leaves in key order.
+ * ============================================================ */
+typedef struct
+{
+    uint32_t magic;                 /* ID_INDEX_MAGIC */
+    uint32_t root_page;             /* Page number of the root node */
+    uint32_t page_count;            /* Pages allocated including header */
+    uint32_t record_count;          /* Database records covered by the index */
+    uint32_t generation;            /* Database generation covered by the index */
+    uint32_t is_clean;              /* 1 when closed after the last change */
+} ID_Index_Header_t;
+
+typedef struct
+{
+    uint32_t is_leaf;
+    uint32_t key_count;
+    uint32_t next_leaf;
+    uint32_t keys[ID_INDEX_ORDER + 1];          /* One spare key for splits */
+    uint32_t values[ID_INDEX_ORDER + 2];
+} ID_Index_Page_t;
+
+typedef struct
+{
+    uint32_t id;
+    uint32_t slot;
+} ID_Index_Entry_t;
+
+static FILE* index_fp = NULL;
+static ID_Index_Header_t index_header;
+
+static F_Return_t Read_Page(uint32_t page_no, ID_Index_Page_t* page)
+{
+    if (fseek(index_fp, (long)(page_no * sizeof(ID_Index_Page_t)), SEEK_SET) != 0)
+        return F_FILE_READ_ERROR;
+    if (fread(page, sizeof(ID_Index_Page_t), 1, index_fp) != 1)
+        return F_FILE_READ_ERROR;
+    return F_OK;
+}
+
+static F_Return_t Write_Page(uint32_t page_no, const ID_Index_Page_t* page)
+{
+    if (fseek(index_fp, (long)(page_no * sizeof(ID_Index_Page_t)), SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(page, sizeof(ID_Index_Page_t), 1, index_fp) != 1)
+        return F_FILE_WRITE_ERROR;
+    return F_OK;
+}
+
+static F_Return_t Write_Header(void)
+{
+    if (fseek(index_fp, 0, SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(&index_header, sizeof(ID_Index_Header_t), 1, index_fp) != 1)
+        return F_FILE_WRITE_ERROR;
+    fflush(index_fp);
+    return F_OK;
+}
+
+static uint32_t Allocate_Page(void)
+{
+    return index_header.page_count++;
+}
+
+/* Index of the first key greater than the given key */
+static uint32_t Upper_Bound(const ID_Index_Page_t* page, uint32_t key)
+{
+    uint32_t low = 0, high = page->key_count;
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+        if (page->keys[mid] <= key)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+/* Index of the first key greater than or equal to the given key */
+static uint32_t Lower_Bound(const ID_Index_Page_t* page, uint32_t key)
+{
+    uint32_t low = 0, high = page->key_count;
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+        if (page->keys[mid] < key)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+/* Walks from the root down to the leaf that may hold the key */
+static F_Return_t Find_Leaf(uint32_t key, uint32_t* page_no, ID_Index_Page_t* page)
+{
+    uint32_t current = index_header.root_page;
+
+    while (1)
+    {
+        F_Return_t status = Read_Page(current, page);
+        if (status != F_OK)
+            return status;
+        if (page->is_leaf)
+            break;
+        current = page->values[Upper_Bound(page, key)];
+    }
+
+    *page_no = current;
+    return F_OK;
+}
+
+/**
+ * @brief  Inserts a key below the given page, splitting on overflow.
+ *
+ * @details
+ * - On a split the new right sibling and its separator key are
+ *   returned so the caller can link them into the parent.
+ */
+static F_Return_t Insert_Into(uint32_t page_no, uint32_t key, uint32_t value,
+                              uint8_t* split, uint32_t* split_key, uint32_t* split_page)
+{
+    ID_Index_Page_t page;
+    ID_Index_Page_t right;
+    F_Return_t status;
+    uint32_t pos;
+
+    *split = 0;
+    status = Read_Page(page_no, &page);
+    if (status != F_OK)
+        return status;
+
+    if (page.is_leaf)
+    {
+        pos = Lower_Bound(&page, key);
+        if (pos < page.key_count && page.keys[pos] == key)
+        {
+            page.values[pos] = value;   /* Existing key: replace slot */
+            return Write_Page(page_no, &page);
+        }
+
+        memmove(&page.keys[pos + 1], &page.keys[pos], (page.key_count - pos) * sizeof(uint32_t));
+        memmove(&page.values[pos + 1], &page.values[pos], (page.key_count - pos) * sizeof(uint32_t));
+        page.keys[pos] = key;
+        page.values[pos] = value;
+        page.key_count++;
+
+        if (page.key_count > ID_INDEX_ORDER)
+        {
+            uint32_t half = page.key_count / 2;
+
+            my_memset(&right, 0, sizeof(right));
+            right.is_leaf = 1;
+            right.key_count = page.key_count - half;
+            memcpy(right.keys, &page.keys[half], right.key_count * sizeof(uint32_t));
+            memcpy(right.values, &page.values[half], right.key_count * sizeof(uint32_t));
+            right.next_leaf = page.next_leaf;
+
+            page.key_count = half;
+            *split_page = Allocate_Page();
+            page.next_leaf = *split_page;
+            *split_key = right.keys[0];
+            *split = 1;
+
+            status = Write_Page(*split_page, &right);
+            if (status != F_OK)
+                return status;
+        }
+        return Write_Page(page_no, &page);
+    }
+
+    /* ---------- Internal node ---------- */
+    uint8_t child_split = 0;
+    uint32_t child_key = 0, child_page = 0;
+
+    pos = Upper_Bound(&page, key);
+    status = Insert_Into(page.values[pos], key, value, &child_split, &child_key, &child_page);
+    if (status != F_OK || !child_split)
+        return status;
+
+    memmove(&page.keys[pos + 1], &page.keys[pos], (page.key_count - pos) * sizeof(uint32_t));
+    memmove(&page.values[pos + 2], &page.values[pos + 1], (page.key_count - pos) * sizeof(uint32_t));
+    page.keys[pos] = child_key;
+    page.values[pos + 1] = child_page;
+    page.key_count++;
+
+    if (page.key_count > ID_INDEX_ORDER)
+    {
+        uint32_t mid = page.key_count / 2;
+
+        my_memset(&right, 0, sizeof(right));
+        right.is_leaf = 0;
+        right.key_count = page.key_count - mid - 1;
+        memcpy(right.keys, &page.keys[mid + 1], right.key_count * sizeof(uint32_t));
+        memcpy(right.values, &page.values[mid + 1], (right.key_count + 1) * sizeof(uint32_t));
+
+        *split_key = page.keys[mid];
+        page.key_count = mid;
+        *split_page = Allocate_Page();
+        *split = 1;
+
+        status = Write_Page(*split_page, &right);
+        if (status != F_OK)
+            return status;
+    }
+    return Write_Page(page_no, &page);
+}
+
+static int Compare_Entries(const void* a, const void* b)
+{
+    const ID_Index_Entry_t* x = a;
+    const ID_Index_Entry_t* y = b;
+
+    if (x->id != y->id)
+        return (x->id < y->id) ? -1 : 1;
+    if (x->slot != y->slot)
+        return (x->slot < y->slot) ? -1 : 1;
+    return 0;
+}
+
+/* Collects (id, slot) of every active record in the database file */
+static F_Return_t Collect_Entries(ID_Index_Entry_t** entries, uint32_t* count, uint32_t* record_count)
+{
+    Student_t buffer[256];
+    uint32_t capacity = 1024;
+    uint32_t got;
+    F_Return_t status;
+
+    status = Storage_Record_Count(record_count);
+    if (status != F_OK)
+        return status;
+
+    *count = 0;
+    *entries = malloc(capacity * sizeof(ID_Index_Entry_t));
+    if (!*entries)
+        return F_NOT_OK;
+
+    for (uint32_t slot = 0; slot < *record_count; slot += got)
+    {
+        status = Storage_Read_Batch(slot, 256, buffer, &got);
+        if (status != F_OK || got == 0)
+            break;
+
+        for (uint32_t i = 0; i < got; i++)
+        {
+            if (!buffer[i].is_active)
+                continue;
+
+            if (*count == capacity)
+            {
+                ID_Index_Entry_t* grown = realloc(*entries, 2 * capacity * sizeof(ID_Index_Entry_t));
+                if (!grown)
+                {
+                    free(*entries);
+                    return F_NOT_OK;
+                }
+                *entries = grown;
+                capacity *= 2;
+            }
+            (*entries)[*count].id = buffer[i].id;
+            (*entries)[*count].slot = slot + i;
+            (*count)++;
+        }
+    }
+
+    if (status != F_OK)
+        free(*entries);
+    return status;
+}
+
+/**
+ * @brief  Rebuilds the index from scratch out of the database file.
+ *
+ * @details
+ * - Collects (id, slot) pairs of all active records.
+ * - Sorts them and bulk-loads the tree bottom-up.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t ID_Index_Rebuild(void)
+{
+    ID_Index_Entry_t* entries = NULL;
+    uint32_t entry_count = 0, record_count = 0;
+    F_Return_t status;
+
+    status = Collect_Entries(&entries, &entry_count, &record_count);
+    if (status != F_OK)
+        return status;
+
+    /* Sort by ID, then slot, and keep the first active record of each ID */
+    qsort(entries, entry_count, sizeof(ID_Index_Entry_t), Compare_Entries);
+    uint32_t unique = 0;
+    for (uint32_t i = 0; i < entry_count; i++)
+    {
+        if (unique == 0 || entries[unique - 1].id != entries[i].id)
+            entries[unique++] = entries[i];
+    }
+
+    if (index_fp)
+        fclose(index_fp);
+    index_fp = fopen(ID_INDEX_FILE_NAME, "wb+");
+    if (!index_fp)
+    {
+        free(entries);
+        return F_FILE_OPEN_ERROR;
+    }
+
+    my_memset(&index_header, 0, sizeof(index_header));
+    index_header.magic = ID_INDEX_MAGIC;
+    index_header.page_count = 1;
+
+    /* ---------- Leaf level ---------- */
+    uint32_t level_count = (unique + ID_INDEX_FILL - 1) / ID_INDEX_FILL;
+    if (level_count == 0)
+        level_count = 1;
+
+    /* First key and page of every node on the level being built */
+    ID_Index_Entry_t* level = malloc(level_count * sizeof(ID_Index_Entry_t));
+    if (!level)
+    {
+        free(entries);
+        return F_NOT_OK;
+    }
+
+    ID_Index_Page_t page;
+    for (uint32_t n = 0; n < level_count; n++)
+    {
+        uint32_t first = n * ID_INDEX_FILL;
+        uint32_t take = (unique - first < ID_INDEX_FILL) ? unique - first : ID_INDEX_FILL;
+
+        my_memset(&page, 0, sizeof(page));
+        page.is_leaf = 1;
+        page.key_count = take;
+        for (uint32_t k = 0; k < take; k++)
+        {
+            page.keys[k] = entries[first + k].id;
+            page.values[k] = entries[first + k].slot;
+        }
+
+        level[n].slot = Allocate_Page();
+        level[n].id = take ? page.keys[0] : 0;
+        page.next_leaf = (n + 1 < level_count) ? level[n].slot + 1 : ID_INDEX_NO_PAGE;
+        status = Write_Page(level[n].slot, &page);
+        if (status != F_OK)
+            break;
+    }
+    free(entries);
+
+    /* ---------- Internal levels ---------- */
+    while (status == F_OK && level_count > 1)
+    {
+        uint32_t parents = (level_count + ID_INDEX_FILL) / (ID_INDEX_FILL + 1);
+
+        for (uint32_t n = 0; n < parents && status == F_OK; n++)
+        {
+            uint32_t first = n * (ID_INDEX_FILL + 1);
+            uint32_t take = (level_count - first < ID_INDEX_FILL + 1) ? level_count - first : ID_INDEX_FILL + 1;
+
+            my_memset(&page, 0, sizeof(page));
+            page.is_leaf = 0;
+            page.key_count = take - 1;
+            page.values[0] = level[first].slot;
+            for (uint32_t k = 1; k < take; k++)
+            {
+                page.keys[k - 1] = level[first + k].id;
+                page.values[k] = level[first + k].slot;
+            }
+
+            /* Parent n overwrites entry n, which was already consumed */
+            level[n].id = level[first].id;
+            level[n].slot = Allocate_Page();
+            status = Write_Page(level[n].slot, &page);
+        }
+        level_count = parents;
+    }
+
+    index_header.root_page = level[0].slot;
+    free(level);
+    if (status != F_OK)
+        return status;
+
+    index_header.record_count = record_count;
+    Storage_Get_Generation(&index_header.generation);
+    index_header.is_clean = 1;
+    status = Write_Header();
+
+    /* Other processes still hold the old file open */
+    if (status == F_OK)
+        status = Storage_Touch();
+    return status;
+}
+
+/**
+ * @brief  Opens the ID index, rebuilding it when needed.
+ *
+ * @details
+ * - Opens the index file if it is not already open.
+ * - Rebuilds the tree from the database file when the index is
+ *   missing, corrupted, was not closed cleanly, or was built for
+ *   a different generation of the database.
+ *
+ * @return F_OK if the index is ready, otherwise error code.
+ */
+F_Return_t ID_Index_Open(void)
+{
+    uint32_t record_count = 0;
+    uint32_t generation = 0;
+
+    if (index_fp)
+        return F_OK;
+
+    if (Storage_Record_Count(&record_count) != F_OK ||
+        Storage_Get_Generation(&generation) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    index_fp = fopen(ID_INDEX_FILE_NAME, "rb+");
+    if (index_fp)
+    {
+        if (fread(&index_header, sizeof(ID_Index_Header_t), 1, index_fp) == 1 &&
+            index_header.magic == ID_INDEX_MAGIC &&
+            index_header.is_clean &&
+            index_header.record_count == record_count &&
+            index_header.generation == generation)
+        {
+            return F_OK;
+        }
+        printf("Student ID index is stale, rebuilding...\n");
+    }
+
+    return ID_Index_Rebuild();
+}
+
+/**
+ * @brief  Flushes the index header and closes the index file.
+ *
+ * @details
+ * - Marks the index as clean so the next open can trust it.
+ */
+void ID_Index_Close(void)
+{
+    if (!index_fp)
+        return;
+
+    ID_Index_Flush();
+    fclose(index_fp);
+    index_fp = NULL;
+}
+
+/**
+ * @brief  Stamps the index clean without closing it.
+ *
+ * @details
+ * - Lets other processes open the index as it stands instead of
+ *   rebuilding it; the next change marks it dirty again.
+ * - Does nothing if the index is not open.
+ */
+void ID_Index_Flush(void)
+{
+    if (!index_fp)
+        return;
+
+    if (Storage_Record_Count(&index_header.record_count) == F_OK &&
+        Storage_Get_Generation(&index_header.generation) == F_OK)
+    {
+        index_header.is_clean = 1;
+        Write_Header();
+    }
+}
+
+/**
+ * @brief  Closes the index file without writing to it.
+ */
+void ID_Index_Discard(void)
+{
+    if (!index_fp)
+        return;
+
+    fclose(index_fp);
+    index_fp = NULL;
+}
+
+/**
+ * @brief  Looks up the record slot of an active student ID.
+ *
+ * @param  id   Student unique ID.
+ * @param  slot Pointer to store the record slot.
+ * @return F_OK if the ID is indexed, otherwise F_ID_NOT_FOUND.
+ */
+F_Return_t ID_Index_Find(uint32_t id, uint32_t* slot)
+{
+    ID_Index_Page_t page;
+    uint32_t page_no;
+    F_Return_t status;
+
+    if (!slot)
+        return F_NOT_OK;
+
+    status = ID_Index_Open();
+    if (status != F_OK)
+        return status;
+
+    status = Find_Leaf(id, &page_no, &page);
+    if (status != F_OK)
+        return status;
+
+    uint32_t pos = Lower_Bound(&page, id);
+    if (pos < page.key_count && page.keys[pos] == id)
+    {
+        *slot = page.values[pos];
+        return F_OK;
+    }
+    return F_ID_NOT_FOUND;
+}
+
+/**
+ * @brief  Looks up the record slots of many IDs in one pass.
+ *
+ * @details
+ * - Visits the IDs in ascending order, so IDs sharing a leaf
+ *   cost one descent and one leaf read between them.
+ *
+ * @param  ids   IDs to look up, in any order.
+ * @param  count Number of IDs.
+ * @param  slots Array of count slots, ID_INDEX_NO_SLOT for an ID not indexed.
+ * @return F_OK if the lookups ran, otherwise error code.
+ */
+F_Return_t ID_Index_Find_Many(const uint32_t* ids, uint32_t count, uint32_t* slots)
+{
+    ID_Index_Page_t page;
+    ID_Index_Entry_t* order;
+    uint32_t page_no;
+    bool have_leaf = false;
+    F_Return_t status;
+
+    if (!ids || !slots)
+        return F_NOT_OK;
+    if (count == 0)
+        return F_OK;
+
+    status = ID_Index_Open();
+    if (status != F_OK)
+        return status;
+
+    /* The slot field carries the position of the ID in the request */
+    order = malloc(count * sizeof(ID_Index_Entry_t));
+    if (!order)
+        return F_NOT_OK;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        order[i].id = ids[i];
+        order[i].slot = i;
+    }
+    qsort(order, count, sizeof(ID_Index_Entry_t), Compare_Entries);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t id = order[i].id;
+
+        /* Keys up to the last one of the current leaf belong to it */
+        if (!have_leaf || page.key_count == 0 || id > page.keys[page.key_count - 1])
+        {
+            status = Find_Leaf(id, &page_no, &page);
+            if (status != F_OK)
+                break;
+            have_leaf = true;
+        }
+
+        uint32_t pos = Lower_Bound(&page, id);
+        slots[order[i].slot] = (pos < page.key_count && page.keys[pos] == id) ? page.values[pos] : ID_INDEX_NO_SLOT;
+    }
+
+    free(order);
+    return status;
+}
+
+/**
+ * @brief  Inserts or replaces the slot mapped to an ID.
+ *
+ * @param  id   Student unique ID.
+ * @param  slot Record slot inside the database file.
+ * @return F_OK if the index was updated, otherwise error code.
+ */
+F_Return_t ID_Index_Insert(uint32_t id, uint32_t slot)
+{
+    uint8_t split = 0;
+    uint32_t split_key = 0, split_page = 0;
+    uint32_t page_count;
+    F_Return_t status;
+
+    status = ID_Index_Open();
+    if (status != F_OK)
+        return status;
+
+    status = Indexes_Mark_Dirty(index_fp, ID_INDEX_FILE_NAME, &index_header, sizeof(ID_Index_Header_t), &index_header.is_clean);
+    if (status != F_OK)
+        return status;
+
+    page_count = index_header.page_count;
+    status = Insert_Into(index_header.root_page, id, slot, &split, &split_key, &split_page);
+    if (status != F_OK)
+        return status;
+
+    if (split)
+    {
+        /* Root was split: grow the tree by one level */
+        ID_Index_Page_t root;
+        my_memset(&root, 0, sizeof(root));
+        root.is_leaf = 0;
+        root.key_count = 1;
+        root.keys[0] = split_key;
+        root.values[0] = index_header.root_page;
+        root.values[1] = split_page;
+
+        index_header.root_page = Allocate_Page();
+        status = Write_Page(index_header.root_page, &root);
+        if (status != F_OK)
+            return status;
+    }
+
+    /* The header only changes when pages were allocated */
+    return (index_header.page_count != page_count) ? Write_Header() : F_OK;
+}
+
+/**
+ * @brief  Removes an ID from the index.
+ *
+ * @details
+ * - The key is removed from its leaf without merging pages;
+ *   underfull pages are compacted by the next rebuild.
+ *
+ * @param  id Student unique ID.
+ * @return F_OK if the ID was removed, otherwise F_ID_NOT_FOUND.
+ */
+F_Return_t ID_Index_Remove(uint32_t id)
+{
+    ID_Index_Page_t page;
+    uint32_t page_no;
+    F_Return_t status;
+
+    status = ID_Index_Open();
+    if (status != F_OK)
+        return status;
+
+    status = Find_Leaf(id, &page_no, &page);
+    if (status != F_OK)
+        return status;
+
+    uint32_t pos = Lower_Bound(&page, id);
+    if (pos >= page.key_count || page.keys[pos] != id)
+        return F_ID_NOT_FOUND;
+
+    status = Indexes_Mark_Dirty(index_fp, ID_INDEX_FILE_NAME, &index_header, sizeof(ID_Index_Header_t), &index_header.is_clean);
+    if (status != F_OK)
+        return status;
+
+    memmove(&page.keys[pos], &page.keys[pos + 1], (page.key_count - pos - 1) * sizeof(uint32_t));
+    memmove(&page.values[pos], &page.values[pos + 1], (page.key_count - pos - 1) * sizeof(uint32_t));
+    page.key_count--;
+    return Write_Page(page_no, &page);
+}
@@ -0,0 +1,118 @@
+#ifndef _ID_Index_H_
+#define _ID_Index_H_
+
+/* ============================================================
+ *  Student ID Primary Index
+ *
+ *  Description:
+ *  Persistent B+tree that maps every active student ID to the
+ *  slot (record number) of its Student_t inside the database
+ *  file. The tree lives in its own paged file next to the
+ *  database so point lookups cost O(log N) page reads instead
+ *  of a full scan of the data file.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define ID_INDEX_FILE_NAME     "Students_Information.idx"
+#define ID_INDEX_MAGIC         0x58444953UL    /* "SIDX" */
+#define ID_INDEX_ORDER         64              /* Max keys per page */
+#define ID_INDEX_FILL          48              /* Keys per page on rebuild */
+#define ID_INDEX_NO_PAGE       0               /* Page 0 holds the header */
+#define ID_INDEX_NO_SLOT       0xFFFFFFFFUL    /* Slot reported for an ID not indexed */
+
+/**
+ * @brief  Opens the ID index, rebuilding it when needed.
+ *
+ * @details
+ * - Opens the index file if it is not already open.
+ * - Rebuilds the tree from the database file when the index is
+ *   missing, corrupted, was not closed cleanly, or was built for
+ *   a different generation of the database.
+ *
+ * @return F_OK if the index is ready, otherwise error code.
+ */
+F_Return_t ID_Index_Open(void);
+
+/**
+ * @brief  Flushes the index header and closes the index file.
+ *
+ * @details
+ * - Marks the index as clean so the next open can trust it.
+ */
+void ID_Index_Close(void);
+
+/**
+ * @brief  Stamps the index clean without closing it.
+ *
+ * @details
+ * - Lets other processes open the index as it stands instead of
+ *   rebuilding it; the next change marks it dirty again.
+ * - Does nothing if the index is not open.
+ */
+void ID_Index_Flush(void);
+
+/**
+ * @brief  Closes the index file without writing to it.
+ */
+void ID_Index_Discard(void);
+
+/**
+ * @brief  Rebuilds the index from scratch out of the database file.
+ *
+ * @details
+ * - Collects (id, slot) pairs of all active records.
+ * - Sorts them and bulk-loads the tree bottom-up.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t ID_Index_Rebuild(void);
+
+/**
+ * @brief  Looks up the record slot of an active student ID.
+ *
+ * @param  id   Student unique ID.
+ * @param  slot Pointer to store the record slot.
+ * @return F_OK if the ID is indexed, otherwise F_ID_NOT_FOUND.
+ */
+F_Return_t ID_Index_Find(uint32_t id, uint32_t* slot);
+
+/**
+ * @brief  Looks up the record slots of many IDs in one pass.
+ *
+ * @details
+ * - Visits the IDs in ascending order, so IDs sharing a leaf
+ *   cost one descent and one leaf read between them.
+ *
+ * @param  ids   IDs to look up, in any order.
+ * @param  count Number of IDs.
+ * @param  slots Array of count slots, ID_INDEX_NO_SLOT for an ID not indexed.
+ * @return F_OK if the lookups ran, otherwise error code.
+ */
+F_Return_t ID_Index_Find_Many(const uint32_t* ids, uint32_t count, uint32_t* slots);
+
+/**
+ * @brief  Inserts or replaces the slot mapped to an ID.
+ *
+ * @param  id   Student unique ID.
+ * @param  slot Record slot inside the database file.
+ * @return F_OK if the index was updated, otherwise error code.
+ */
+F_Return_t ID_Index_Insert(uint32_t id, uint32_t slot);
+
+/**
+ * @brief  Removes an ID from the index.
+ *
+ * @details
+ * - The key is removed from its leaf without merging pages;
+ *   underfull pages are compacted by the next rebuild.
+ *
+ * @param  id Student unique ID.
+ * @return F_OK if the ID was removed, otherwise F_ID_NOT_FOUND.
+ */
+F_Return_t ID_Index_Remove(uint32_t id);
+
+#endif // !_ID_Index_H_
@@ -0,0 +1,654 @@
+#include "Import.h"
+#include "Indexes.h"
+#include "Storage.h"
+#include "Csv.h"
+#include "Platform.h"
+
+/* ============================================================
+ *                    Student ID Hash Set
+ *
+ *  Open addressing with linear probing. Slot value 0 marks an
+ *  empty bucket, so ID 0 is tracked by a separate flag.
+ * ============================================================ */
+typedef struct
+{
+    uint32_t* table;
+    uint32_t capacity;          /* Always a power of two */
+    uint32_t count;
+    bool has_zero;
+} Id_Set_t;
+
+static uint32_t Id_Hash(uint32_t id, uint32_t capacity)
+{
+    return (uint32_t)((id * 2654435761UL) & (capacity - 1));
+}
+
+static F_Return_t Id_Set_Init(Id_Set_t* set, uint32_t expected)
+{
+    set->capacity = 1024;
+    while (set->capacity < 2 * expected)
+        set->capacity *= 2;
+
+    set->table = calloc(set->capacity, sizeof(uint32_t));
+    set->count = 0;
+    set->has_zero = false;
+    return (set->table) ? F_OK : F_NOT_OK;
+}
+
+static void Id_Set_Free(Id_Set_t* set)
+{
+    free(set->table);
+    set->table = NULL;
+}
+
+static bool Id_Set_Contains(const Id_Set_t* set, uint32_t id)
+{
+    if (id == 0)
+        return set->has_zero;
+
+    for (uint32_t i = Id_Hash(id, set->capacity); set->table[i] != 0; i = (i + 1) & (set->capacity - 1))
+    {
+        if (set->table[i] == id)
+            return true;
+    }
+    return false;
+}
+
+static F_Return_t Id_Set_Add(Id_Set_t* set, uint32_t id)
+{
+    if (id == 0)
+    {
+        set->has_zero = true;
+        return F_OK;
+    }
+
+    /* Keep the load factor at or below one half */
+    if (2 * (set->count + 1) > set->capacity)
+    {
+        Id_Set_t grown;
+        grown.capacity = 2 * set->capacity;
+        grown.table = calloc(grown.capacity, sizeof(uint32_t));
+        if (!grown.table)
+            return F_NOT_OK;
+        grown.count = 0;
+        grown.has_zero = set->has_zero;
+
+        for (uint32_t i = 0; i < set->capacity; i++)
+        {
+            if (set->table[i] != 0)
+                Id_Set_Add(&grown, set->table[i]);
+        }
+        free(set->table);
+        *set = grown;
+    }
+
+    uint32_t i = Id_Hash(id, set->capacity);
+    while (set->table[i] != 0)
+    {
+        if (set->table[i] == id)
+            return F_OK;
+        i = (i + 1) & (set->capacity - 1);
+    }
+    set->table[i] = id;
+    set->count++;
+    return F_OK;
+}
+
+/* Collects every active ID of the database with batched reads */
+static F_Return_t Load_Existing_Ids(Id_Set_t* set, Student_t* buffer)
+{
+    uint32_t record_count, live, dead, got;
+    F_Return_t status;
+
+    status = Storage_Get_Counts(&live, &dead);
+    if (status != F_OK)
+        return status;
+    status = Id_Set_Init(set, live);
+    if (status != F_OK)
+        return status;
+
+    Storage_Record_Count(&record_count);
+    for (uint32_t slot = 0; slot < record_count; slot += got)
+    {
+        status = Storage_Read_Batch(slot, IMPORT_BATCH_RECORDS, buffer, &got);
+        if (status != F_OK || got == 0)
+            break;
+
+        for (uint32_t i = 0; i < got; i++)
+        {
+            if (buffer[i].is_active)
+                Id_Set_Add(set, buffer[i].id);
+        }
+    }
+    return status;
+}
+
+/* Copies a name field, truncated to fit like the interactive entry */
+static void Copy_Name(char* name, Csv_Span_t span)
+{
+    uint32_t length = (span.length < MAX_NAME_LENGTH - 1) ? span.length : MAX_NAME_LENGTH - 1;
+
+    my_memcpy(name, span.data, length);
+    name[length] = '\0';
+}
+
+/**
+ * @brief  Fills a student from the fields of one CSV record.
+ *
+ * @details
+ * - Record layout: ID, first name, last name, GPA, course count,
+ *   then one field per course. Empty fields at the end of the
+ *   record are ignored.
+ * - Touches no shared state, so parse threads call it at once.
+ *
+ * @return Import_Error_t bits, 0 if the student is valid apart from
+ *         the duplicate ID check.
+ */
+static uint32_t Parse_Student(const Csv_Record_t* record, Student_t* student)
+{
+    uint32_t count = record->count;
+    uint32_t expected_courses = 0;
+    uint32_t valid_courses_count = 0;
+    uint32_t errors = 0;
+
+    my_memset(student, 0, sizeof(Student_t));
+    student->is_active = 1;
+
+    while (count > 5 && count <= CSV_MAX_FIELDS && record->fields[count - 1].length == 0)
+        count--;
+    if (count < 5)
+        return IMPORT_ERROR_FORMAT;
+
+    /* ---------- ID and names ---------- */
+    if (!Csv_Parse_U32(record->fields[0], &student->id))
+        return IMPORT_ERROR_ID;
+    if (record->fields[1].length == 0 || record->fields[2].length == 0)
+        errors |= IMPORT_ERROR_NAME;
+    Copy_Name(student->first_name, record->fields[1]);
+    Copy_Name(student->last_name, record->fields[2]);
+
+    /* ---------- GPA ---------- */
+    if (!Csv_Parse_Float(record->fields[3], &student->GPA) || student->GPA < 0.0f || student->GPA > 4.0f)
+        errors |= IMPORT_ERROR_GPA;
+
+    /* ---------- Expected Course Count ---------- */
+    if (!Csv_Parse_U32(record->fields[4], &expected_courses) || expected_courses == 0 || expected_courses > MAX_COURSES)
+        errors |= IMPORT_ERROR_COURSE_COUNT;
+
+    /* ---------- Courses ---------- */
+    if (count > CSV_MAX_FIELDS)
+    {
+        errors |= IMPORT_ERROR_TOO_MANY_COURSES;
+        count = CSV_MAX_FIELDS;
+    }
+    for (uint32_t f = 5; f < count; f++)
+    {
+        uint32_t course_id = 0;
+
+        /* Skip invalid range */
+        if (!Csv_Parse_U32(record->fields[f], &course_id) || course_id < 1 || course_id > MAX_COURSE_ID)
+        {
+            errors |= IMPORT_ERROR_COURSE_ID;
+            continue;
+        }
+
+        /* Skip duplicate course in this student */
+        int duplicate = 0;
+        for (uint32_t i = 0; i < valid_courses_count; i++)
+        {
+            if (student->courses[i] == course_id)
+            {
+                duplicate = 1;
+                break;
+            }
+        }
+        if (duplicate)
+        {
+            errors |= IMPORT_ERROR_DUPLICATE_COURSE;
+            continue;
+        }
+
+        /* Add course if valid */
+        if (valid_courses_count < MAX_COURSES)
+            student->courses[valid_courses_count++] = (uint8_t)course_id;
+        else
+            errors |= IMPORT_ERROR_TOO_MANY_COURSES;
+    }
+    student->course_count = (uint8_t)valid_courses_count;
+
+    if (!(errors & IMPORT_ERROR_COURSE_COUNT) && student->course_count != expected_courses)
+        errors |= IMPORT_ERROR_COUNT_MISMATCH;
+    return errors;
+}
+
+/* ============================================================
+ *                    Parse Tasks
+ *
+ *  A chunk holds whole records of the file. A parse thread turns
+ *  it into valid students and rejects, with lines counted from
+ *  the start of the chunk; the writer adds the lines of the
+ *  chunks before it.
+ * ============================================================ */
+typedef struct
+{
+    char* text;                         /* Whole records, then the start of the next chunk */
+    size_t capacity;
+    size_t length;                      /* Bytes of whole records */
+    size_t filled;                      /* Bytes read */
+    Student_t* students;                /* Valid students, in file order */
+    uint32_t* student_lines;            /* Line of every student */
+    uint32_t student_count;
+    uint32_t student_capacity;
+    Import_Reject_t* rejects;           /* Invalid records, in file order */
+    uint32_t reject_count;
+    uint32_t reject_capacity;
+    uint64_t lines;                     /* Lines in the chunk */
+    bool out_of_memory;
+} Import_Chunk_t;
+
+static void Chunk_Free(Import_Chunk_t* chunk)
+{
+    free(chunk->text);
+    free(chunk->students);
+    free(chunk->student_lines);
+    free(chunk->rejects);
+    my_memset(chunk, 0, sizeof(Import_Chunk_t));
+}
+
+static bool Chunk_Add_Student(Import_Chunk_t* chunk, const Student_t* student, uint32_t line)
+{
+    if (chunk->student_count == chunk->student_capacity)
+    {
+        uint32_t capacity = (chunk->student_capacity) ? 2 * chunk->student_capacity : IMPORT_BATCH_RECORDS;
+        Student_t* students = realloc(chunk->students, capacity * sizeof(Student_t));
+        if (students)
+            chunk->students = students;
+        uint32_t* lines = realloc(chunk->student_lines, capacity * sizeof(uint32_t));
+        if (lines)
+            chunk->student_lines = lines;
+        if (!students || !lines)
+            return false;
+        chunk->student_capacity = capacity;
+    }
+
+    chunk->students[chunk->student_count] = *student;
+    chunk->student_lines[chunk->student_count++] = line;
+    return true;
+}
+
+static bool Chunk_Add_Reject(Import_Chunk_t* chunk, uint64_t line, uint32_t id, uint32_t errors)
+{
+    if (chunk->reject_count == chunk->reject_capacity)
+    {
+        uint32_t capacity = (chunk->reject_capacity) ? 2 * chunk->reject_capacity : 256;
+        Import_Reject_t* rejects = realloc(chunk->rejects, capacity * sizeof(Import_Reject_t));
+        if (!rejects)
+            return false;
+        chunk->rejects = rejects;
+        chunk->reject_capacity = capacity;
+    }
+
+    chunk->rejects[chunk->reject_count].line = line;
+    chunk->rejects[chunk->reject_count].id = id;
+    chunk->rejects[chunk->reject_count++].errors = errors;
+    return true;
+}
+
+/* Parse task: splits and validates every record of a chunk */
+static void Parse_Chunk(void* argument)
+{
+    Import_Chunk_t* chunk = argument;
+    Csv_Record_t record;
+    Student_t student;
+    size_t pos = 0;
+    size_t consumed;
+
+    chunk->student_count = 0;
+    chunk->reject_count = 0;
+    chunk->lines = 0;
+    chunk->out_of_memory = false;
+
+    while (pos < chunk->length &&
+           Csv_Split(chunk->text + pos, chunk->length - pos, true, &record, &consumed) == CSV_RECORD)
+    {
+        uint32_t line = (uint32_t)chunk->lines + 1;
+
+        pos += consumed;
+        chunk->lines += record.lines;
+        if (record.count == 1 && record.fields[0].length == 0)
+            continue;   /* Empty line */
+
+        uint32_t errors = Parse_Student(&record, &student);
+        bool added = (errors) ? Chunk_Add_Reject(chunk, line, student.id, errors)
+                              : Chunk_Add_Student(chunk, &student, line);
+        if (!added)
+        {
+            chunk->out_of_memory = true;
+            return;
+        }
+    }
+}
+
+/*
+ * Fills a chunk with whole records: the bytes the previous chunk
+ * read past its records, then more of the file. A record longer
+ * than the buffer grows it.
+ */
+static F_Return_t Read_Chunk(FILE* fp, const Import_Chunk_t* previous, Import_Chunk_t* chunk, bool* at_end)
+{
+    size_t carried = (previous) ? previous->filled - previous->length : 0;
+
+    if (chunk->capacity < IMPORT_CHUNK_SIZE || chunk->capacity < 2 * carried)
+    {
+        size_t capacity = (2 * carried > IMPORT_CHUNK_SIZE) ? 2 * carried : IMPORT_CHUNK_SIZE;
+        char* text = realloc(chunk->text, capacity);
+        if (!text)
+            return F_NOT_OK;
+        chunk->text = text;
+        chunk->capacity = capacity;
+    }
+    if (carried > 0)
+        my_memcpy(chunk->text, previous->text + previous->length, (uint32_t)carried);
+    chunk->filled = carried;
+    chunk->length = 0;
+
+    while (!*at_end)
+    {
+        size_t got = fread(chunk->text + chunk->filled, 1, chunk->capacity - chunk->filled, fp);
+        chunk->filled += got;
+        if (got == 0)
+        {
+            if (ferror(fp))
+                return F_FILE_READ_ERROR;
+            *at_end = true;
+            break;
+        }
+        if (chunk->filled < chunk->capacity)
+            continue;
+
+        chunk->length = Csv_Complete_Length(chunk->text, chunk->filled);
+        if (chunk->length > 0)
+            return F_OK;
+
+        /* Not even one whole record yet */
+        char* text = realloc(chunk->text, 2 * chunk->capacity);
+        if (!text)
+            return F_NOT_OK;
+        chunk->text = text;
+        chunk->capacity *= 2;
+    }
+
+    /* The last record of the file needs no line break */
+    chunk->length = chunk->filled;
+    return F_OK;
+}
+
+/* ============================================================
+ *                    Ordered Writer
+ * ============================================================ */
+typedef struct
+{
+    Id_Set_t ids;                       /* Active IDs and IDs imported so far */
+    uint32_t* slots;                    /* Slots of the batch written last */
+    Student_t* first;                   /* First students imported, indexed at the end */
+    uint32_t* first_slots;
+    uint64_t base_line;                 /* Lines in the chunks written */
+    FILE* reject_fp;                    /* Reject file, NULL for none */
+    Import_Report_t report;
+} Import_Writer_t;
+
+/* Reasons of the reject file and the summary, lowest bit first */
+static const char* const Error_Names[IMPORT_ERROR_KINDS] =
+{
+    "incomplete record", "invalid ID", "missing name", "invalid GPA",
+    "invalid course count", "invalid course ID", "duplicate course",
+    "too many courses", "course count mismatch", "duplicate ID"
+};
+
+/* Counts a rejected record and appends it to the reject file */
+static void Report_Reject(Import_Writer_t* writer, uint64_t line, uint32_t id, uint32_t errors)
+{
+    const char* separator = "";
+
+    writer->report.rejected++;
+    for (uint32_t bit = 0; bit < IMPORT_ERROR_KINDS; bit++)
+    {
+        if (errors & (1UL << bit))
+            writer->report.error_counts[bit]++;
+    }
+    if (!writer->reject_fp)
+        return;
+
+    fprintf(writer->reject_fp, "%llu,%u,%u,", (unsigned long long)(writer->base_line + line), (unsigned)id, (unsigned)errors);
+    for (uint32_t bit = 0; bit < IMPORT_ERROR_KINDS; bit++)
+    {
+        if (errors & (1UL << bit))
+        {
+            fputs(separator, writer->reject_fp);
+            fputs(Error_Names[bit], writer->reject_fp);
+            separator = ";";
+        }
+    }
+    fputc('\n', writer->reject_fp);
+}
+
+/* Writes a parsed chunk: rejects duplicate IDs, then stores the rest */
+static F_Return_t Write_Chunk(Import_Writer_t* writer, Import_Chunk_t* chunk)
+{
+    uint32_t kept = 0;
+    uint32_t r = 0;
+
+    if (chunk->out_of_memory)
+        return F_NOT_OK;
+
+    /* ---------- Check Duplicate IDs (database and file so far), in file order ---------- */
+    for (uint32_t i = 0; i < chunk->student_count; i++)
+    {
+        for (; r < chunk->reject_count && chunk->rejects[r].line < chunk->student_lines[i]; r++)
+            Report_Reject(writer, chunk->rejects[r].line, chunk->rejects[r].id, chunk->rejects[r].errors);
+
+        if (Id_Set_Contains(&writer->ids, chunk->students[i].id))
+        {
+            Report_Reject(writer, chunk->student_lines[i], chunk->students[i].id, IMPORT_ERROR_DUPLICATE_ID);
+            continue;
+        }
+        Id_Set_Add(&writer->ids, chunk->students[i].id);
+        chunk->students[kept++] = chunk->students[i];
+    }
+    for (; r < chunk->reject_count; r++)
+        Report_Reject(writer, chunk->rejects[r].line, chunk->rejects[r].id, chunk->rejects[r].errors);
+    writer->base_line += chunk->lines;
+
+    /* ---------- Write Batches ---------- */
+    for (uint32_t done = 0; done < kept; )
+    {
+        uint32_t count = (kept - done < IMPORT_BATCH_RECORDS) ? kept - done : IMPORT_BATCH_RECORDS;
+        F_Return_t status = Storage_Insert_Batch(chunk->students + done, count, writer->slots);
+        if (status == F_OK)
+            status = Storage_Commit();  /* One log sync per batch */
+        if (status != F_OK)
+            return status;
+
+        /* The first batch is indexed record by record if nothing follows it */
+        for (uint32_t i = 0; i < count && writer->report.imported + i < IMPORT_BATCH_RECORDS; i++)
+        {
+            writer->first[writer->report.imported + i] = chunk->students[done + i];
+            writer->first_slots[writer->report.imported + i] = writer->slots[i];
+        }
+        writer->report.imported += count;
+        done += count;
+    }
+    return F_OK;
+}
+
+/* ============================================================
+ *                    Pipeline
+ *
+ *  Two rounds of chunks take turns: while the threads parse one
+ *  round, the calling thread writes the other.
+ * ============================================================ */
+typedef struct
+{
+    Import_Chunk_t chunks[IMPORT_PARALLEL_MAX_THREADS];
+    Platform_Thread_t threads[IMPORT_PARALLEL_MAX_THREADS];
+    bool started[IMPORT_PARALLEL_MAX_THREADS];
+    uint32_t count;                     /* Chunks read in this round */
+} Import_Round_t;
+
+/* Reads the chunks of a round and starts parsing them */
+static F_Return_t Start_Round(FILE* fp, Import_Round_t* round, const Import_Chunk_t* previous,
+                              uint32_t chunk_count, bool* at_end)
+{
+    round->count = 0;
+    while (round->count < chunk_count && !*at_end)
+    {
+        Import_Chunk_t* chunk = &round->chunks[round->count];
+        F_Return_t status = Read_Chunk(fp, previous, chunk, at_end);
+        if (status != F_OK)
+            return status;
+        if (chunk->length == 0)
+            break;
+
+        /* A chunk whose thread cannot be started is parsed when the round ends */
+        round->started[round->count] = IMPORT_PARALLEL_ENABLED && chunk_count > 1 &&
+                                       Platform_Thread_Start(&round->threads[round->count], Parse_Chunk, chunk) == 0;
+        previous = chunk;
+        round->count++;
+    }
+    return F_OK;
+}
+
+static void Finish_Round(Import_Round_t* round)
+{
+    for (uint32_t i = 0; i < round->count; i++)
+    {
+        if (round->started[i])
+            Platform_Thread_Join(&round->threads[i]);
+        else
+            Parse_Chunk(&round->chunks[i]);
+        round->started[i] = false;
+    }
+}
+
+/**
+ * @brief  Imports student records from an external CSV file.
+ *
+ * @details
+ * - Streams the file through the CSV tokenizer, so lines may be
+ *   of any length and fields may be quoted.
+ * - Parses chunks of IMPORT_CHUNK_SIZE on worker threads and
+ *   writes them in file order, so the result is the same as a
+ *   sequential import.
+ * - Writes every rejected record to the reject file, in file
+ *   order, and counts it in the report. Only a summary goes to
+ *   the console.
+ * - Builds the set of active IDs with one pass over the database.
+ * - Rejects IDs already in the database or earlier in the file.
+ * - Writes validated records in batches of IMPORT_BATCH_RECORDS.
+ * - Bulk-rebuilds the indexes once when more than one batch was
+ *   imported, otherwise updates them record by record.
+ *
+ * @param  import_file Path to the external input file.
+ * @param  reject_file Path of the reject file to create, NULL for none.
+ * @param  report      Filled with the import counters, may be NULL.
+ * @return F_OK if all records processed successfully, otherwise error code.
+ */
+F_Return_t Import_From_File(const char* import_file, const char* reject_file, Import_Report_t* report)
+{
+    if (!import_file)
+    {
+        return F_NOT_OK;
+    }
+    FILE* import_fp = fopen(import_file, "rb");
+    if (!import_fp)
+    {
+        return F_FILE_OPEN_ERROR;
+    }
+    /* The chunks are the only read buffers, stdio's would add a copy */
+    setvbuf(import_fp, NULL, _IONBF, 0);
+
+    Import_Writer_t writer = { 0 };
+    if (reject_file)
+    {
+        writer.reject_fp = fopen(reject_file, "w");
+        if (!writer.reject_fp)
+        {
+            fclose(import_fp);
+            return F_FILE_OPEN_ERROR;
+        }
+        setvbuf(writer.reject_fp, NULL, _IOFBF, IMPORT_REJECT_BUFFER_SIZE);
+        fputs("line,id,errors,reasons\n", writer.reject_fp);
+    }
+
+    Import_Round_t* rounds = calloc(2, sizeof(Import_Round_t));
+    writer.slots = malloc(IMPORT_BATCH_RECORDS * sizeof(uint32_t));
+    writer.first = malloc(IMPORT_BATCH_RECORDS * sizeof(Student_t));
+    writer.first_slots = malloc(IMPORT_BATCH_RECORDS * sizeof(uint32_t));
+    F_Return_t status = (rounds && writer.slots && writer.first && writer.first_slots) ? F_OK : F_NOT_OK;
+
+    /* ---------- One pass over the database for existing IDs ---------- */
+    if (status == F_OK)
+        status = Load_Existing_Ids(&writer.ids, writer.first);
+
+    uint32_t chunk_count = Platform_CPU_Count();
+    if (!IMPORT_PARALLEL_ENABLED || chunk_count < 2)
+        chunk_count = 1;
+    else if (chunk_count > IMPORT_PARALLEL_MAX_THREADS)
+        chunk_count = IMPORT_PARALLEL_MAX_THREADS;
+
+    /* ---------- Parse a round ahead of the one being written ---------- */
+    bool at_end = false;
+    uint32_t current = 0;
+    if (status == F_OK)
+        status = Start_Round(import_fp, &rounds[0], NULL, chunk_count, &at_end);
+    while (status == F_OK && rounds[current].count > 0)
+    {
+        Import_Round_t* round = &rounds[current];
+        Import_Round_t* next = &rounds[1 - current];
+
+        Finish_Round(round);
+        status = Start_Round(import_fp, next, &round->chunks[round->count - 1], chunk_count, &at_end);
+        for (uint32_t i = 0; status == F_OK && i < round->count; i++)
+            status = Write_Chunk(&writer, &round->chunks[i]);
+        current = 1 - current;
+    }
+
+    /* Threads still parsing after an error are waited for */
+    if (rounds)
+    {
+        Finish_Round(&rounds[current]);
+        for (uint32_t i = 0; i < 2 * IMPORT_PARALLEL_MAX_THREADS; i++)
+            Chunk_Free(&rounds[i / IMPORT_PARALLEL_MAX_THREADS].chunks[i % IMPORT_PARALLEL_MAX_THREADS]);
+    }
+
+    /* Large imports: one bottom-up rebuild beats per-record inserts */
+    if (writer.report.imported > IMPORT_BATCH_RECORDS)
+    {
+        Indexes_Rebuild();
+    }
+    else
+    {
+        for (uint32_t i = 0; i < writer.report.imported; i++)
+            Indexes_On_Insert(writer.first_slots[i], &writer.first[i]);
+    }
+
+    free(rounds);
+    free(writer.slots);
+    free(writer.first);
+    free(writer.first_slots);
+    Id_Set_Free(&writer.ids);
+    fclose(import_fp);
+    if (writer.reject_fp && fclose(writer.reject_fp) != 0 && status == F_OK)
+        status = F_FILE_WRITE_ERROR;
+
+    printf("Student import completed (%u students added, %u records rejected).\n",
+           (unsigned)writer.report.imported, (unsigned)writer.report.rejected);
+    for (uint32_t bit = 0; bit < IMPORT_ERROR_KINDS; bit++)
+    {
+        if (writer.report.error_counts[bit] > 0)
+            printf("  - %s: %u\n", Error_Names[bit], (unsigned)writer.report.error_counts[bit]);
+    }
+    if (report)
+        *report = writer.report;
+    return status;
+}
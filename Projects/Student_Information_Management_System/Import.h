@@ -0,0 +1,53 @@
+#ifndef _Import_H_
+#define _Import_H_
+
+/* ============================================================
+ *  Bulk Import Engine
+ *
+ *  Description:
+ *  Loads student records from an external CSV file into the
+ *  database, parsed by the tokenizer of Csv.h. The file is cut
+ *  into chunks of whole records that worker threads parse and
+ *  validate, while the calling thread writes the chunks already
+ *  parsed in file order. Existing IDs are collected once into an
+ *  in-memory hash set so duplicate checks never touch the data
+ *  file, and validated records are written in large batches.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define IMPORT_BATCH_RECORDS          4096        /* Records per batched write */
+#define IMPORT_CHUNK_SIZE             (1 << 22)   /* Bytes of the file per parse task */
+#define IMPORT_PARALLEL_ENABLED       1
+#define IMPORT_PARALLEL_MAX_THREADS   8           /* Parse threads next to the writing thread */
+#define IMPORT_REJECT_BUFFER_SIZE     (1 << 20)   /* stdio buffer for the reject file */
+
+/**
+ * @brief  Imports student records from an external CSV file.
+ *
+ * @details
+ * - Streams the file through the CSV tokenizer, so lines may be
+ *   of any length and fields may be quoted.
+ * - Parses chunks of IMPORT_CHUNK_SIZE on worker threads and
+ *   writes them in file order, so the result is the same as a
+ *   sequential import.
+ * - Writes every rejected record to the reject file, in file
+ *   order, and counts it in the report. Only a summary goes to
+ *   the console.
+ * - Builds the set of active IDs with one pass over the database.
+ * - Rejects IDs already in the database or earlier in the file.
+ * - Writes validated records in batches of IMPORT_BATCH_RECORDS.
+ * - Bulk-rebuilds the indexes once when more than one batch was
+ *   imported, otherwise updates them record by record.
+ *
+ * @param  import_file Path to the external input file.
+ * @param  reject_file Path of the reject file to create, NULL for none.
+ * @param  report      Filled with the import counters, may be NULL.
+ * @return F_OK if all records processed successfully, otherwise error code.
+ */
+F_Return_t Import_From_File(const char* import_file, const char* reject_file, Import_Report_t* report);
+
+#endif // !_Import_H_
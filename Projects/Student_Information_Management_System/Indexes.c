@@ -0,0 +1,317 @@
+#include "Indexes.h"
+#include "ID_Index.h"
+#include "ID_Filter.h"
+#include "Column_Store.h"
+#include "Course_Index.h"
+#include "Name_Index.h"
+#include "Trigram_Index.h"
+#include "GPA_Index.h"
+#include "Storage.h"
+
+/**
+ * @brief  Opens every index, rebuilding the stale ones.
+ *
+ * @return F_OK if all indexes are ready, otherwise error code.
+ */
+F_Return_t Indexes_Open(void)
+{
+    F_Return_t status = ID_Index_Open();
+    if (status == F_OK)
+        status = ID_Filter_Open();
+    if (status == F_OK)
+        status = Column_Store_Open();
+    if (status == F_OK)
+        status = Course_Index_Open();
+    if (status == F_OK)
+        status = Name_Index_Open();
+    if (status == F_OK)
+        status = Trigram_Index_Open();
+    if (status == F_OK)
+        status = GPA_Index_Open();
+    return status;
+}
+
+/**
+ * @brief  Flushes and closes every index.
+ *
+ * @details
+ * - Must run before Storage_Close so the indexes can stamp the
+ *   database generation they cover.
+ */
+void Indexes_Close(void)
+{
+    ID_Index_Close();
+    ID_Filter_Close();
+    Column_Store_Close();
+    Course_Index_Close();
+    Name_Index_Close();
+    Trigram_Index_Close();
+    GPA_Index_Close();
+}
+
+/* Writes an index header at the start of its file */
+static F_Return_t Write_Index_Header(FILE* fp, const char* file_name, const void* header, uint32_t header_size)
+{
+    F_Return_t status = F_OK;
+
+    FILE* file = (fp) ? fp : fopen(file_name, "rb+");
+    if (!file)
+        return F_FILE_OPEN_ERROR;
+
+    if (fseek(file, 0, SEEK_SET) != 0 || fwrite(header, header_size, 1, file) != 1)
+        status = F_FILE_WRITE_ERROR;
+    if (fp)
+        fflush(fp);
+    else
+        fclose(file);
+    return status;
+}
+
+/**
+ * @brief  Clears the clean flag of an index file before its first change.
+ *
+ * @details
+ * - A file stamped clean is trusted at its next load, so the flag
+ *   goes to disk before the file and the database drift apart.
+ * - Does nothing if the flag is already clear.
+ *
+ * @param  fp          Open index file, or NULL to open file_name.
+ * @param  file_name   Index file to open when fp is NULL.
+ * @param  header      In-memory header, written at the start of the file.
+ * @param  header_size Bytes of the header.
+ * @param  is_clean    Clean flag inside the header.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Indexes_Mark_Dirty(FILE* fp, const char* file_name, void* header, uint32_t header_size, uint32_t* is_clean)
+{
+    if (!*is_clean)
+        return F_OK;
+
+    *is_clean = 0;
+    return Write_Index_Header(fp, file_name, header, header_size);
+}
+
+/**
+ * @brief  Moves a clean index file to the current database generation.
+ *
+ * @details
+ * - For an index whose memory still matches its clean file while
+ *   the database changed around it, so the next load trusts the
+ *   file instead of rebuilding it.
+ * - Does nothing if the file already carries the generation.
+ *
+ * @param  file_name   Index file, saved clean.
+ * @param  header      In-memory header, written at the start of the file.
+ * @param  header_size Bytes of the header.
+ * @param  generation  Generation field inside the header.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Indexes_Stamp_Generation(const char* file_name, void* header, uint32_t header_size, uint32_t* generation)
+{
+    uint32_t current = 0;
+
+    F_Return_t status = Storage_Get_Generation(&current);
+    if (status != F_OK || *generation == current)
+        return status;
+
+    *generation = current;
+    return Write_Index_Header(NULL, file_name, header, header_size);
+}
+
+/**
+ * @brief  Drops every index without writing anything.
+ *
+ * @details
+ * - Used when another process changed the database file. Each
+ *   module's Discard drops its in-memory state and open files
+ *   and writes nothing, since its saved state no longer matches
+ *   the database.
+ * - Each index is reloaded at its next use. The generation stamp
+ *   of its file tells whether it still covers the database; if
+ *   not, or if the file was left dirty, it is rebuilt.
+ */
+void Indexes_Discard(void)
+{
+    ID_Index_Discard();
+    ID_Filter_Discard();
+    Column_Store_Discard();
+    Course_Index_Discard();
+    Name_Index_Discard();
+    Trigram_Index_Discard();
+    GPA_Index_Discard();
+}
+
+/**
+ * @brief  Stamps the index files with the database generation they cover.
+ *
+ * @details
+ * - Run when this process releases the write lock, so the next
+ *   process loads the indexes instead of rebuilding them.
+ * - The ID index and column store live in their files and are
+ *   always stamped clean.
+ * - An in-memory index is stamped only if its clean file still
+ *   matches it. One changed since its last save is saved at close
+ *   only, and another process rebuilds that one.
+ */
+void Indexes_Publish(void)
+{
+    ID_Index_Flush();
+    ID_Filter_Flush();
+    Column_Store_Flush();
+    Course_Index_Flush();
+    Name_Index_Flush();
+    Trigram_Index_Flush();
+    GPA_Index_Flush();
+}
+
+/**
+ * @brief  Rebuilds every index from the database file.
+ *
+ * @return F_OK if all rebuilds succeed, otherwise error code.
+ */
+F_Return_t Indexes_Rebuild(void)
+{
+    F_Return_t status = ID_Index_Rebuild();
+    if (status == F_OK)
+        status = ID_Filter_Rebuild();
+    if (status == F_OK)
+        status = Column_Store_Rebuild();
+    if (status == F_OK)
+        status = Course_Index_Rebuild();
+    if (status == F_OK)
+        status = Name_Index_Rebuild();
+    if (status == F_OK)
+        status = Trigram_Index_Rebuild();
+    if (status == F_OK)
+        status = GPA_Index_Rebuild();
+    return status;
+}
+
+/**
+ * @brief  Indexes a record just stored in a slot.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Indexes_On_Insert(uint32_t slot, const Student_t* student)
+{
+    F_Return_t status = ID_Index_Insert(student->id, slot);
+    if (status == F_OK && student->is_active)
+        status = ID_Filter_Add(student->id);
+    if (status == F_OK)
+        status = Column_Store_Set(slot, student);
+    if (status == F_OK)
+        status = Course_Index_Set(slot, student);
+    if (status == F_OK && student->is_active)
+        status = Name_Index_Insert(slot, student->first_name);
+    if (status == F_OK && student->is_active)
+        status = Trigram_Index_Insert(slot, student);
+    if (status == F_OK && student->is_active)
+        status = GPA_Index_Insert(slot, student);
+    return status;
+}
+
+/**
+ * @brief  Re-indexes a record overwritten in place.
+ *
+ * @param  slot     Record slot number.
+ * @param  previous Record before the update.
+ * @param  updated  Record after the update.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Indexes_On_Update(uint32_t slot, const Student_t* previous, const Student_t* updated)
+{
+    F_Return_t status = F_OK;
+
+    /* The slot is unchanged, the ID index only moves if the ID did */
+    if (previous->id != updated->id)
+    {
+        ID_Index_Remove(previous->id);
+        status = ID_Index_Insert(updated->id, slot);
+        if (status == F_OK)
+            status = ID_Filter_Remove(previous->id);
+        if (status == F_OK)
+            status = ID_Filter_Add(updated->id);
+    }
+    if (status == F_OK)
+        status = Column_Store_Set(slot, updated);
+
+    /* The bitmaps, and their clean file, stay as they are unless the courses changed */
+    if (status == F_OK && Column_Course_Mask(previous) != Column_Course_Mask(updated))
+        status = Course_Index_Set(slot, updated);
+
+    /* Re-key the name index only when the normalized name changed */
+    char old_name[MAX_NAME_LENGTH], new_name[MAX_NAME_LENGTH];
+    Name_Normalize(previous->first_name, old_name);
+    Name_Normalize(updated->first_name, new_name);
+    if (status == F_OK && my_memcmp(old_name, new_name, my_strlen(old_name) + 1) != 0)
+    {
+        Name_Index_Remove(slot, previous->first_name);
+        status = Name_Index_Insert(slot, updated->first_name);
+    }
+
+    /* The search index only needs the new names, old entries go stale */
+    char old_last[MAX_NAME_LENGTH], new_last[MAX_NAME_LENGTH];
+    Name_Normalize(previous->last_name, old_last);
+    Name_Normalize(updated->last_name, new_last);
+    if (status == F_OK && (my_memcmp(old_name, new_name, my_strlen(old_name) + 1) != 0 ||
+                           my_memcmp(old_last, new_last, my_strlen(old_last) + 1) != 0))
+    {
+        Trigram_Index_Remove(slot);
+        status = Trigram_Index_Insert(slot, updated);
+    }
+
+    /* GPA edits move the student within the skip list */
+    if (status == F_OK && (previous->GPA != updated->GPA || previous->id != updated->id))
+    {
+        GPA_Index_Remove(previous);
+        status = GPA_Index_Insert(slot, updated);
+    }
+    return status;
+}
+
+/**
+ * @brief  Drops a logically deleted record from the indexes.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record as written, with is_active cleared.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Indexes_On_Delete(uint32_t slot, const Student_t* student)
+{
+    ID_Index_Remove(student->id);
+    ID_Filter_Remove(student->id);
+
+    F_Return_t status = Column_Store_Set(slot, student);
+    if (status == F_OK)
+        status = Course_Index_Remove(slot);
+    Name_Index_Remove(slot, student->first_name);
+    Trigram_Index_Remove(slot);
+    GPA_Index_Remove(student);
+    return status;
+}
+
+/**
+ * @brief  Follows a record moved by compaction.
+ *
+ * @details
+ * - Matches Storage_Relocate_t so it can be passed to
+ *   Storage_Compact directly.
+ *
+ * @param  student  Record that was moved.
+ * @param  old_slot Slot the record was read from.
+ * @param  new_slot Slot the record now occupies.
+ */
+void Indexes_On_Move(const Student_t* student, uint32_t old_slot, uint32_t new_slot)
+{
+    ID_Index_Insert(student->id, new_slot);
+    Column_Store_Set(new_slot, student);
+    Course_Index_Remove(old_slot);
+    Course_Index_Set(new_slot, student);
+    Name_Index_Remove(old_slot, student->first_name);
+    Name_Index_Insert(new_slot, student->first_name);
+    Trigram_Index_Remove(old_slot);
+    Trigram_Index_Insert(new_slot, student);
+    GPA_Index_Insert(new_slot, student);
+}
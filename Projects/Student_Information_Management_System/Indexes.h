@@ -0,0 +1,143 @@
+#ifndef _Indexes_H_
+#define _Indexes_H_
+
+/* ============================================================
+ *  Index Maintenance
+ *
+ *  Description:
+ *  Single place that keeps every structure derived from the
+ *  database file (ID, course, name, name search and GPA
+ *  indexes, ID filter, column store) in step with it. The system reports
+ *  each record change once and this module forwards it to all
+ *  indexes.
+ * ============================================================ */
+
+#include"System.h"
+
+/**
+ * @brief  Opens every index, rebuilding the stale ones.
+ *
+ * @return F_OK if all indexes are ready, otherwise error code.
+ */
+F_Return_t Indexes_Open(void);
+
+/**
+ * @brief  Flushes and closes every index.
+ *
+ * @details
+ * - Must run before Storage_Close so the indexes can stamp the
+ *   database generation they cover.
+ */
+void Indexes_Close(void);
+
+/**
+ * @brief  Drops every index without writing anything.
+ *
+ * @details
+ * - Used when another process changed the database file. Each
+ *   module's Discard drops its in-memory state and open files
+ *   and writes nothing, since its saved state no longer matches
+ *   the database.
+ * - Each index is reloaded at its next use. The generation stamp
+ *   of its file tells whether it still covers the database; if
+ *   not, or if the file was left dirty, it is rebuilt.
+ */
+void Indexes_Discard(void);
+
+/**
+ * @brief  Clears the clean flag of an index file before its first change.
+ *
+ * @details
+ * - A file stamped clean is trusted at its next load, so the flag
+ *   goes to disk before the file and the database drift apart.
+ * - Does nothing if the flag is already clear.
+ *
+ * @param  fp          Open index file, or NULL to open file_name.
+ * @param  file_name   Index file to open when fp is NULL.
+ * @param  header      In-memory header, written at the start of the file.
+ * @param  header_size Bytes of the header.
+ * @param  is_clean    Clean flag inside the header.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Indexes_Mark_Dirty(FILE* fp, const char* file_name, void* header, uint32_t header_size, uint32_t* is_clean);
+
+/**
+ * @brief  Moves a clean index file to the current database generation.
+ *
+ * @details
+ * - For an index whose memory still matches its clean file while
+ *   the database changed around it, so the next load trusts the
+ *   file instead of rebuilding it.
+ * - Does nothing if the file already carries the generation.
+ *
+ * @param  file_name   Index file, saved clean.
+ * @param  header      In-memory header, written at the start of the file.
+ * @param  header_size Bytes of the header.
+ * @param  generation  Generation field inside the header.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Indexes_Stamp_Generation(const char* file_name, void* header, uint32_t header_size, uint32_t* generation);
+
+/**
+ * @brief  Stamps the index files with the database generation they cover.
+ *
+ * @details
+ * - Run when this process releases the write lock, so the next
+ *   process loads the indexes instead of rebuilding them.
+ * - The ID index and column store live in their files and are
+ *   always stamped clean.
+ * - An in-memory index is stamped only if its clean file still
+ *   matches it. One changed since its last save is saved at close
+ *   only, and another process rebuilds that one.
+ */
+void Indexes_Publish(void);
+
+/**
+ * @brief  Rebuilds every index from the database file.
+ *
+ * @return F_OK if all rebuilds succeed, otherwise error code.
+ */
+F_Return_t Indexes_Rebuild(void);
+
+/**
+ * @brief  Indexes a record just stored in a slot.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Indexes_On_Insert(uint32_t slot, const Student_t* student);
+
+/**
+ * @brief  Re-indexes a record overwritten in place.
+ *
+ * @param  slot     Record slot number.
+ * @param  previous Record before the update.
+ * @param  updated  Record after the update.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Indexes_On_Update(uint32_t slot, const Student_t* previous, const Student_t* updated);
+
+/**
+ * @brief  Drops a logically deleted record from the indexes.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record as written, with is_active cleared.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Indexes_On_Delete(uint32_t slot, const Student_t* student);
+
+/**
+ * @brief  Follows a record moved by compaction.
+ *
+ * @details
+ * - Matches Storage_Relocate_t so it can be passed to
+ *   Storage_Compact directly.
+ *
+ * @param  student  Record that was moved.
+ * @param  old_slot Slot the record was read from.
+ * @param  new_slot Slot the record now occupies.
+ */
+void Indexes_On_Move(const Student_t* student, uint32_t old_slot, uint32_t new_slot);
+
+#endif // !_Indexes_H_
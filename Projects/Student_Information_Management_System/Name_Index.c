@@ -0,0 +1,470 @@
+#include "Name_Index.h"
+#include "Indexes.h"
+#include "Storage.h"
+
+/* ============================================================
+ *                    Table Layout
+ *
+ *  Linear probing over (hash, slot) entries; the slot value
+ *  NAME_EMPTY marks a free bucket. Deletions shift the rest of
+ *  the probe run back so no tombstones are needed. On disk the
+ *  header is followed by the whole entry array.
+ * ============================================================ */
+#define NAME_EMPTY     0xFFFFFFFFUL
+
+typedef struct
+{
+    uint32_t magic;                 /* NAME_INDEX_MAGIC */
+    uint32_t generation;            /* Database generation covered by the index */
+    uint32_t is_clean;              /* 1 when saved after the last change */
+    uint32_t capacity;              /* Buckets, always a power of two */
+    uint32_t count;                 /* Used buckets */
+} Name_Index_Header_t;
+
+typedef struct
+{
+    uint32_t hash;                  /* Hash of the normalized first name */
+    uint32_t slot;                  /* Record slot, NAME_EMPTY if free */
+} Name_Entry_t;
+
+static Name_Entry_t* table = NULL;
+static Name_Index_Header_t index_header;
+static bool index_loaded = false;
+
+/**
+ * @brief  Normalizes a name for indexing and comparison.
+ *
+ * @details
+ * - Drops leading and trailing white space.
+ * - Folds ASCII letters to lower case.
+ *
+ * @param  name       Name to normalize.
+ * @param  normalized Buffer of MAX_NAME_LENGTH bytes for the result.
+ */
+void Name_Normalize(const char* name, char* normalized)
+{
+    uint32_t length = 0;
+
+    while (*name == ' ' || *name == '\t' || *name == '\r' || *name == '\n')
+        name++;
+
+    while (*name && length < MAX_NAME_LENGTH - 1)
+    {
+        char c = *name++;
+        normalized[length++] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+
+    while (length > 0 && (normalized[length - 1] == ' ' || normalized[length - 1] == '\t' ||
+                          normalized[length - 1] == '\r' || normalized[length - 1] == '\n'))
+        length--;
+    normalized[length] = '\0';
+}
+
+/* FNV-1a over the normalized name */
+static uint32_t Name_Hash(const char* normalized)
+{
+    uint32_t hash = 2166136261UL;
+    while (*normalized)
+    {
+        hash ^= (uint8_t)*normalized++;
+        hash = (uint32_t)((hash * 16777619UL) & 0xFFFFFFFFUL);
+    }
+    return hash;
+}
+
+static F_Return_t Allocate_Table(uint32_t capacity)
+{
+    Name_Entry_t* fresh = malloc(capacity * sizeof(Name_Entry_t));
+    if (!fresh)
+        return F_NOT_OK;
+
+    for (uint32_t i = 0; i < capacity; i++)
+        fresh[i].slot = NAME_EMPTY;
+
+    free(table);
+    table = fresh;
+    index_header.capacity = capacity;
+    index_header.count = 0;
+    return F_OK;
+}
+
+/* Places an entry without checking the load factor */
+static void Place_Entry(uint32_t hash, uint32_t slot)
+{
+    uint32_t mask = index_header.capacity - 1;
+    uint32_t i = hash & mask;
+
+    while (table[i].slot != NAME_EMPTY)
+    {
+        if (table[i].hash == hash && table[i].slot == slot)
+            return;
+        i = (i + 1) & mask;
+    }
+    table[i].hash = hash;
+    table[i].slot = slot;
+    index_header.count++;
+}
+
+/* Doubles the table, keeping the load factor at or below one half */
+static F_Return_t Grow_Table(void)
+{
+    Name_Entry_t* old = table;
+    uint32_t old_capacity = index_header.capacity;
+
+    table = NULL;
+    if (Allocate_Table(2 * old_capacity) != F_OK)
+    {
+        table = old;
+        index_header.capacity = old_capacity;
+        return F_NOT_OK;
+    }
+
+    for (uint32_t i = 0; i < old_capacity; i++)
+    {
+        if (old[i].slot != NAME_EMPTY)
+            Place_Entry(old[i].hash, old[i].slot);
+    }
+    free(old);
+    return F_OK;
+}
+
+static F_Return_t Write_Header(FILE* fp)
+{
+    if (fseek(fp, 0, SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(&index_header, sizeof(Name_Index_Header_t), 1, fp) != 1)
+        return F_FILE_WRITE_ERROR;
+    return F_OK;
+}
+
+/* Writes the table and stamps the file clean for the current generation */
+static F_Return_t Save_Index(void)
+{
+    FILE* fp = fopen(NAME_INDEX_FILE_NAME, "wb");
+    if (!fp)
+        return F_FILE_OPEN_ERROR;
+
+    index_header.magic = NAME_INDEX_MAGIC;
+    index_header.is_clean = 0;
+    Storage_Get_Generation(&index_header.generation);
+
+    F_Return_t status = Write_Header(fp);
+    if (status == F_OK && fwrite(table, sizeof(Name_Entry_t), index_header.capacity, fp) != index_header.capacity)
+        status = F_FILE_WRITE_ERROR;
+    if (status == F_OK)
+    {
+        index_header.is_clean = 1;
+        status = Write_Header(fp);
+    }
+    fclose(fp);
+    return status;
+}
+
+/* Reads a clean table written for the current generation */
+static F_Return_t Load_Index(void)
+{
+    Name_Index_Header_t stored;
+    uint32_t generation = 0;
+
+    if (Storage_Get_Generation(&generation) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    FILE* fp = fopen(NAME_INDEX_FILE_NAME, "rb");
+    if (!fp)
+        return F_FILE_OPEN_ERROR;
+
+    if (fread(&stored, sizeof(stored), 1, fp) != 1 || stored.magic != NAME_INDEX_MAGIC ||
+        !stored.is_clean || stored.generation != generation ||
+        stored.capacity < NAME_INDEX_MIN_CAPACITY || (stored.capacity & (stored.capacity - 1)) != 0 ||
+        Allocate_Table(stored.capacity) != F_OK)
+    {
+        fclose(fp);
+        return F_FILE_READ_ERROR;
+    }
+
+    size_t got = fread(table, sizeof(Name_Entry_t), stored.capacity, fp);
+    fclose(fp);
+    if (got != stored.capacity)
+        return F_FILE_READ_ERROR;
+
+    index_header = stored;
+    return F_OK;
+}
+
+static int Compare_Slots(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief  Rebuilds the table from the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t Name_Index_Rebuild(void)
+{
+    Student_t buffer[256];
+    char normalized[MAX_NAME_LENGTH];
+    uint32_t record_count = 0, live = 0, dead = 0, got = 0;
+    uint32_t capacity = NAME_INDEX_MIN_CAPACITY;
+    F_Return_t status;
+
+    status = Storage_Record_Count(&record_count);
+    if (status == F_OK)
+        status = Storage_Get_Counts(&live, &dead);
+    if (status != F_OK)
+        return status;
+
+    /* Size the table once for every active record */
+    while (capacity < 2 * live)
+        capacity *= 2;
+    status = Allocate_Table(capacity);
+    if (status != F_OK)
+        return status;
+    index_loaded = true;
+
+    for (uint32_t slot = 0; slot < record_count; slot += got)
+    {
+        status = Storage_Read_Batch(slot, 256, buffer, &got);
+        if (status != F_OK || got == 0)
+            break;
+
+        for (uint32_t i = 0; i < got && status == F_OK; i++)
+        {
+            if (!buffer[i].is_active)
+                continue;
+
+            if (2 * (index_header.count + 1) > index_header.capacity)
+                status = Grow_Table();
+            Name_Normalize(buffer[i].first_name, normalized);
+            Place_Entry(Name_Hash(normalized), slot + i);
+        }
+    }
+
+    if (status != F_OK)
+        return status;
+    return Save_Index();
+}
+
+/**
+ * @brief  Loads the name index, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the table from the database file when the index
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the index is ready, otherwise error code.
+ */
+F_Return_t Name_Index_Open(void)
+{
+    if (index_loaded)
+        return F_OK;
+
+    if (Load_Index() == F_OK)
+    {
+        index_loaded = true;
+        return F_OK;
+    }
+
+    FILE* fp = fopen(NAME_INDEX_FILE_NAME, "rb");
+    if (fp)
+    {
+        fclose(fp);
+        printf("First name index is stale, rebuilding...\n");
+    }
+    return Name_Index_Rebuild();
+}
+
+/**
+ * @brief  Saves the table, stamps the index clean and frees it.
+ */
+void Name_Index_Close(void)
+{
+    if (!index_loaded)
+        return;
+
+    /* A clean index on disk already matches memory, it only needs the current generation */
+    if (index_header.is_clean)
+        Name_Index_Flush();
+    else
+        Save_Index();
+
+    free(table);
+    table = NULL;
+    index_loaded = false;
+}
+
+/**
+ * @brief  Stamps an unchanged name index file with the current generation.
+ *
+ * @details
+ * - Lets other processes load the table after a change that
+ *   left the first names alone, instead of rebuilding it.
+ * - Does nothing if the table is not loaded or changed since it
+ *   was saved; Name_Index_Close saves it then.
+ */
+void Name_Index_Flush(void)
+{
+    if (index_loaded && index_header.is_clean)
+        Indexes_Stamp_Generation(NAME_INDEX_FILE_NAME, &index_header, sizeof(Name_Index_Header_t), &index_header.generation);
+}
+
+/**
+ * @brief  Frees the table without saving it.
+ */
+void Name_Index_Discard(void)
+{
+    if (!index_loaded)
+        return;
+
+    free(table);
+    table = NULL;
+    index_loaded = false;
+}
+
+/**
+ * @brief  Adds the slot of an active record under its first name.
+ *
+ * @param  slot       Record slot number.
+ * @param  first_name First name stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Name_Index_Insert(uint32_t slot, const char* first_name)
+{
+    char normalized[MAX_NAME_LENGTH];
+    F_Return_t status;
+
+    if (!first_name)
+        return F_NOT_OK;
+
+    status = Name_Index_Open();
+    if (status == F_OK)
+        status = Indexes_Mark_Dirty(NULL, NAME_INDEX_FILE_NAME, &index_header, sizeof(Name_Index_Header_t), &index_header.is_clean);
+    if (status == F_OK && 2 * (index_header.count + 1) > index_header.capacity)
+        status = Grow_Table();
+    if (status != F_OK)
+        return status;
+
+    Name_Normalize(first_name, normalized);
+    Place_Entry(Name_Hash(normalized), slot);
+    return F_OK;
+}
+
+/**
+ * @brief  Removes the slot of a record from under its first name.
+ *
+ * @param  slot       Record slot number.
+ * @param  first_name First name the slot was indexed under.
+ * @return F_OK if the entry was removed, otherwise F_FNAME_NOT_FOUND.
+ */
+F_Return_t Name_Index_Remove(uint32_t slot, const char* first_name)
+{
+    char normalized[MAX_NAME_LENGTH];
+    F_Return_t status;
+
+    if (!first_name)
+        return F_NOT_OK;
+
+    status = Name_Index_Open();
+    if (status != F_OK)
+        return status;
+
+    Name_Normalize(first_name, normalized);
+    uint32_t hash = Name_Hash(normalized);
+    uint32_t mask = index_header.capacity - 1;
+    uint32_t i = hash & mask;
+
+    while (table[i].slot != NAME_EMPTY && !(table[i].hash == hash && table[i].slot == slot))
+        i = (i + 1) & mask;
+    if (table[i].slot == NAME_EMPTY)
+        return F_FNAME_NOT_FOUND;
+
+    status = Indexes_Mark_Dirty(NULL, NAME_INDEX_FILE_NAME, &index_header, sizeof(Name_Index_Header_t), &index_header.is_clean);
+    if (status != F_OK)
+        return status;
+
+    /* Shift later entries of the probe run into the hole if their home allows it */
+    for (uint32_t j = (i + 1) & mask; table[j].slot != NAME_EMPTY; j = (j + 1) & mask)
+    {
+        uint32_t home = table[j].hash & mask;
+        bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+        if (movable)
+        {
+            table[i] = table[j];
+            i = j;
+        }
+    }
+    table[i].slot = NAME_EMPTY;
+    index_header.count--;
+    return F_OK;
+}
+
+/**
+ * @brief  Visits every active student with the given first name.
+ *
+ * @details
+ * - The name is normalized before the lookup.
+ * - Hash collisions are filtered by comparing the stored name.
+ * - Slots are visited in increasing order.
+ *
+ * @param  first_name First name to look up.
+ * @param  visit      Callback for every matching slot.
+ * @param  context    Pointer forwarded to the callback.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Name_Index_Find(const char* first_name, Name_Index_Visit_t visit, void* context)
+{
+    char wanted[MAX_NAME_LENGTH];
+    char stored[MAX_NAME_LENGTH];
+    Student_t student;
+    uint32_t* matches = NULL;
+    uint32_t match_count = 0, match_capacity = 0;
+    F_Return_t status;
+
+    if (!first_name || !visit)
+        return F_NOT_OK;
+
+    status = Name_Index_Open();
+    if (status != F_OK)
+        return status;
+
+    Name_Normalize(first_name, wanted);
+    int wanted_length = my_strlen(wanted);
+    uint32_t hash = Name_Hash(wanted);
+    uint32_t mask = index_header.capacity - 1;
+
+    for (uint32_t i = hash & mask; table[i].slot != NAME_EMPTY; i = (i + 1) & mask)
+    {
+        if (table[i].hash != hash || Storage_Read(table[i].slot, &student) != F_OK || !student.is_active)
+            continue;
+
+        Name_Normalize(student.first_name, stored);
+        if (my_strlen(stored) != wanted_length || my_memcmp(stored, wanted, wanted_length) != 0)
+            continue;
+
+        if (match_count == match_capacity)
+        {
+            uint32_t capacity = (match_capacity) ? 2 * match_capacity : 16;
+            uint32_t* grown = realloc(matches, capacity * sizeof(uint32_t));
+            if (!grown)
+            {
+                free(matches);
+                return F_NOT_OK;
+            }
+            matches = grown;
+            match_capacity = capacity;
+        }
+        matches[match_count++] = table[i].slot;
+    }
+
+    /* Report students in database order, like a scan would */
+    qsort(matches, match_count, sizeof(uint32_t), Compare_Slots);
+    for (uint32_t i = 0; i < match_count; i++)
+        visit(matches[i], context);
+
+    free(matches);
+    return F_OK;
+}
@@ -0,0 +1,117 @@
+#ifndef _Name_Index_H_
+#define _Name_Index_H_
+
+/* ============================================================
+ *  First Name Hash Index
+ *
+ *  Description:
+ *  Open-addressing hash table from the normalized first name
+ *  (trimmed, case-folded) of every active student to its
+ *  record slot. Students sharing a name get one entry each.
+ *  The table is kept in memory and saved to its own file on
+ *  shutdown, so name lookups cost O(1) expected probes.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define NAME_INDEX_FILE_NAME       "Students_Information.nix"
+#define NAME_INDEX_MAGIC           0x58494E53UL    /* "SNIX" */
+#define NAME_INDEX_MIN_CAPACITY    1024            /* Entries in an empty table */
+
+/**
+ * @brief  Called by Name_Index_Find for every matching slot.
+ *
+ * @param  slot    Record slot of a matching student.
+ * @param  context Pointer passed to Name_Index_Find.
+ */
+typedef void (*Name_Index_Visit_t)(uint32_t slot, void* context);
+
+/**
+ * @brief  Normalizes a name for indexing and comparison.
+ *
+ * @details
+ * - Drops leading and trailing white space.
+ * - Folds ASCII letters to lower case.
+ *
+ * @param  name       Name to normalize.
+ * @param  normalized Buffer of MAX_NAME_LENGTH bytes for the result.
+ */
+void Name_Normalize(const char* name, char* normalized);
+
+/**
+ * @brief  Loads the name index, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the table from the database file when the index
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the index is ready, otherwise error code.
+ */
+F_Return_t Name_Index_Open(void);
+
+/**
+ * @brief  Saves the table, stamps the index clean and frees it.
+ */
+void Name_Index_Close(void);
+
+/**
+ * @brief  Stamps an unchanged name index file with the current generation.
+ *
+ * @details
+ * - Lets other processes load the table after a change that
+ *   left the first names alone, instead of rebuilding it.
+ * - Does nothing if the table is not loaded or changed since it
+ *   was saved; Name_Index_Close saves it then.
+ */
+void Name_Index_Flush(void);
+
+/**
+ * @brief  Frees the table without saving it.
+ */
+void Name_Index_Discard(void);
+
+/**
+ * @brief  Rebuilds the table from the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t Name_Index_Rebuild(void);
+
+/**
+ * @brief  Adds the slot of an active record under its first name.
+ *
+ * @param  slot       Record slot number.
+ * @param  first_name First name stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Name_Index_Insert(uint32_t slot, const char* first_name);
+
+/**
+ * @brief  Removes the slot of a record from under its first name.
+ *
+ * @param  slot       Record slot number.
+ * @param  first_name First name the slot was indexed under.
+ * @return F_OK if the entry was removed, otherwise F_FNAME_NOT_FOUND.
+ */
+F_Return_t Name_Index_Remove(uint32_t slot, const char* first_name);
+
+/**
+ * @brief  Visits every active student with the given first name.
+ *
+ * @details
+ * - The name is normalized before the lookup.
+ * - Hash collisions are filtered by comparing the stored name.
+ * - Slots are visited in increasing order.
+ *
+ * @param  first_name First name to look up.
+ * @param  visit      Callback for every matching slot.
+ * @param  context    Pointer forwarded to the callback.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Name_Index_Find(const char* first_name, Name_Index_Visit_t visit, void* context);
+
+#endif // !_Name_Index_H_
@@ -0,0 +1,319 @@
+#include "Platform.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief  Truncates or extends an open file to the given size.
+ *
+ * @details
+ * - Flushes the stream before resizing the underlying file.
+ *
+ * @param  fp   Open file stream.
+ * @param  size New file size in bytes.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Truncate_File(FILE* fp, long size)
+{
+    if (!fp)
+        return -1;
+
+    fflush(fp);
+#ifdef _WIN32
+    return (_chsize_s(_fileno(fp), size) == 0) ? 0 : -1;
+#else
+    return (ftruncate(fileno(fp), size) == 0) ? 0 : -1;
+#endif
+}
+
+/**
+ * @brief  Flushes a stream and forces its file to stable storage.
+ *
+ * @param  fp Open file stream.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Sync_File(FILE* fp)
+{
+    if (!fp || fflush(fp) != 0)
+        return -1;
+#ifdef _WIN32
+    return (_commit(_fileno(fp)) == 0) ? 0 : -1;
+#else
+    return (fsync(fileno(fp)) == 0) ? 0 : -1;
+#endif
+}
+
+/**
+ * @brief  Maps the first bytes of a file read-only into memory.
+ *
+ * @details
+ * - The mapping is shared with the OS page cache, so writes made
+ *   to the file through other streams become visible in it.
+ * - The file must not be truncated while it is mapped.
+ *
+ * @param  path Path of the file to map.
+ * @param  size Number of bytes to map, must be greater than 0.
+ * @param  map  Mapping descriptor to fill.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Map_File(const char* path, size_t size, Platform_Map_t* map)
+{
+    if (!path || !map || size == 0)
+        return -1;
+
+    my_memset(map, 0, sizeof(Platform_Map_t));
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return -1;
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return -1;
+    }
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return -1;
+    }
+
+    map->file_handle = file;
+    map->map_handle = mapping;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    void* data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  /* The mapping keeps its own reference to the file */
+    if (data == MAP_FAILED)
+        return -1;
+#endif
+    map->data = data;
+    map->size = size;
+    return 0;
+}
+
+/**
+ * @brief  Releases a mapping created by Platform_Map_File.
+ *
+ * @param  map Mapping descriptor, reset to the unmapped state.
+ */
+void Platform_Unmap_File(Platform_Map_t* map)
+{
+    if (!map || !map->data)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(map->data);
+    CloseHandle(map->map_handle);
+    CloseHandle(map->file_handle);
+#else
+    munmap((void*)map->data, map->size);
+#endif
+    my_memset(map, 0, sizeof(Platform_Map_t));
+}
+
+/**
+ * @brief  Opens the file backing an inter-process lock.
+ *
+ * @details
+ * - Creates the file if it does not exist.
+ *
+ * @param  path Path of the lock file.
+ * @param  lock Lock descriptor to fill.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Open_Lock(const char* path, Platform_Lock_t* lock)
+{
+    if (!path || !lock)
+        return -1;
+
+    my_memset(lock, 0, sizeof(Platform_Lock_t));
+    lock->fd = -1;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return -1;
+    lock->handle = file;
+#else
+    lock->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (lock->fd < 0)
+        return -1;
+#endif
+    return 0;
+}
+
+/**
+ * @brief  Waits for and takes a lock.
+ *
+ * @details
+ * - Shared locks are held by any number of processes at once,
+ *   an exclusive lock by one process and no shared holder.
+ * - Must not be called while this process holds the lock.
+ *
+ * @param  lock      Open lock descriptor.
+ * @param  exclusive true for an exclusive lock, false for shared.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Lock_File(Platform_Lock_t* lock, bool exclusive)
+{
+    if (!lock)
+        return -1;
+
+#ifdef _WIN32
+    OVERLAPPED region = { 0 };
+    if (!lock->handle)
+        return -1;
+    return LockFileEx(lock->handle, exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0, 0, 1, 0, &region) ? 0 : -1;
+#else
+    /* Record locks on the first byte; the descriptor is never closed while locked */
+    struct flock region = { 0 };
+    region.l_type = exclusive ? F_WRLCK : F_RDLCK;
+    region.l_whence = SEEK_SET;
+    region.l_start = 0;
+    region.l_len = 1;
+
+    if (lock->fd < 0)
+        return -1;
+    while (fcntl(lock->fd, F_SETLKW, &region) != 0)
+    {
+        if (errno != EINTR)
+            return -1;
+    }
+    return 0;
+#endif
+}
+
+/**
+ * @brief  Releases a lock taken with Platform_Lock_File.
+ *
+ * @param  lock Open lock descriptor.
+ */
+void Platform_Unlock_File(Platform_Lock_t* lock)
+{
+    if (!lock)
+        return;
+
+#ifdef _WIN32
+    OVERLAPPED region = { 0 };
+    if (lock->handle)
+        UnlockFileEx(lock->handle, 0, 1, 0, &region);
+#else
+    struct flock region = { 0 };
+    region.l_type = F_UNLCK;
+    region.l_whence = SEEK_SET;
+    region.l_start = 0;
+    region.l_len = 1;
+
+    if (lock->fd >= 0)
+        fcntl(lock->fd, F_SETLK, &region);
+#endif
+}
+
+#ifdef _WIN32
+static DWORD WINAPI Thread_Entry(LPVOID parameter)
+{
+    Platform_Thread_t* thread = parameter;
+    thread->routine(thread->argument);
+    return 0;
+}
+#else
+static void* Thread_Entry(void* parameter)
+{
+    Platform_Thread_t* thread = parameter;
+    thread->routine(thread->argument);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief  Starts a thread running a routine.
+ *
+ * @param  thread   Thread descriptor, must stay valid until joined.
+ * @param  routine  Routine to run.
+ * @param  argument Argument passed to the routine.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Thread_Start(Platform_Thread_t* thread, Platform_Thread_Routine_t routine, void* argument)
+{
+    if (!thread || !routine)
+        return -1;
+
+    thread->routine = routine;
+    thread->argument = argument;
+#ifdef _WIN32
+    thread->handle = CreateThread(NULL, 0, Thread_Entry, thread, 0, NULL);
+    return (thread->handle) ? 0 : -1;
+#else
+    return (pthread_create(&thread->handle, NULL, Thread_Entry, thread) == 0) ? 0 : -1;
+#endif
+}
+
+/**
+ * @brief  Waits for a thread started by Platform_Thread_Start to end.
+ *
+ * @param  thread Thread descriptor.
+ */
+void Platform_Thread_Join(Platform_Thread_t* thread)
+{
+    if (!thread)
+        return;
+
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    thread->handle = NULL;
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+}
+
+/**
+ * @brief  Returns the number of processors available, at least 1.
+ */
+uint32_t Platform_CPU_Count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (info.dwNumberOfProcessors > 0) ? (uint32_t)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (uint32_t)count : 1;
+#endif
+}
+
+/**
+ * @brief  Returns the time of a monotonic clock, for measuring intervals.
+ *
+ * @return Seconds since an arbitrary starting point.
+ */
+double Platform_Time_Seconds(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+#endif
+}
@@ -0,0 +1,163 @@
+#ifndef _Platform_H_
+#define _Platform_H_
+
+/* ============================================================
+ *  Platform Services
+ *
+ *  Description:
+ *  Thin wrappers over the operating system calls the database
+ *  needs beyond standard C file I/O. Windows builds use the CRT
+ *  and Win32 APIs, other builds use POSIX.
+ * ============================================================ */
+
+#include"String.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+/* ============================================================
+ *                    Read-Only File Mapping
+ * ============================================================ */
+typedef struct
+{
+    const void* data;           /* First mapped byte, NULL if unmapped */
+    size_t size;                /* Mapped length in bytes */
+    void* file_handle;          /* Windows file handle */
+    void* map_handle;           /* Windows file mapping handle */
+} Platform_Map_t;
+
+/**
+ * @brief  Truncates or extends an open file to the given size.
+ *
+ * @details
+ * - Flushes the stream before resizing the underlying file.
+ *
+ * @param  fp   Open file stream.
+ * @param  size New file size in bytes.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Truncate_File(FILE* fp, long size);
+
+/**
+ * @brief  Flushes a stream and forces its file to stable storage.
+ *
+ * @param  fp Open file stream.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Sync_File(FILE* fp);
+
+/**
+ * @brief  Maps the first bytes of a file read-only into memory.
+ *
+ * @details
+ * - The mapping is shared with the OS page cache, so writes made
+ *   to the file through other streams become visible in it.
+ * - The file must not be truncated while it is mapped.
+ *
+ * @param  path Path of the file to map.
+ * @param  size Number of bytes to map, must be greater than 0.
+ * @param  map  Mapping descriptor to fill.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Map_File(const char* path, size_t size, Platform_Map_t* map);
+
+/**
+ * @brief  Releases a mapping created by Platform_Map_File.
+ *
+ * @param  map Mapping descriptor, reset to the unmapped state.
+ */
+void Platform_Unmap_File(Platform_Map_t* map);
+
+/* ============================================================
+ *                    Inter-Process Locks
+ * ============================================================ */
+typedef struct
+{
+    void* handle;               /* Windows file handle */
+    int fd;                     /* POSIX descriptor, -1 if closed */
+} Platform_Lock_t;
+
+/**
+ * @brief  Opens the file backing an inter-process lock.
+ *
+ * @details
+ * - Creates the file if it does not exist.
+ *
+ * @param  path Path of the lock file.
+ * @param  lock Lock descriptor to fill.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Open_Lock(const char* path, Platform_Lock_t* lock);
+
+/**
+ * @brief  Waits for and takes a lock.
+ *
+ * @details
+ * - Shared locks are held by any number of processes at once,
+ *   an exclusive lock by one process and no shared holder.
+ * - Must not be called while this process holds the lock.
+ *
+ * @param  lock      Open lock descriptor.
+ * @param  exclusive true for an exclusive lock, false for shared.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Lock_File(Platform_Lock_t* lock, bool exclusive);
+
+/**
+ * @brief  Releases a lock taken with Platform_Lock_File.
+ *
+ * @param  lock Open lock descriptor.
+ */
+void Platform_Unlock_File(Platform_Lock_t* lock);
+
+/* ============================================================
+ *                    Threads
+ * ============================================================ */
+typedef void (*Platform_Thread_Routine_t)(void* argument);
+
+typedef struct
+{
+    Platform_Thread_Routine_t routine;
+    void* argument;
+#ifdef _WIN32
+    void* handle;               /* Windows thread handle */
+#else
+    pthread_t handle;
+#endif
+} Platform_Thread_t;
+
+/**
+ * @brief  Starts a thread running a routine.
+ *
+ * @param  thread   Thread descriptor, must stay valid until joined.
+ * @param  routine  Routine to run.
+ * @param  argument Argument passed to the routine.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Thread_Start(Platform_Thread_t* thread, Platform_Thread_Routine_t routine, void* argument);
+
+/**
+ * @brief  Waits for a thread started by Platform_Thread_Start to end.
+ *
+ * @param  thread Thread descriptor.
+ */
+void Platform_Thread_Join(Platform_Thread_t* thread);
+
+/**
+ * @brief  Returns the number of processors available, at least 1.
+ */
+uint32_t Platform_CPU_Count(void);
+
+/* ============================================================
+ *                    Clock
+ * ============================================================ */
+
+/**
+ * @brief  Returns the time of a monotonic clock, for measuring intervals.
+ *
+ * @return Seconds since an arbitrary starting point.
+ */
+double Platform_Time_Seconds(void);
+
+#endif // !_Platform_H_
@@ -0,0 +1,330 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "Platform_Socket.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+typedef SOCKET Native_Socket_t;
+typedef int Address_Length_t;
+#define NO_SOCKET          INVALID_SOCKET
+#define Close_Native       closesocket
+#define SEND_FLAGS         0
+#else
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int Native_Socket_t;
+typedef socklen_t Address_Length_t;
+#define NO_SOCKET          (-1)
+#define Close_Native       close
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS         MSG_NOSIGNAL     /* A closed peer is an error, not SIGPIPE */
+#else
+#define SEND_FLAGS         0
+#endif
+#endif
+
+static Native_Socket_t Native(const Platform_Socket_t* socket)
+{
+    return socket->open ? (Native_Socket_t)socket->handle : NO_SOCKET;
+}
+
+static void Wrap(Platform_Socket_t* socket, Native_Socket_t native)
+{
+    socket->handle = (unsigned long long)native;
+    socket->open = true;
+}
+
+static int Start_Sockets(void)
+{
+#ifdef _WIN32
+    static bool started = false;
+    WSADATA data;
+
+    if (!started && WSAStartup(MAKEWORD(2, 2), &data) != 0)
+        return -1;
+    started = true;
+#endif
+    return 0;
+}
+
+/* Fills a socket address from "unix:<path>" or "tcp:<port>", TCP on loopback only */
+static int Make_Address(const char* address, struct sockaddr_storage* storage, Address_Length_t* length)
+{
+    memset(storage, 0, sizeof(*storage));
+
+    if (strncmp(address, PLATFORM_UNIX_PREFIX, strlen(PLATFORM_UNIX_PREFIX)) == 0)
+    {
+#ifdef _WIN32
+        return -1;
+#else
+        struct sockaddr_un* local = (struct sockaddr_un*)storage;
+        const char* path = address + strlen(PLATFORM_UNIX_PREFIX);
+
+        if (path[0] == '\0' || strlen(path) >= sizeof(local->sun_path))
+            return -1;
+        local->sun_family = AF_UNIX;
+        memcpy(local->sun_path, path, strlen(path) + 1);
+        *length = sizeof(struct sockaddr_un);
+        return 0;
+#endif
+    }
+
+    if (strncmp(address, PLATFORM_TCP_PREFIX, strlen(PLATFORM_TCP_PREFIX)) == 0)
+        address += strlen(PLATFORM_TCP_PREFIX);
+
+    char* end;
+    unsigned long port = strtoul(address, &end, 10);
+    if (end == address || *end != '\0' || port == 0 || port > 65535)
+        return -1;
+
+    struct sockaddr_in* inet = (struct sockaddr_in*)storage;
+    inet->sin_family = AF_INET;
+    inet->sin_port = htons((unsigned short)port);
+    inet->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    *length = sizeof(struct sockaddr_in);
+    return 0;
+}
+
+static void Set_No_Delay(Native_Socket_t native)
+{
+    int one = 1;
+
+    /* Fails harmlessly on Unix domain sockets */
+    setsockopt(native, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+#if !defined(_WIN32) && defined(SO_NOSIGPIPE)
+    setsockopt(native, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+}
+
+/**
+ * @brief  Creates a socket listening on an address.
+ *
+ * @details
+ * - Removes a Unix socket file left behind by an earlier server.
+ *
+ * @param  address "unix:<path>" or "tcp:<port>".
+ * @param  server  Socket to fill.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Listen(const char* address, Platform_Socket_t* server)
+{
+    struct sockaddr_storage storage;
+    Address_Length_t length;
+    int one = 1;
+
+    if (!address || !server)
+        return -1;
+    memset(server, 0, sizeof(Platform_Socket_t));
+    if (Start_Sockets() != 0 || Make_Address(address, &storage, &length) != 0)
+        return -1;
+
+#ifndef _WIN32
+    if (storage.ss_family == AF_UNIX)
+        unlink(((struct sockaddr_un*)&storage)->sun_path);
+#endif
+
+    Native_Socket_t native = socket(storage.ss_family, SOCK_STREAM, 0);
+    if (native == NO_SOCKET)
+        return -1;
+
+    /* A restarted server must not wait for old connections to time out */
+    if (storage.ss_family == AF_INET)
+        setsockopt(native, SOL_SOCKET, SO_REUSEADDR, (const char*)&one, sizeof(one));
+
+    if (bind(native, (struct sockaddr*)&storage, length) != 0 || listen(native, SOMAXCONN) != 0)
+    {
+        Close_Native(native);
+        return -1;
+    }
+    Wrap(server, native);
+    return 0;
+}
+
+/**
+ * @brief  Accepts the next connection of a listening socket.
+ *
+ * @param  server Listening socket.
+ * @param  client Socket to fill with the connection.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Accept(Platform_Socket_t* server, Platform_Socket_t* client)
+{
+    if (!server || !client)
+        return -1;
+    memset(client, 0, sizeof(Platform_Socket_t));
+
+    Native_Socket_t native = accept(Native(server), NULL, NULL);
+    if (native == NO_SOCKET)
+        return -1;
+
+    Set_No_Delay(native);
+    Wrap(client, native);
+    return 0;
+}
+
+/**
+ * @brief  Connects to a listening socket.
+ *
+ * @details
+ * - Disables Nagle's algorithm on TCP, requests are small and
+ *   wait for their reply.
+ *
+ * @param  address "unix:<path>" or "tcp:<port>".
+ * @param  client  Socket to fill.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Connect(const char* address, Platform_Socket_t* client)
+{
+    struct sockaddr_storage storage;
+    Address_Length_t length;
+
+    if (!address || !client)
+        return -1;
+    memset(client, 0, sizeof(Platform_Socket_t));
+    if (Start_Sockets() != 0 || Make_Address(address, &storage, &length) != 0)
+        return -1;
+
+    Native_Socket_t native = socket(storage.ss_family, SOCK_STREAM, 0);
+    if (native == NO_SOCKET)
+        return -1;
+    if (connect(native, (struct sockaddr*)&storage, length) != 0)
+    {
+        Close_Native(native);
+        return -1;
+    }
+
+    Set_No_Delay(native);
+    Wrap(client, native);
+    return 0;
+}
+
+/**
+ * @brief  Sends a whole buffer.
+ *
+ * @param  socket Connected socket.
+ * @param  data   Bytes to send.
+ * @param  size   Number of bytes.
+ * @return 0 once every byte is sent, -1 on failure.
+ */
+int Platform_Send(Platform_Socket_t* socket, const void* data, size_t size)
+{
+    const char* next = data;
+
+    if (!socket || !socket->open)
+        return -1;
+
+    while (size > 0)
+    {
+        int chunk = (size > (1u << 30)) ? (1 << 30) : (int)size;
+        long sent = send(Native(socket), next, chunk, SEND_FLAGS);
+        if (sent <= 0)
+        {
+#ifndef _WIN32
+            if (sent < 0 && errno == EINTR)
+                continue;
+#endif
+            return -1;
+        }
+        next += sent;
+        size -= (size_t)sent;
+    }
+    return 0;
+}
+
+/**
+ * @brief  Receives the bytes available, waiting for at least one.
+ *
+ * @param  socket Connected socket.
+ * @param  buffer Buffer to fill.
+ * @param  size   Capacity of buffer.
+ * @return Number of bytes received, 0 once the peer closed, -1 on failure.
+ */
+long Platform_Receive(Platform_Socket_t* socket, void* buffer, size_t size)
+{
+    long got;
+
+    if (!socket || !socket->open || !buffer)
+        return -1;
+    if (size > (1u << 30))
+        size = 1u << 30;
+
+    do
+    {
+        got = recv(Native(socket), buffer, (int)size, 0);
+#ifdef _WIN32
+    } while (0);
+#else
+    } while (got < 0 && errno == EINTR);
+#endif
+    return (got < 0) ? -1 : got;
+}
+
+/**
+ * @brief  Waits until some sockets can be read without blocking.
+ *
+ * @details
+ * - A closed or failed connection counts as readable, the next
+ *   Platform_Receive reports it.
+ *
+ * @param  sockets    Open sockets to watch, at most PLATFORM_POLL_MAX.
+ * @param  count      Number of sockets.
+ * @param  readable   Array of count flags, set for the readable sockets.
+ * @param  timeout_ms Longest wait, -1 to wait forever.
+ * @return Number of readable sockets, 0 on timeout, -1 on failure.
+ */
+int Platform_Wait_Readable(const Platform_Socket_t* sockets, unsigned int count, bool* readable, int timeout_ms)
+{
+#ifdef _WIN32
+    WSAPOLLFD polls[PLATFORM_POLL_MAX];
+#else
+    struct pollfd polls[PLATFORM_POLL_MAX];
+#endif
+    int ready;
+
+    if (!sockets || !readable || count == 0 || count > PLATFORM_POLL_MAX)
+        return -1;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        polls[i].fd = Native(&sockets[i]);
+        polls[i].events = POLLIN;
+        polls[i].revents = 0;
+    }
+
+#ifdef _WIN32
+    ready = WSAPoll(polls, count, timeout_ms);
+#else
+    do
+    {
+        ready = poll(polls, count, timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+#endif
+    if (ready < 0)
+        return -1;
+
+    for (unsigned int i = 0; i < count; i++)
+        readable[i] = (polls[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+    return ready;
+}
+
+/**
+ * @brief  Closes a socket.
+ *
+ * @param  socket Socket to close, ignored if not open.
+ */
+void Platform_Close_Socket(Platform_Socket_t* socket)
+{
+    if (!socket || !socket->open)
+        return;
+
+    Close_Native(Native(socket));
+    socket->open = false;
+}
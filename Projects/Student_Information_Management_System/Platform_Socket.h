@@ -0,0 +1,111 @@
+#ifndef _Platform_Socket_H_
+#define _Platform_Socket_H_
+
+/* ============================================================
+ *  Platform Sockets
+ *
+ *  Description:
+ *  Stream sockets on the local machine, over Winsock on Windows
+ *  and BSD sockets elsewhere. An address is either
+ *  "unix:<path>" for a Unix domain socket (POSIX only) or
+ *  "tcp:<port>" for TCP on the loopback interface.
+ *
+ *  Kept apart from Platform.h: the POSIX network headers define
+ *  the standard fixed-width integer types that My_Typedef.h
+ *  defines differently, so this module includes neither and its
+ *  API uses only the built-in types.
+ * ============================================================ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define PLATFORM_UNIX_PREFIX      "unix:"
+#define PLATFORM_TCP_PREFIX       "tcp:"
+#define PLATFORM_POLL_MAX         128       /* Sockets one Platform_Wait_Readable call can watch */
+
+typedef struct
+{
+    unsigned long long handle;  /* SOCKET on Windows, descriptor elsewhere */
+    bool open;
+} Platform_Socket_t;
+
+/**
+ * @brief  Creates a socket listening on an address.
+ *
+ * @details
+ * - Removes a Unix socket file left behind by an earlier server.
+ *
+ * @param  address "unix:<path>" or "tcp:<port>".
+ * @param  server  Socket to fill.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Listen(const char* address, Platform_Socket_t* server);
+
+/**
+ * @brief  Accepts the next connection of a listening socket.
+ *
+ * @param  server Listening socket.
+ * @param  client Socket to fill with the connection.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Accept(Platform_Socket_t* server, Platform_Socket_t* client);
+
+/**
+ * @brief  Connects to a listening socket.
+ *
+ * @details
+ * - Disables Nagle's algorithm on TCP, requests are small and
+ *   wait for their reply.
+ *
+ * @param  address "unix:<path>" or "tcp:<port>".
+ * @param  client  Socket to fill.
+ * @return 0 on success, -1 on failure.
+ */
+int Platform_Connect(const char* address, Platform_Socket_t* client);
+
+/**
+ * @brief  Sends a whole buffer.
+ *
+ * @param  socket Connected socket.
+ * @param  data   Bytes to send.
+ * @param  size   Number of bytes.
+ * @return 0 once every byte is sent, -1 on failure.
+ */
+int Platform_Send(Platform_Socket_t* socket, const void* data, size_t size);
+
+/**
+ * @brief  Receives the bytes available, waiting for at least one.
+ *
+ * @param  socket Connected socket.
+ * @param  buffer Buffer to fill.
+ * @param  size   Capacity of buffer.
+ * @return Number of bytes received, 0 once the peer closed, -1 on failure.
+ */
+long Platform_Receive(Platform_Socket_t* socket, void* buffer, size_t size);
+
+/**
+ * @brief  Waits until some sockets can be read without blocking.
+ *
+ * @details
+ * - A closed or failed connection counts as readable, the next
+ *   Platform_Receive reports it.
+ *
+ * @param  sockets    Open sockets to watch, at most PLATFORM_POLL_MAX.
+ * @param  count      Number of sockets.
+ * @param  readable   Array of count flags, set for the readable sockets.
+ * @param  timeout_ms Longest wait, -1 to wait forever.
+ * @return Number of readable sockets, 0 on timeout, -1 on failure.
+ */
+int Platform_Wait_Readable(const Platform_Socket_t* sockets, unsigned int count, bool* readable, int timeout_ms);
+
+/**
+ * @brief  Closes a socket.
+ *
+ * @param  socket Socket to close, ignored if not open.
+ */
+void Platform_Close_Socket(Platform_Socket_t* socket);
+
+#endif // !_Platform_Socket_H_
@@ -0,0 +1,136 @@
+#include "Protocol.h"
+
+/**
+ * @brief  Writes a 16-bit value little-endian.
+ *
+ * @param  out   Destination, 2 bytes.
+ * @param  value Value to write.
+ */
+void Protocol_Put_U16(uint8_t* out, uint16_t value)
+{
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief  Reads a little-endian 16-bit value.
+ *
+ * @param  in Source, 2 bytes.
+ * @return The value.
+ */
+uint16_t Protocol_Get_U16(const uint8_t* in)
+{
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+/**
+ * @brief  Writes a 32-bit value little-endian.
+ *
+ * @param  out   Destination, 4 bytes.
+ * @param  value Value to write, only its low 32 bits.
+ */
+void Protocol_Put_U32(uint8_t* out, uint32_t value)
+{
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)((value >> 8) & 0xFF);
+    out[2] = (uint8_t)((value >> 16) & 0xFF);
+    out[3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+/**
+ * @brief  Reads a little-endian 32-bit value.
+ *
+ * @param  in Source, 4 bytes.
+ * @return The value.
+ */
+uint32_t Protocol_Get_U32(const uint8_t* in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+/**
+ * @brief  Packs a frame header.
+ *
+ * @param  out    Destination, PROTOCOL_HEADER_SIZE bytes.
+ * @param  header Header to pack.
+ */
+void Protocol_Put_Header(uint8_t* out, const Protocol_Header_t* header)
+{
+    Protocol_Put_U32(out, header->length);
+    out[4] = header->op;
+    out[5] = header->status;
+    Protocol_Put_U16(out + 6, 0);
+    Protocol_Put_U32(out + 8, header->tag);
+}
+
+/**
+ * @brief  Unpacks a frame header.
+ *
+ * @param  in     Source, PROTOCOL_HEADER_SIZE bytes.
+ * @param  header Header to fill.
+ */
+void Protocol_Get_Header(const uint8_t* in, Protocol_Header_t* header)
+{
+    header->length = Protocol_Get_U32(in);
+    header->op = in[4];
+    header->status = in[5];
+    header->tag = Protocol_Get_U32(in + 8);
+}
+
+/**
+ * @brief  Packs a student.
+ *
+ * @param  out     Destination, PROTOCOL_STUDENT_SIZE bytes.
+ * @param  student Student to pack.
+ */
+void Protocol_Put_Student(uint8_t* out, const Student_t* student)
+{
+    uint32_t gpa_bits = 0;
+
+    /* IEEE-754 single, its bits sent as an integer */
+    my_memcpy(&gpa_bits, &student->GPA, sizeof(float));
+
+    Protocol_Put_U32(out, student->id);
+    out += 4;
+    my_memcpy(out, student->first_name, MAX_NAME_LENGTH);
+    out += MAX_NAME_LENGTH;
+    my_memcpy(out, student->last_name, MAX_NAME_LENGTH);
+    out += MAX_NAME_LENGTH;
+    Protocol_Put_U32(out, gpa_bits);
+    out += 4;
+    *out++ = student->course_count;
+    my_memcpy(out, student->courses, MAX_COURSES);
+}
+
+/**
+ * @brief  Unpacks a student.
+ *
+ * @details
+ * - Terminates both names and caps the course count, so a bad
+ *   frame cannot produce an unterminated or oversized record.
+ * - The student comes out active.
+ *
+ * @param  in      Source, PROTOCOL_STUDENT_SIZE bytes.
+ * @param  student Student to fill.
+ */
+void Protocol_Get_Student(const uint8_t* in, Student_t* student)
+{
+    uint32_t gpa_bits;
+
+    my_memset(student, 0, sizeof(Student_t));
+    student->id = Protocol_Get_U32(in);
+    in += 4;
+    my_memcpy(student->first_name, in, MAX_NAME_LENGTH);
+    student->first_name[MAX_NAME_LENGTH - 1] = '\0';
+    in += MAX_NAME_LENGTH;
+    my_memcpy(student->last_name, in, MAX_NAME_LENGTH);
+    student->last_name[MAX_NAME_LENGTH - 1] = '\0';
+    in += MAX_NAME_LENGTH;
+    gpa_bits = Protocol_Get_U32(in);
+    my_memcpy(&student->GPA, &gpa_bits, sizeof(float));
+    in += 4;
+    student->course_count = (*in > MAX_COURSES) ? MAX_COURSES : *in;
+    in++;
+    my_memcpy(student->courses, in, MAX_COURSES);
+    student->is_active = 1;
+}
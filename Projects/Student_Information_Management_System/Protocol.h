@@ -0,0 +1,142 @@
+#ifndef _Protocol_H_
+#define _Protocol_H_
+
+/* ============================================================
+ *  Client-Server Protocol
+ *
+ *  Description:
+ *  Binary frames exchanged by Client.c and Server.c. A frame is
+ *  a fixed header followed by length payload bytes. The server
+ *  answers every request with one reply frame carrying the tag
+ *  of the request and an F_Return_t status.
+ *
+ *  A client may pipeline, sending several requests before
+ *  reading: replies come back in request order, and the server
+ *  sends the replies to the requests of one read together.
+ *
+ *  Integers are little-endian with an explicit width, so client
+ *  and server need not come from the same build. A student is
+ *  packed field by field:
+ *
+ *      u32 id | first_name | last_name | f32 GPA | u8 course_count | courses
+ *
+ *  with both names MAX_NAME_LENGTH bytes, NUL padded, and
+ *  MAX_COURSES course bytes. A student list is a u32 count
+ *  followed by count packed students. A batch reply is a u32
+ *  count followed by one entry per item of the request, in
+ *  request order.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define PROTOCOL_HEADER_SIZE     12
+#define PROTOCOL_STUDENT_SIZE    (4 + 2 * MAX_NAME_LENGTH + 4 + 1 + MAX_COURSES)
+#define PROTOCOL_MAX_PAYLOAD     (1UL << 20)     /* Larger frames close the connection */
+#define PROTOCOL_MAX_RESULTS     4096            /* Students per list reply, page with offset */
+#define PROTOCOL_MAX_BATCH       4096            /* Items per multi-get or multi-put request */
+
+#if 4 + PROTOCOL_MAX_RESULTS * PROTOCOL_STUDENT_SIZE > PROTOCOL_MAX_PAYLOAD
+#error "A full student list must fit in PROTOCOL_MAX_PAYLOAD"
+#endif
+#if 4 + PROTOCOL_MAX_BATCH * (1 + PROTOCOL_STUDENT_SIZE) > PROTOCOL_MAX_PAYLOAD
+#error "A full batch must fit in PROTOCOL_MAX_PAYLOAD"
+#endif
+
+/* Requests and their payloads; replies carry the status and the result */
+typedef enum
+{
+    PROTOCOL_OP_PING = 1,           /* Empty -> empty */
+    PROTOCOL_OP_ADD,                /* Student -> empty */
+    PROTOCOL_OP_FIND_ID,            /* u32 id -> student */
+    PROTOCOL_OP_FIND_NAME,          /* u32 offset, u32 limit, first name bytes -> list */
+    PROTOCOL_OP_FIND_COURSES,       /* u16 all_of, u16 none_of, u32 offset, u32 limit -> list */
+    PROTOCOL_OP_UPDATE,             /* u8 Update_Mask_t, student with the ID and new values -> empty */
+    PROTOCOL_OP_DELETE,             /* u32 id -> empty */
+    PROTOCOL_OP_LIST,               /* u32 offset, u32 limit -> list */
+    PROTOCOL_OP_SHUTDOWN,           /* Empty -> empty, then the server stops */
+    PROTOCOL_OP_FIND_IDS,           /* u32 count, count u32 ids -> batch of u8 status, student */
+    PROTOCOL_OP_ADD_MANY            /* u32 count, count students -> batch of u8 status */
+} Protocol_Op_t;
+
+/* Frame header: u32 length | u8 op | u8 status | u16 reserved | u32 tag */
+typedef struct
+{
+    uint32_t length;                /* Payload bytes after the header */
+    uint8_t op;                     /* Protocol_Op_t of the request */
+    uint8_t status;                 /* F_Return_t of a reply, 0 in requests */
+    uint32_t tag;                   /* Chosen by the client, echoed in the reply */
+} Protocol_Header_t;
+
+/**
+ * @brief  Writes a 16-bit value little-endian.
+ *
+ * @param  out   Destination, 2 bytes.
+ * @param  value Value to write.
+ */
+void Protocol_Put_U16(uint8_t* out, uint16_t value);
+
+/**
+ * @brief  Reads a little-endian 16-bit value.
+ *
+ * @param  in Source, 2 bytes.
+ * @return The value.
+ */
+uint16_t Protocol_Get_U16(const uint8_t* in);
+
+/**
+ * @brief  Writes a 32-bit value little-endian.
+ *
+ * @param  out   Destination, 4 bytes.
+ * @param  value Value to write, only its low 32 bits.
+ */
+void Protocol_Put_U32(uint8_t* out, uint32_t value);
+
+/**
+ * @brief  Reads a little-endian 32-bit value.
+ *
+ * @param  in Source, 4 bytes.
+ * @return The value.
+ */
+uint32_t Protocol_Get_U32(const uint8_t* in);
+
+/**
+ * @brief  Packs a frame header.
+ *
+ * @param  out    Destination, PROTOCOL_HEADER_SIZE bytes.
+ * @param  header Header to pack.
+ */
+void Protocol_Put_Header(uint8_t* out, const Protocol_Header_t* header);
+
+/**
+ * @brief  Unpacks a frame header.
+ *
+ * @param  in     Source, PROTOCOL_HEADER_SIZE bytes.
+ * @param  header Header to fill.
+ */
+void Protocol_Get_Header(const uint8_t* in, Protocol_Header_t* header);
+
+/**
+ * @brief  Packs a student.
+ *
+ * @param  out     Destination, PROTOCOL_STUDENT_SIZE bytes.
+ * @param  student Student to pack.
+ */
+void Protocol_Put_Student(uint8_t* out, const Student_t* student);
+
+/**
+ * @brief  Unpacks a student.
+ *
+ * @details
+ * - Terminates both names and caps the course count, so a bad
+ *   frame cannot produce an unterminated or oversized record.
+ * - The student comes out active.
+ *
+ * @param  in      Source, PROTOCOL_STUDENT_SIZE bytes.
+ * @param  student Student to fill.
+ */
+void Protocol_Get_Student(const uint8_t* in, Student_t* student);
+
+#endif // !_Protocol_H_
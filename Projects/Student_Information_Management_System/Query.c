@@ -0,0 +1,579 @@
+#include "Query.h"
+#include "Storage.h"
+#include "Column_Store.h"
+#include "Name_Index.h"
+#include "Course_Index.h"
+#include "Trigram_Index.h"
+#include "GPA_Index.h"
+#include "Platform.h"
+
+/* Where a cursor takes its matches from */
+#define QUERY_SOURCE_SLOTS       0      /* Slot list collected at open */
+#define QUERY_SOURCE_COLUMNS     1      /* Filter tested on the column store */
+#define QUERY_SOURCE_RECORDS     2      /* Filter tested on the mapped records */
+
+/* Test applied by the scanning sources */
+#define QUERY_FILTER_ALL         0
+#define QUERY_FILTER_FIRST_NAME  1
+#define QUERY_FILTER_COURSES     2
+#define QUERY_FILTER_NAME        3
+
+static void Open_Cursor(Query_Cursor_t* cursor, uint8_t source, uint8_t filter, uint32_t offset, uint32_t limit)
+{
+    my_memset(cursor, 0, sizeof(Query_Cursor_t));
+    cursor->source = source;
+    cursor->filter = filter;
+    cursor->skip = offset;
+    cursor->remaining = (limit == QUERY_NO_LIMIT) ? 0xFFFFFFFFUL : limit;
+}
+
+/* Matches an index may stop collecting after */
+static uint32_t Collect_Limit(const Query_Cursor_t* cursor)
+{
+    uint32_t wanted = cursor->skip + cursor->remaining;
+    return (wanted < cursor->skip) ? 0xFFFFFFFFUL : wanted;
+}
+
+/* Index visitor: appends a matching slot to the cursor */
+static bool Collect_Slot(uint32_t slot, void* context)
+{
+    Query_Cursor_t* cursor = context;
+    uint32_t limit = Collect_Limit(cursor);
+
+    if (cursor->slot_count >= limit)
+        return false;
+
+    /* Grow by doubling; position holds the capacity while collecting */
+    if (cursor->slot_count == cursor->position)
+    {
+        uint32_t capacity = (cursor->position) ? 2 * cursor->position : 256;
+        uint32_t* grown = realloc(cursor->slots, capacity * sizeof(uint32_t));
+        if (!grown)
+            return false;
+        cursor->slots = grown;
+        cursor->position = capacity;
+    }
+    cursor->slots[cursor->slot_count++] = slot;
+    return cursor->slot_count < limit;
+}
+
+/* Same for the indexes whose visitors cannot stop the walk */
+static void Collect_Every_Slot(uint32_t slot, void* context)
+{
+    Collect_Slot(slot, context);
+}
+
+/* Collection is over: position goes back to reading the slots */
+static F_Return_t Collected(Query_Cursor_t* cursor)
+{
+    cursor->position = 0;
+    return F_OK;
+}
+
+/* An opened cursor keeps the shared lock until Query_Close, a failed one drops it */
+static F_Return_t Keep_Lock(Query_Cursor_t* cursor, F_Return_t status)
+{
+    if (status == F_OK)
+        cursor->locked = 1;
+    else
+        System_Unlock();
+    return status;
+}
+
+/* Compares a stored first name, once normalized, with the cursor text */
+static bool First_Name_Matches(const Query_Cursor_t* cursor, const char* first_name)
+{
+    char normalized[MAX_NAME_LENGTH];
+
+    Name_Normalize(first_name, normalized);
+    uint32_t length = (uint32_t)my_strlen(normalized);
+    return length == cursor->text_length &&
+           my_memcmp(normalized, cursor->text, (int)length) == 0;
+}
+
+/* Tests a scanned record against the cursor filter */
+static bool Record_Matches(const Query_Cursor_t* cursor, const Student_t* student)
+{
+    switch (cursor->filter)
+    {
+    case QUERY_FILTER_FIRST_NAME:
+        return First_Name_Matches(cursor, student->first_name);
+
+    case QUERY_FILTER_COURSES:
+    {
+        Course_Mask_t mask = Column_Course_Mask(student);
+        return (mask & cursor->all_of) == cursor->all_of && !(mask & cursor->none_of);
+    }
+
+    case QUERY_FILTER_NAME:
+        return Trigram_Index_Matches(student, cursor->text, cursor->match);
+
+    default:
+        return true;
+    }
+}
+
+/* Tests a slot of the column store against the cursor filter */
+static bool Column_Matches(const Query_Cursor_t* cursor, const Column_View_t* columns, uint32_t slot)
+{
+    if (cursor->filter == QUERY_FILTER_FIRST_NAME)
+    {
+        return First_Name_Matches(cursor, columns->first_names[slot]);
+    }
+
+    Course_Mask_t mask = columns->courses[slot];
+    return (mask & cursor->all_of) == cursor->all_of && !(mask & cursor->none_of);
+}
+
+/*
+ * Advances a scanning cursor to its next match. The view is taken
+ * again on every call, so writes between two calls are seen.
+ */
+static bool Scan_Next(Query_Cursor_t* cursor, uint32_t* slot)
+{
+    if (cursor->source == QUERY_SOURCE_COLUMNS)
+    {
+        Column_View_t columns;
+        if (Column_Store_Map(&columns) != F_OK)
+            return false;
+
+        /* Column scan: the full record is only read for matches */
+        while (cursor->position < columns.count)
+        {
+            uint32_t candidate = cursor->position++;
+            if (columns.is_active[candidate] && Column_Matches(cursor, &columns, candidate))
+            {
+                *slot = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* Scan the memory-mapped records, no per-record read calls */
+    const Student_t* records;
+    uint32_t count;
+    if (Storage_Map(&records, &count) != F_OK)
+        return false;
+
+    while (cursor->position < count)
+    {
+        uint32_t candidate = cursor->position++;
+        if (records[candidate].is_active && Record_Matches(cursor, &records[candidate]))
+        {
+            *slot = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* One contiguous range of slots filtered by a scan thread */
+typedef struct
+{
+    const Query_Cursor_t* cursor;
+    const Student_t* records;           /* Scanned records, NULL when scanning columns */
+    const Column_View_t* columns;
+    uint32_t first;                     /* First slot of the range */
+    uint32_t end;                       /* One past the last slot */
+    uint32_t* matches;                  /* Output, the range's own part of the slot list */
+    uint32_t match_count;
+} Scan_Chunk_t;
+
+static void Scan_Chunk(void* argument)
+{
+    Scan_Chunk_t* chunk = argument;
+
+    for (uint32_t slot = chunk->first; slot < chunk->end; slot++)
+    {
+        bool matches = (chunk->records)
+            ? chunk->records[slot].is_active && Record_Matches(chunk->cursor, &chunk->records[slot])
+            : chunk->columns->is_active[slot] && Column_Matches(chunk->cursor, chunk->columns, slot);
+        if (matches)
+            chunk->matches[chunk->match_count++] = slot;
+    }
+}
+
+/*
+ * Runs a whole scan on worker threads and turns the cursor into a
+ * slot list. Left as a lazy scan when it is limited, small, or the
+ * threads cannot be had.
+ */
+static void Scan_Parallel(Query_Cursor_t* cursor)
+{
+    Scan_Chunk_t chunks[QUERY_PARALLEL_MAX_THREADS];
+    Platform_Thread_t threads[QUERY_PARALLEL_MAX_THREADS];
+    bool started[QUERY_PARALLEL_MAX_THREADS];
+    Column_View_t columns;
+    const Student_t* records = NULL;
+    uint32_t count, thread_count, matches = 0;
+
+    /* A limited scan stops at its last match, which a split scan cannot */
+    if (!QUERY_PARALLEL_ENABLED || cursor->remaining != 0xFFFFFFFFUL)
+        return;
+
+    if (cursor->source == QUERY_SOURCE_COLUMNS)
+    {
+        if (Column_Store_Map(&columns) != F_OK)
+            return;
+        count = columns.count;
+    }
+    else if (Storage_Map(&records, &count) != F_OK)
+    {
+        return;
+    }
+    if (count < QUERY_PARALLEL_MIN_RECORDS)
+        return;
+
+    thread_count = Platform_CPU_Count();
+    if (thread_count > QUERY_PARALLEL_MAX_THREADS)
+        thread_count = QUERY_PARALLEL_MAX_THREADS;
+    if (thread_count < 2)
+        return;
+
+    /* Every chunk writes its matches where its own slots start, so no chunk can overflow */
+    uint32_t* slots = malloc(count * sizeof(uint32_t));
+    if (!slots)
+        return;
+
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        chunks[i].cursor = cursor;
+        chunks[i].records = records;
+        chunks[i].columns = &columns;
+        chunks[i].first = (uint32_t)((uint64_t)count * i / thread_count);
+        chunks[i].end = (uint32_t)((uint64_t)count * (i + 1) / thread_count);
+        chunks[i].matches = slots + chunks[i].first;
+        chunks[i].match_count = 0;
+    }
+
+    /* The calling thread takes the first chunk, and any chunk whose thread failed to start */
+    for (uint32_t i = 1; i < thread_count; i++)
+        started[i] = (Platform_Thread_Start(&threads[i], Scan_Chunk, &chunks[i]) == 0);
+    Scan_Chunk(&chunks[0]);
+    for (uint32_t i = 1; i < thread_count; i++)
+    {
+        if (started[i])
+            Platform_Thread_Join(&threads[i]);
+        else
+            Scan_Chunk(&chunks[i]);
+    }
+
+    /* Merge in chunk order: the list stays in slot order */
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        for (uint32_t j = 0; j < chunks[i].match_count; j++)
+            slots[matches++] = chunks[i].matches[j];
+    }
+
+    cursor->source = QUERY_SOURCE_SLOTS;
+    cursor->slots = slots;
+    cursor->slot_count = matches;
+    cursor->position = 0;
+}
+
+/**
+ * @brief  Opens a cursor over every active student, in slot order.
+ *
+ * @param  cursor Cursor to open.
+ * @param  offset Number of matches to skip.
+ * @param  limit  Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, otherwise error code.
+ */
+F_Return_t Query_All(Query_Cursor_t* cursor, uint32_t offset, uint32_t limit)
+{
+    if (!cursor)
+        return F_NOT_OK;
+
+    if (System_Lock(false) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    Open_Cursor(cursor, QUERY_SOURCE_RECORDS, QUERY_FILTER_ALL, offset, limit);
+    return Keep_Lock(cursor, F_OK);
+}
+
+/**
+ * @brief  Opens a cursor over the students with a first name.
+ *
+ * @details
+ * - Matches names case-insensitively, ignoring surrounding spaces.
+ * - Uses the first name hash index, falling back to scanning the
+ *   name column or the records.
+ *
+ * @param  cursor Cursor to open.
+ * @param  fname  First name to search for.
+ * @param  offset Number of matches to skip.
+ * @param  limit  Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, otherwise error code.
+ */
+F_Return_t Query_By_First_Name(Query_Cursor_t* cursor, const char* fname, uint32_t offset, uint32_t limit)
+{
+    Column_View_t columns;
+
+    if (!cursor || !fname)
+        return F_NOT_OK;
+
+    if (System_Lock(false) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    Open_Cursor(cursor, QUERY_SOURCE_SLOTS, QUERY_FILTER_FIRST_NAME, offset, limit);
+    if (Name_Index_Find(fname, Collect_Every_Slot, cursor) == F_OK)
+        return Keep_Lock(cursor, Collected(cursor));
+    Query_Close(cursor);
+
+    Open_Cursor(cursor, (Column_Store_Map(&columns) == F_OK) ? QUERY_SOURCE_COLUMNS : QUERY_SOURCE_RECORDS,
+                QUERY_FILTER_FIRST_NAME, offset, limit);
+    Name_Normalize(fname, cursor->text);
+    cursor->text_length = (uint32_t)my_strlen(cursor->text);
+    Scan_Parallel(cursor);
+    return Keep_Lock(cursor, F_OK);
+}
+
+/**
+ * @brief  Opens a cursor over the students of a course combination.
+ *
+ * @details
+ * - Uses the course bitmaps, falling back to scanning the course
+ *   column or the records.
+ *
+ * @param  cursor  Cursor to open.
+ * @param  all_of  Courses the student must take (bit n = course n).
+ * @param  none_of Courses the student must not take.
+ * @param  offset  Number of matches to skip.
+ * @param  limit   Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, F_COURSE_NOT_FOUND for course 0,
+ *         otherwise error code.
+ */
+F_Return_t Query_By_Courses(Query_Cursor_t* cursor, Course_Mask_t all_of, Course_Mask_t none_of, uint32_t offset, uint32_t limit)
+{
+    Column_View_t columns;
+
+    if (!cursor)
+        return F_NOT_OK;
+
+    /* Course ID 0 is not a real course */
+    if (all_of & 1)
+        return F_COURSE_NOT_FOUND;
+    none_of &= (Course_Mask_t)~1u;
+
+    if (System_Lock(false) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    Open_Cursor(cursor, QUERY_SOURCE_SLOTS, QUERY_FILTER_COURSES, offset, limit);
+    if (Course_Index_Query(all_of, none_of, Collect_Every_Slot, cursor) == F_OK)
+        return Keep_Lock(cursor, Collected(cursor));
+    Query_Close(cursor);
+
+    Open_Cursor(cursor, (Column_Store_Map(&columns) == F_OK) ? QUERY_SOURCE_COLUMNS : QUERY_SOURCE_RECORDS,
+                QUERY_FILTER_COURSES, offset, limit);
+    cursor->all_of = all_of;
+    cursor->none_of = none_of;
+    Scan_Parallel(cursor);
+    return Keep_Lock(cursor, F_OK);
+}
+
+/**
+ * @brief  Opens a cursor over a type-ahead search on first and last names.
+ *
+ * @details
+ * - Uses the trigram index, falling back to scanning the records.
+ * - Yields matches in slot order.
+ *
+ * @param  cursor Cursor to open.
+ * @param  text   Text to search for.
+ * @param  match  NAME_MATCH_PREFIX or NAME_MATCH_SUBSTRING.
+ * @param  offset Number of matches to skip.
+ * @param  limit  Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, otherwise error code.
+ */
+F_Return_t Query_By_Name(Query_Cursor_t* cursor, const char* text, Name_Match_t match, uint32_t offset, uint32_t limit)
+{
+    if (!cursor || !text)
+        return F_NOT_OK;
+
+    if (System_Lock(false) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    Open_Cursor(cursor, QUERY_SOURCE_SLOTS, QUERY_FILTER_NAME, offset, limit);
+    if (Trigram_Index_Query(text, match, Collect_Slot, cursor) == F_OK)
+        return Keep_Lock(cursor, Collected(cursor));
+    Query_Close(cursor);
+
+    Open_Cursor(cursor, QUERY_SOURCE_RECORDS, QUERY_FILTER_NAME, offset, limit);
+    Name_Normalize(text, cursor->text);
+    cursor->text_length = (uint32_t)my_strlen(cursor->text);
+    cursor->match = match;
+
+    /* An empty text matches nothing */
+    if (cursor->text_length == 0)
+        cursor->remaining = 0;
+    Scan_Parallel(cursor);
+    return Keep_Lock(cursor, F_OK);
+}
+
+static const Student_t* sorted_records;
+
+static int Compare_Slots_By_GPA(const void* a, const void* b)
+{
+    const Student_t* x = &sorted_records[*(const uint32_t*)a];
+    const Student_t* y = &sorted_records[*(const uint32_t*)b];
+    if (x->GPA != y->GPA)
+        return (x->GPA < y->GPA) ? -1 : 1;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+/* Sorts the active records by GPA when the GPA index is unavailable */
+static F_Return_t Sort_By_GPA(Query_Cursor_t* cursor, bool ranged, float min_gpa, float max_gpa, bool descending)
+{
+    const Student_t* records;
+    uint32_t count, matches = 0;
+
+    if (Storage_Map(&records, &count) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    cursor->slots = malloc((count ? count : 1) * sizeof(uint32_t));
+    if (!cursor->slots)
+        return F_NOT_OK;
+
+    for (uint32_t slot = 0; slot < count; slot++)
+    {
+        if (records[slot].is_active && (!ranged || (records[slot].GPA >= min_gpa && records[slot].GPA <= max_gpa)))
+            cursor->slots[matches++] = slot;
+    }
+
+    sorted_records = records;
+    qsort(cursor->slots, matches, sizeof(uint32_t), Compare_Slots_By_GPA);
+
+    if (descending)
+    {
+        for (uint32_t i = 0; i < matches / 2; i++)
+        {
+            uint32_t slot = cursor->slots[i];
+            cursor->slots[i] = cursor->slots[matches - 1 - i];
+            cursor->slots[matches - 1 - i] = slot;
+        }
+    }
+    cursor->slot_count = matches;
+    return F_OK;
+}
+
+/**
+ * @brief  Opens a cursor over the students whose GPA lies in a range.
+ *
+ * @details
+ * - Yields students by increasing GPA, then ID, from the GPA skip
+ *   list, or from a sort of the records when it is unavailable.
+ *
+ * @param  cursor  Cursor to open.
+ * @param  min_gpa Lowest GPA in range.
+ * @param  max_gpa Highest GPA in range.
+ * @param  offset  Number of matches to skip.
+ * @param  limit   Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, otherwise error code.
+ */
+F_Return_t Query_By_GPA_Range(Query_Cursor_t* cursor, float min_gpa, float max_gpa, uint32_t offset, uint32_t limit)
+{
+    if (!cursor)
+        return F_NOT_OK;
+
+    if (System_Lock(false) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    Open_Cursor(cursor, QUERY_SOURCE_SLOTS, QUERY_FILTER_ALL, offset, limit);
+    if (GPA_Index_Range(min_gpa, max_gpa, Collect_Slot, cursor) == F_OK)
+        return Keep_Lock(cursor, Collected(cursor));
+    Query_Close(cursor);
+
+    Open_Cursor(cursor, QUERY_SOURCE_SLOTS, QUERY_FILTER_ALL, offset, limit);
+    return Keep_Lock(cursor, Sort_By_GPA(cursor, true, min_gpa, max_gpa, false));
+}
+
+/**
+ * @brief  Opens a cursor over the students by decreasing GPA.
+ *
+ * @param  cursor Cursor to open.
+ * @param  offset Number of matches to skip.
+ * @param  limit  Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, otherwise error code.
+ */
+F_Return_t Query_Top_By_GPA(Query_Cursor_t* cursor, uint32_t offset, uint32_t limit)
+{
+    if (!cursor)
+        return F_NOT_OK;
+
+    if (System_Lock(false) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    Open_Cursor(cursor, QUERY_SOURCE_SLOTS, QUERY_FILTER_ALL, offset, limit);
+    if (GPA_Index_Top(Collect_Limit(cursor), Collect_Slot, cursor) == F_OK)
+        return Keep_Lock(cursor, Collected(cursor));
+    Query_Close(cursor);
+
+    Open_Cursor(cursor, QUERY_SOURCE_SLOTS, QUERY_FILTER_ALL, offset, limit);
+    return Keep_Lock(cursor, Sort_By_GPA(cursor, false, 0, 0, true));
+}
+
+/**
+ * @brief  Yields the next matching student.
+ *
+ * @param  cursor  Open cursor.
+ * @param  student Pointer to store the record.
+ * @param  slot    Pointer to store the record slot, may be NULL.
+ * @return true if a record was stored, false once the query is exhausted.
+ */
+bool Query_Next(Query_Cursor_t* cursor, Student_t* student, uint32_t* slot)
+{
+    uint32_t match;
+
+    if (!cursor || !student)
+        return false;
+
+    while (cursor->remaining > 0)
+    {
+        if (cursor->source == QUERY_SOURCE_SLOTS)
+        {
+            if (cursor->position >= cursor->slot_count)
+                return false;
+            match = cursor->slots[cursor->position++];
+        }
+        else if (!Scan_Next(cursor, &match))
+        {
+            return false;
+        }
+
+        /* Index hits are read to be returned anyway, check they are still live */
+        if (Storage_Read(match, student) != F_OK || !student->is_active)
+            continue;
+
+        if (cursor->skip > 0)
+        {
+            cursor->skip--;
+            continue;
+        }
+
+        cursor->remaining--;
+        if (slot)
+            *slot = match;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief  Releases the memory and the lock held by a cursor.
+ *
+ * @param  cursor Cursor to close.
+ */
+void Query_Close(Query_Cursor_t* cursor)
+{
+    if (!cursor)
+        return;
+
+    free(cursor->slots);
+    cursor->slots = NULL;
+    cursor->slot_count = 0;
+    cursor->remaining = 0;
+    if (cursor->locked)
+        System_Unlock();
+    cursor->locked = 0;
+}
@@ -0,0 +1,166 @@
+#ifndef _Query_H_
+#define _Query_H_
+
+/* ============================================================
+ *  Query Cursors
+ *
+ *  Description:
+ *  Streams the students matching a query one record at a time,
+ *  with an optional offset and limit, instead of printing them
+ *  from inside the scan. A query is opened on a cursor, read
+ *  with Query_Next until it returns false, then closed; what is
+ *  done with each record is up to the caller.
+ *
+ *  Scans advance lazily, one match per call. Queries answered
+ *  by an index collect the matching slots first, stopping at
+ *  offset + limit matches where the index allows it.
+ *
+ *  Unlimited filtered scans of large databases are split into
+ *  contiguous chunks filtered on worker threads; the matches are
+ *  merged back in slot order, so results come in the same order
+ *  as from the lazy scan.
+ *
+ *  An open cursor holds the shared database lock: writers in
+ *  other processes wait until it is closed, and a writer in this
+ *  process fails until then.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define QUERY_NO_LIMIT               0        /* Limit value yielding every match */
+
+#define QUERY_PARALLEL_ENABLED       1
+#define QUERY_PARALLEL_MIN_RECORDS   65536    /* Smaller scans stay on the calling thread */
+#define QUERY_PARALLEL_MAX_THREADS   16       /* Threads per scan, the caller included */
+
+/**
+ * @brief  State of an open query.
+ *
+ * @details
+ * - Filled by the Query_ open functions; the fields are private
+ *   to Query.c.
+ * - Valid until Query_Close.
+ */
+typedef struct
+{
+    uint8_t source;                 /* Where matches come from */
+    uint8_t filter;                 /* Test applied by scanning sources */
+    Name_Match_t match;             /* Name search mode */
+    Course_Mask_t all_of;           /* Course filter */
+    Course_Mask_t none_of;
+    char text[MAX_NAME_LENGTH];     /* Normalized name of name filters */
+    uint32_t text_length;
+    uint32_t* slots;                /* Matches collected from an index */
+    uint32_t slot_count;
+    uint32_t position;              /* Next slot to scan, or next entry of slots */
+    uint32_t skip;                  /* Matches still to skip for the offset */
+    uint32_t remaining;             /* Matches still to yield */
+    uint8_t locked;                 /* Holds the shared lock until Query_Close */
+} Query_Cursor_t;
+
+/**
+ * @brief  Opens a cursor over every active student, in slot order.
+ *
+ * @param  cursor Cursor to open.
+ * @param  offset Number of matches to skip.
+ * @param  limit  Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, otherwise error code.
+ */
+F_Return_t Query_All(Query_Cursor_t* cursor, uint32_t offset, uint32_t limit);
+
+/**
+ * @brief  Opens a cursor over the students with a first name.
+ *
+ * @details
+ * - Matches names case-insensitively, ignoring surrounding spaces.
+ * - Uses the first name hash index, falling back to scanning the
+ *   name column or the records.
+ *
+ * @param  cursor Cursor to open.
+ * @param  fname  First name to search for.
+ * @param  offset Number of matches to skip.
+ * @param  limit  Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, otherwise error code.
+ */
+F_Return_t Query_By_First_Name(Query_Cursor_t* cursor, const char* fname, uint32_t offset, uint32_t limit);
+
+/**
+ * @brief  Opens a cursor over the students of a course combination.
+ *
+ * @details
+ * - Uses the course bitmaps, falling back to scanning the course
+ *   column or the records.
+ *
+ * @param  cursor  Cursor to open.
+ * @param  all_of  Courses the student must take (bit n = course n).
+ * @param  none_of Courses the student must not take.
+ * @param  offset  Number of matches to skip.
+ * @param  limit   Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, F_COURSE_NOT_FOUND for course 0,
+ *         otherwise error code.
+ */
+F_Return_t Query_By_Courses(Query_Cursor_t* cursor, Course_Mask_t all_of, Course_Mask_t none_of, uint32_t offset, uint32_t limit);
+
+/**
+ * @brief  Opens a cursor over a type-ahead search on first and last names.
+ *
+ * @details
+ * - Uses the trigram index, falling back to scanning the records.
+ * - Yields matches in slot order.
+ *
+ * @param  cursor Cursor to open.
+ * @param  text   Text to search for.
+ * @param  match  NAME_MATCH_PREFIX or NAME_MATCH_SUBSTRING.
+ * @param  offset Number of matches to skip.
+ * @param  limit  Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, otherwise error code.
+ */
+F_Return_t Query_By_Name(Query_Cursor_t* cursor, const char* text, Name_Match_t match, uint32_t offset, uint32_t limit);
+
+/**
+ * @brief  Opens a cursor over the students whose GPA lies in a range.
+ *
+ * @details
+ * - Yields students by increasing GPA, then ID, from the GPA skip
+ *   list, or from a sort of the records when it is unavailable.
+ *
+ * @param  cursor  Cursor to open.
+ * @param  min_gpa Lowest GPA in range.
+ * @param  max_gpa Highest GPA in range.
+ * @param  offset  Number of matches to skip.
+ * @param  limit   Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, otherwise error code.
+ */
+F_Return_t Query_By_GPA_Range(Query_Cursor_t* cursor, float min_gpa, float max_gpa, uint32_t offset, uint32_t limit);
+
+/**
+ * @brief  Opens a cursor over the students by decreasing GPA.
+ *
+ * @param  cursor Cursor to open.
+ * @param  offset Number of matches to skip.
+ * @param  limit  Maximum number of matches, QUERY_NO_LIMIT for all.
+ * @return F_OK if the cursor is open, otherwise error code.
+ */
+F_Return_t Query_Top_By_GPA(Query_Cursor_t* cursor, uint32_t offset, uint32_t limit);
+
+/**
+ * @brief  Yields the next matching student.
+ *
+ * @param  cursor  Open cursor.
+ * @param  student Pointer to store the record.
+ * @param  slot    Pointer to store the record slot, may be NULL.
+ * @return true if a record was stored, false once the query is exhausted.
+ */
+bool Query_Next(Query_Cursor_t* cursor, Student_t* student, uint32_t* slot);
+
+/**
+ * @brief  Releases the memory and the lock held by a cursor.
+ *
+ * @param  cursor Cursor to close.
+ */
+void Query_Close(Query_Cursor_t* cursor);
+
+#endif // !_Query_H_
@@ -0,0 +1,250 @@
+#include "Record_Cache.h"
+
+#define CACHE_NONE    0xFFFFFFFFUL      /* End of a hash chain */
+#define CACHE_MASK    (RECORD_CACHE_CAPACITY - 1)
+
+typedef struct
+{
+    uint32_t slot;
+    uint32_t next;              /* Next entry of the hash chain */
+    uint8_t in_use;
+    uint8_t referenced;         /* CLOCK bit, set on every hit */
+    uint8_t dirty;              /* Not written back yet: never evicted */
+    Student_t student;
+} Cache_Entry_t;
+
+/* Allocated on first use, released by Record_Cache_Clear */
+static Cache_Entry_t* entries = NULL;
+static uint32_t* buckets = NULL;        /* First entry of every hash chain */
+static uint32_t hand = 0;               /* CLOCK hand */
+static Record_Cache_Stats_t stats = { 0, 0, 0, 0, 0, RECORD_CACHE_CAPACITY };
+
+static uint32_t Bucket_Of(uint32_t slot)
+{
+    return (uint32_t)((slot * 2654435761UL) & CACHE_MASK);
+}
+
+static bool Allocate(void)
+{
+    if (entries)
+        return true;
+
+    entries = calloc(RECORD_CACHE_CAPACITY, sizeof(Cache_Entry_t));
+    buckets = malloc(RECORD_CACHE_CAPACITY * sizeof(uint32_t));
+    if (!entries || !buckets)
+    {
+        free(entries);
+        free(buckets);
+        entries = NULL;
+        buckets = NULL;
+        return false;
+    }
+    for (uint32_t i = 0; i < RECORD_CACHE_CAPACITY; i++)
+        buckets[i] = CACHE_NONE;
+    return true;
+}
+
+static uint32_t Find(uint32_t slot)
+{
+    uint32_t i = buckets[Bucket_Of(slot)];
+    while (i != CACHE_NONE && entries[i].slot != slot)
+        i = entries[i].next;
+    return i;
+}
+
+static void Unlink(uint32_t index)
+{
+    Cache_Entry_t* entry = &entries[index];
+    uint32_t* link = &buckets[Bucket_Of(entry->slot)];
+
+    while (*link != index)
+        link = &entries[*link].next;
+    *link = entry->next;
+
+    if (entry->dirty)
+        stats.dirty--;
+    entry->in_use = 0;
+    entry->dirty = 0;
+    stats.cached--;
+}
+
+/* Sweeps the CLOCK hand to a free entry, evicting a clean unreferenced one if needed */
+static uint32_t Take_Entry(void)
+{
+    /* Two turns clear every reference bit, a third finds nothing only if all are dirty */
+    for (uint32_t step = 0; step < 3 * RECORD_CACHE_CAPACITY; step++)
+    {
+        uint32_t index = hand;
+        Cache_Entry_t* entry = &entries[index];
+        hand = (hand + 1) & CACHE_MASK;
+
+        if (!entry->in_use)
+            return index;
+        if (entry->dirty)
+            continue;
+        if (entry->referenced)
+        {
+            entry->referenced = 0;
+            continue;
+        }
+
+        Unlink(index);
+        stats.evictions++;
+        return index;
+    }
+    return CACHE_NONE;
+}
+
+/**
+ * @brief  Looks a record up in the cache.
+ *
+ * @details
+ * - Counts a hit or a miss.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Pointer to store the record on a hit.
+ * @return true on a hit.
+ */
+bool Record_Cache_Get(uint32_t slot, Student_t* student)
+{
+    if (!RECORD_CACHE_ENABLED || !entries)
+    {
+        stats.misses++;
+        return false;
+    }
+
+    uint32_t index = Find(slot);
+    if (index == CACHE_NONE)
+    {
+        stats.misses++;
+        return false;
+    }
+
+    entries[index].referenced = 1;
+    *student = entries[index].student;
+    stats.hits++;
+    return true;
+}
+
+/**
+ * @brief  Stores the current image of a record.
+ *
+ * @details
+ * - Replaces the cached image of the slot, or takes an entry,
+ *   evicting a clean one if the cache is full.
+ * - A dirty image stays dirty until Record_Cache_Mark_Clean.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record image.
+ * @param  dirty   true for a change not yet written to the file.
+ * @return F_OK if cached, F_NOT_OK if every entry is dirty.
+ */
+F_Return_t Record_Cache_Put(uint32_t slot, const Student_t* student, bool dirty)
+{
+    if (!RECORD_CACHE_ENABLED || !Allocate())
+        return F_NOT_OK;
+
+    uint32_t index = Find(slot);
+    if (index == CACHE_NONE)
+    {
+        index = Take_Entry();
+        if (index == CACHE_NONE)
+            return F_NOT_OK;
+
+        Cache_Entry_t* entry = &entries[index];
+        entry->slot = slot;
+        entry->in_use = 1;
+        entry->referenced = 0;
+        entry->dirty = 0;
+        entry->next = buckets[Bucket_Of(slot)];
+        buckets[Bucket_Of(slot)] = index;
+        stats.cached++;
+    }
+
+    Cache_Entry_t* entry = &entries[index];
+    entry->student = *student;
+    if (dirty && !entry->dirty)
+    {
+        entry->dirty = 1;
+        stats.dirty++;
+    }
+    return F_OK;
+}
+
+/**
+ * @brief  Marks a record as written back to the file.
+ *
+ * @param  slot Record slot number.
+ */
+void Record_Cache_Mark_Clean(uint32_t slot)
+{
+    if (!entries)
+        return;
+
+    uint32_t index = Find(slot);
+    if (index != CACHE_NONE && entries[index].dirty)
+    {
+        entries[index].dirty = 0;
+        stats.dirty--;
+    }
+}
+
+/**
+ * @brief  Forgets a record, dirty or not.
+ *
+ * @param  slot Record slot number.
+ */
+void Record_Cache_Drop(uint32_t slot)
+{
+    if (!entries)
+        return;
+
+    uint32_t index = Find(slot);
+    if (index != CACHE_NONE)
+        Unlink(index);
+}
+
+/**
+ * @brief  Forgets every record at or past a slot.
+ *
+ * @details
+ * - Used when the database file is truncated.
+ *
+ * @param  first_slot First slot to forget.
+ */
+void Record_Cache_Drop_From(uint32_t first_slot)
+{
+    if (!entries)
+        return;
+
+    for (uint32_t i = 0; i < RECORD_CACHE_CAPACITY; i++)
+    {
+        if (entries[i].in_use && entries[i].slot >= first_slot)
+            Unlink(i);
+    }
+}
+
+/**
+ * @brief  Empties the cache, releases its memory and resets the counters.
+ */
+void Record_Cache_Clear(void)
+{
+    free(entries);
+    free(buckets);
+    entries = NULL;
+    buckets = NULL;
+    hand = 0;
+    my_memset(&stats, 0, sizeof(stats));
+    stats.capacity = RECORD_CACHE_CAPACITY;
+}
+
+/**
+ * @brief  Returns the cache counters.
+ *
+ * @param  counters Pointer to store the counters.
+ */
+void Record_Cache_Get_Stats(Record_Cache_Stats_t* counters)
+{
+    if (counters)
+        *counters = stats;
+}
@@ -0,0 +1,106 @@
+#ifndef _Record_Cache_H_
+#define _Record_Cache_H_
+
+/* ============================================================
+ *  Record Cache
+ *
+ *  Description:
+ *  Fixed-size cache of student records in front of the database
+ *  file, keyed by record slot. Repeated lookups of the same
+ *  students are served from memory without touching the file.
+ *
+ *  Entries are found through a chained hash table and replaced
+ *  with the CLOCK algorithm: every hit sets a reference bit, and
+ *  the sweeping hand evicts the first entry whose bit is clear,
+ *  clearing the bits it passes. Dirty entries hold changes that
+ *  are not written back to the file yet; they are never evicted
+ *  and become clean once storage writes them back at commit.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define RECORD_CACHE_ENABLED     1
+#define RECORD_CACHE_CAPACITY    4096        /* Cached records, a power of two */
+
+#if (RECORD_CACHE_CAPACITY & (RECORD_CACHE_CAPACITY - 1)) != 0
+#error "RECORD_CACHE_CAPACITY must be a power of two"
+#endif
+
+/* Cache counters since the database was opened */
+typedef struct
+{
+    uint64_t hits;              /* Lookups served from the cache */
+    uint64_t misses;            /* Lookups that went to the file */
+    uint64_t evictions;         /* Clean entries replaced */
+    uint32_t cached;            /* Entries in use */
+    uint32_t dirty;             /* Entries waiting for write-back */
+    uint32_t capacity;          /* RECORD_CACHE_CAPACITY */
+} Record_Cache_Stats_t;
+
+/**
+ * @brief  Looks a record up in the cache.
+ *
+ * @details
+ * - Counts a hit or a miss.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Pointer to store the record on a hit.
+ * @return true on a hit.
+ */
+bool Record_Cache_Get(uint32_t slot, Student_t* student);
+
+/**
+ * @brief  Stores the current image of a record.
+ *
+ * @details
+ * - Replaces the cached image of the slot, or takes an entry,
+ *   evicting a clean one if the cache is full.
+ * - A dirty image stays dirty until Record_Cache_Mark_Clean.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record image.
+ * @param  dirty   true for a change not yet written to the file.
+ * @return F_OK if cached, F_NOT_OK if every entry is dirty.
+ */
+F_Return_t Record_Cache_Put(uint32_t slot, const Student_t* student, bool dirty);
+
+/**
+ * @brief  Marks a record as written back to the file.
+ *
+ * @param  slot Record slot number.
+ */
+void Record_Cache_Mark_Clean(uint32_t slot);
+
+/**
+ * @brief  Forgets a record, dirty or not.
+ *
+ * @param  slot Record slot number.
+ */
+void Record_Cache_Drop(uint32_t slot);
+
+/**
+ * @brief  Forgets every record at or past a slot.
+ *
+ * @details
+ * - Used when the database file is truncated.
+ *
+ * @param  first_slot First slot to forget.
+ */
+void Record_Cache_Drop_From(uint32_t first_slot);
+
+/**
+ * @brief  Empties the cache, releases its memory and resets the counters.
+ */
+void Record_Cache_Clear(void);
+
+/**
+ * @brief  Returns the cache counters.
+ *
+ * @param  counters Pointer to store the counters.
+ */
+void Record_Cache_Get_Stats(Record_Cache_Stats_t* counters);
+
+#endif // !_Record_Cache_H_
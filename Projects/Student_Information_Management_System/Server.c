@@ -0,0 +1,413 @@
+#include "Server.h"
+#include "Protocol.h"
+#include "Query.h"
+#include "Platform.h"
+#include "Platform_Socket.h"
+#include <string.h>
+
+#if SERVER_MAX_CLIENTS + 1 > PLATFORM_POLL_MAX
+#error "The listener and every client must fit in one Platform_Wait_Readable call"
+#endif
+
+typedef struct
+{
+    Platform_Socket_t socket;
+    uint8_t* buffer;                /* Received bytes not handled yet */
+    uint32_t used;
+    uint32_t capacity;
+} Connection_t;
+
+static Connection_t connections[SERVER_MAX_CLIENTS];
+static uint32_t connection_count = 0;
+
+/* Replies to the frames of one receive, sent together */
+static uint8_t* reply = NULL;
+static uint32_t reply_length = 0;
+static uint32_t reply_capacity = 0;
+
+/* Multi-get scratch */
+static uint32_t batch_ids[PROTOCOL_MAX_BATCH];
+static Student_t batch_students[PROTOCOL_MAX_BATCH];
+static F_Return_t batch_results[PROTOCOL_MAX_BATCH];
+
+static bool stopping = false;
+static uint64_t served = 0;
+
+static F_Return_t Reserve_Reply(uint32_t bytes)
+{
+    uint32_t capacity = reply_capacity ? reply_capacity : 4096;
+
+    if (reply_length + bytes <= reply_capacity)
+        return F_OK;
+    while (capacity < reply_length + bytes)
+        capacity *= 2;
+
+    uint8_t* grown = realloc(reply, capacity);
+    if (!grown)
+        return F_NOT_OK;
+    reply = grown;
+    reply_capacity = capacity;
+    return F_OK;
+}
+
+static F_Return_t Reply_Student(const Student_t* student)
+{
+    if (Reserve_Reply(PROTOCOL_STUDENT_SIZE) != F_OK)
+        return F_NOT_OK;
+    Protocol_Put_Student(reply + reply_length, student);
+    reply_length += PROTOCOL_STUDENT_SIZE;
+    return F_OK;
+}
+
+/* Appends what an open cursor yields as a student list and closes it */
+static F_Return_t Reply_Cursor(Query_Cursor_t* cursor, F_Return_t none_found)
+{
+    Student_t student;
+    uint32_t count = 0;
+    uint32_t count_at = reply_length;
+    F_Return_t status = Reserve_Reply(4);
+
+    if (status == F_OK)
+        reply_length += 4;
+    while (status == F_OK && Query_Next(cursor, &student, NULL))
+    {
+        status = Reply_Student(&student);
+        count++;
+    }
+    Query_Close(cursor);
+
+    if (status != F_OK)
+        return status;
+    Protocol_Put_U32(reply + count_at, count);
+    return count ? F_OK : none_found;
+}
+
+/* Lists are sent in pages of at most PROTOCOL_MAX_RESULTS students */
+static uint32_t Page_Limit(uint32_t limit)
+{
+    return (limit == QUERY_NO_LIMIT || limit > PROTOCOL_MAX_RESULTS) ? PROTOCOL_MAX_RESULTS : limit;
+}
+
+/* Looks up every ID of the request with one pass over the ID index */
+static F_Return_t Find_Batch(const uint8_t* payload, uint32_t length)
+{
+    uint32_t count = Protocol_Get_U32(payload);
+
+    if (count > PROTOCOL_MAX_BATCH || length != 4 + count * 4)
+        return F_NOT_OK;
+    for (uint32_t i = 0; i < count; i++)
+        batch_ids[i] = Protocol_Get_U32(payload + 4 + i * 4);
+
+    F_Return_t status = Find_Students_By_IDs(batch_ids, count, batch_students, batch_results);
+    if (status != F_OK)
+        return status;
+    if (Reserve_Reply(4 + count * (1 + PROTOCOL_STUDENT_SIZE)) != F_OK)
+        return F_NOT_OK;
+
+    uint8_t* out = reply + reply_length;
+    Protocol_Put_U32(out, count);
+    out += 4;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        *out++ = (uint8_t)batch_results[i];
+        if (batch_results[i] == F_OK)
+            Protocol_Put_Student(out, &batch_students[i]);
+        else
+            my_memset(out, 0, PROTOCOL_STUDENT_SIZE);
+        out += PROTOCOL_STUDENT_SIZE;
+    }
+    reply_length += 4 + count * (1 + PROTOCOL_STUDENT_SIZE);
+    return F_OK;
+}
+
+/* Adds every student of the request under one exclusive lock, syncing once */
+static F_Return_t Add_Batch(const uint8_t* payload, uint32_t length)
+{
+    Student_t student;
+    uint32_t count = Protocol_Get_U32(payload);
+
+    if (count > PROTOCOL_MAX_BATCH || length != 4 + count * PROTOCOL_STUDENT_SIZE)
+        return F_NOT_OK;
+    if (Reserve_Reply(4 + count) != F_OK)
+        return F_NOT_OK;
+
+    F_Return_t status = System_Lock(true);
+    if (status != F_OK)
+        return status;
+
+    uint8_t* out = reply + reply_length;
+    Protocol_Put_U32(out, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Protocol_Get_Student(payload + 4 + i * PROTOCOL_STUDENT_SIZE, &student);
+        status = Add_Student_Manually(&student);
+        out[4 + i] = (uint8_t)status;
+    }
+    System_Unlock();
+
+    reply_length += 4 + count;
+    return F_OK;
+}
+
+/* Runs one request, appending its result to the reply; F_NOT_OK for a malformed payload */
+static F_Return_t Handle_Request(const Protocol_Header_t* request, const uint8_t* payload)
+{
+    Query_Cursor_t cursor;
+    Student_t student;
+    Student_Update_t values;
+    char fname[MAX_NAME_LENGTH];
+    uint32_t length = request->length;
+    F_Return_t status;
+
+    switch (request->op)
+    {
+    case PROTOCOL_OP_PING:
+        return F_OK;
+
+    case PROTOCOL_OP_ADD:
+        if (length != PROTOCOL_STUDENT_SIZE)
+            return F_NOT_OK;
+        Protocol_Get_Student(payload, &student);
+        return Add_Student_Manually(&student);
+
+    case PROTOCOL_OP_FIND_ID:
+        if (length != 4)
+            return F_NOT_OK;
+        status = Find_Student_By_ID(Protocol_Get_U32(payload), &student);
+        return (status == F_OK) ? Reply_Student(&student) : status;
+
+    case PROTOCOL_OP_FIND_NAME:
+        if (length < 8 || length - 8 >= MAX_NAME_LENGTH)
+            return F_NOT_OK;
+        my_memcpy(fname, payload + 8, length - 8);
+        fname[length - 8] = '\0';
+        status = Query_By_First_Name(&cursor, fname, Protocol_Get_U32(payload), Page_Limit(Protocol_Get_U32(payload + 4)));
+        return (status == F_OK) ? Reply_Cursor(&cursor, F_FNAME_NOT_FOUND) : status;
+
+    case PROTOCOL_OP_FIND_COURSES:
+        if (length != 12)
+            return F_NOT_OK;
+        status = Query_By_Courses(&cursor, Protocol_Get_U16(payload), Protocol_Get_U16(payload + 2),
+                                  Protocol_Get_U32(payload + 4), Page_Limit(Protocol_Get_U32(payload + 8)));
+        return (status == F_OK) ? Reply_Cursor(&cursor, F_COURSE_NOT_FOUND) : status;
+
+    case PROTOCOL_OP_UPDATE:
+        if (length != 1 + PROTOCOL_STUDENT_SIZE)
+            return F_NOT_OK;
+        Protocol_Get_Student(payload + 1, &student);
+        my_memcpy(values.first_name, student.first_name, MAX_NAME_LENGTH);
+        my_memcpy(values.last_name, student.last_name, MAX_NAME_LENGTH);
+        values.GPA = student.GPA;
+        my_memcpy(values.courses, student.courses, MAX_COURSES);
+        values.course_count = student.course_count;
+        return Update_Student(student.id, payload[0], &values);
+
+    case PROTOCOL_OP_DELETE:
+        if (length != 4)
+            return F_NOT_OK;
+        return Delete_Student(Protocol_Get_U32(payload));
+
+    case PROTOCOL_OP_LIST:
+        if (length != 8)
+            return F_NOT_OK;
+        status = Query_All(&cursor, Protocol_Get_U32(payload), Page_Limit(Protocol_Get_U32(payload + 4)));
+        return (status == F_OK) ? Reply_Cursor(&cursor, F_FILE_IS_EMPTY) : status;
+
+    case PROTOCOL_OP_SHUTDOWN:
+        stopping = true;
+        return F_OK;
+
+    case PROTOCOL_OP_FIND_IDS:
+        return (length >= 4) ? Find_Batch(payload, length) : F_NOT_OK;
+
+    case PROTOCOL_OP_ADD_MANY:
+        return (length >= 4) ? Add_Batch(payload, length) : F_NOT_OK;
+
+    default:
+        return F_NOT_OK;
+    }
+}
+
+/* Appends the reply to one request frame; a reply carries a result only with F_OK */
+static F_Return_t Answer(const Protocol_Header_t* request, const uint8_t* payload)
+{
+    Protocol_Header_t header;
+    uint32_t start = reply_length;
+
+    if (Reserve_Reply(PROTOCOL_HEADER_SIZE) != F_OK)
+        return F_NOT_OK;
+    reply_length += PROTOCOL_HEADER_SIZE;
+
+    F_Return_t status = Handle_Request(request, payload);
+    if (status != F_OK)
+        reply_length = start + PROTOCOL_HEADER_SIZE;
+
+    header.length = reply_length - start - PROTOCOL_HEADER_SIZE;
+    header.op = request->op;
+    header.status = (uint8_t)status;
+    header.tag = request->tag;
+    Protocol_Put_Header(reply + start, &header);
+    served++;
+    return F_OK;
+}
+
+static F_Return_t Send_Replies(Connection_t* connection)
+{
+    uint32_t length = reply_length;
+
+    reply_length = 0;
+    if (length == 0)
+        return F_OK;
+    return (Platform_Send(&connection->socket, reply, length) == 0) ? F_OK : F_NOT_OK;
+}
+
+/**
+ * @brief  Reads what a client sent and answers every complete frame.
+ *
+ * @details
+ * - Pipelined requests are answered with one send, or one per
+ *   SERVER_REPLY_FLUSH bytes of replies.
+ *
+ * @return F_OK, or F_NOT_OK to drop the client.
+ */
+static F_Return_t Serve_Connection(Connection_t* connection)
+{
+    Protocol_Header_t request;
+    uint32_t consumed = 0;
+
+    reply_length = 0;
+    if (connection->capacity - connection->used < SERVER_RECEIVE_CHUNK)
+    {
+        uint8_t* grown = realloc(connection->buffer, connection->used + SERVER_RECEIVE_CHUNK);
+        if (!grown)
+            return F_NOT_OK;
+        connection->buffer = grown;
+        connection->capacity = connection->used + SERVER_RECEIVE_CHUNK;
+    }
+
+    long got = Platform_Receive(&connection->socket, connection->buffer + connection->used,
+                                connection->capacity - connection->used);
+    if (got <= 0)
+        return F_NOT_OK;
+    connection->used += (uint32_t)got;
+
+    while (!stopping && connection->used - consumed >= PROTOCOL_HEADER_SIZE)
+    {
+        Protocol_Get_Header(connection->buffer + consumed, &request);
+        if (request.length > PROTOCOL_MAX_PAYLOAD)
+            return F_NOT_OK;
+        if (connection->used - consumed < PROTOCOL_HEADER_SIZE + request.length)
+            break;
+
+        if (Answer(&request, connection->buffer + consumed + PROTOCOL_HEADER_SIZE) != F_OK)
+            return F_NOT_OK;
+        consumed += PROTOCOL_HEADER_SIZE + request.length;
+
+        if (reply_length >= SERVER_REPLY_FLUSH && Send_Replies(connection) != F_OK)
+            return F_NOT_OK;
+    }
+    if (Send_Replies(connection) != F_OK)
+        return F_NOT_OK;
+
+    /* Keep the start of an incomplete frame for the next receive */
+    memmove(connection->buffer, connection->buffer + consumed, connection->used - consumed);
+    connection->used -= consumed;
+    return F_OK;
+}
+
+static void Accept_Connection(Platform_Socket_t* listener)
+{
+    Platform_Socket_t socket;
+
+    if (Platform_Accept(listener, &socket) != 0)
+        return;
+    if (connection_count >= SERVER_MAX_CLIENTS)
+    {
+        Platform_Close_Socket(&socket);
+        return;
+    }
+
+    Connection_t* connection = &connections[connection_count++];
+    my_memset(connection, 0, sizeof(Connection_t));
+    connection->socket = socket;
+}
+
+static void Drop_Connection(uint32_t index)
+{
+    Platform_Close_Socket(&connections[index].socket);
+    free(connections[index].buffer);
+    connections[index] = connections[--connection_count];
+}
+
+/**
+ * @brief  Serves the database until a client sends PROTOCOL_OP_SHUTDOWN.
+ *
+ * @details
+ * - Initializes the system, listens on the address and serves
+ *   the connected clients.
+ * - Drops a connection that sends a malformed frame.
+ * - Prints the number of requests served on exit, then shuts
+ *   the system down.
+ *
+ * @param  address "unix:<path>" or "tcp:<port>".
+ * @return F_OK after a shutdown request, otherwise error code.
+ */
+F_Return_t Server_Run(const char* address)
+{
+    Platform_Socket_t listener;
+    Platform_Socket_t sockets[SERVER_MAX_CLIENTS + 1];
+    bool readable[SERVER_MAX_CLIENTS + 1];
+    F_Return_t status = F_OK;
+
+    if (!address)
+        return F_NOT_OK;
+    if (System_Init() != F_OK)
+        return F_FILE_OPEN_ERROR;
+    if (Platform_Listen(address, &listener) != 0)
+    {
+        printf("Cannot listen on %s.\n", address);
+        System_Deinit();
+        return F_CONNECTION_ERROR;
+    }
+
+    printf("Serving the student database on %s.\n", address);
+    double started = Platform_Time_Seconds();
+    stopping = false;
+    served = 0;
+
+    while (!stopping)
+    {
+        sockets[0] = listener;
+        for (uint32_t i = 0; i < connection_count; i++)
+            sockets[i + 1] = connections[i].socket;
+
+        if (Platform_Wait_Readable(sockets, connection_count + 1, readable, -1) < 0)
+        {
+            status = F_CONNECTION_ERROR;
+            break;
+        }
+
+        /* Backward, a dropped connection is replaced by the last one */
+        for (uint32_t i = connection_count; i-- > 0;)
+        {
+            if (readable[i + 1] && Serve_Connection(&connections[i]) != F_OK)
+                Drop_Connection(i);
+        }
+        if (readable[0] && !stopping)
+            Accept_Connection(&listener);
+    }
+
+    double elapsed = Platform_Time_Seconds() - started;
+    printf("Served %llu requests in %.1f s (%.0f per second).\n", (unsigned long long)served, elapsed,
+           (elapsed > 0) ? (double)served / elapsed : 0.0);
+
+    while (connection_count > 0)
+        Drop_Connection(connection_count - 1);
+    Platform_Close_Socket(&listener);
+    free(reply);
+    reply = NULL;
+    reply_length = reply_capacity = 0;
+
+    System_Deinit();
+    return status;
+}
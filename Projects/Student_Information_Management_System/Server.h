@@ -0,0 +1,45 @@
+#ifndef _Server_H_
+#define _Server_H_
+
+/* ============================================================
+ *  Database Server
+ *
+ *  Description:
+ *  Long-running process that owns the database, its indexes
+ *  and record cache, and answers the requests of Protocol.h
+ *  over a local socket. Clients skip opening the files and
+ *  loading the indexes, which the server does once.
+ *
+ *  One thread serves every connection: it waits for the ready
+ *  sockets and handles each complete request frame in arrival
+ *  order through the System API, so requests never run
+ *  concurrently inside the process. The replies to the frames
+ *  of one read go back in one send.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define SERVER_DEFAULT_ADDRESS   "tcp:5757"      /* Or "unix:<path>" */
+#define SERVER_MAX_CLIENTS       64              /* Further connections are refused */
+#define SERVER_RECEIVE_CHUNK     65536           /* Bytes read per receive call */
+#define SERVER_REPLY_FLUSH       262144          /* Pending reply bytes that force a send */
+
+/**
+ * @brief  Serves the database until a client sends PROTOCOL_OP_SHUTDOWN.
+ *
+ * @details
+ * - Initializes the system, listens on the address and serves
+ *   the connected clients.
+ * - Drops a connection that sends a malformed frame.
+ * - Prints the number of requests served on exit, then shuts
+ *   the system down.
+ *
+ * @param  address "unix:<path>" or "tcp:<port>".
+ * @return F_OK after a shutdown request, otherwise error code.
+ */
+F_Return_t Server_Run(const char* address);
+
+#endif // !_Server_H_
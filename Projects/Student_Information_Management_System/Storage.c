@@ -0,0 +1,1484 @@
+#include "Storage.h"
+#include "Platform.h"
+#include "WAL.h"
+#include "Record_Cache.h"
+#include <string.h>
+#include <stddef.h>
+
+/* ============================================================
+ *                    File Header
+ *
+ *  The first DB_HEADER_SIZE bytes of the database hold this
+ *  header, record slots follow it. magic, version, header_size
+ *  and id_size sit at the same offsets on every platform, so a
+ *  file written by another build is recognised before the rest
+ *  of the header is trusted.
+ * ============================================================ */
+typedef struct
+{
+    char magic[4];                  /* DB_MAGIC */
+    uint16_t version;               /* DB_FORMAT_VERSION */
+    uint16_t header_size;           /* DB_HEADER_SIZE */
+    uint8_t id_size;                /* sizeof(uint32_t) of the writer */
+    uint8_t reserved[3];
+
+    /* ---------- Record layout descriptor ---------- */
+    uint32_t record_size;           /* sizeof(Student_t) */
+    uint32_t name_length;           /* MAX_NAME_LENGTH */
+    uint32_t max_courses;           /* MAX_COURSES */
+
+    /* ---------- Record counters ---------- */
+    uint32_t record_count;          /* Slots in the file */
+    uint32_t live_count;            /* Slots holding active records */
+    uint32_t dead_count;            /* Slots holding deleted records */
+    uint32_t generation;            /* Bumped on every change */
+
+    uint32_t checksum;              /* CRC-32 of the fields above */
+    uint32_t epoch;                 /* Bumped when a derived file is rebuilt */
+} DB_Header_t;
+
+/* Field offsets of a Student_t built with a given layout descriptor */
+typedef struct
+{
+    size_t first_name;
+    size_t last_name;
+    size_t gpa;
+    size_t courses;
+    size_t course_count;
+    size_t is_active;
+    size_t size;
+} Record_Layout_t;
+
+static FILE* db_fp = NULL;
+static DB_Header_t header;
+
+/* Read-only mapping of the file, or a heap copy if mapping failed */
+static Platform_Map_t db_map = { 0 };
+static Student_t* db_copy = NULL;
+static const Student_t* mapped_records = NULL;
+static uint32_t mapped_count = 0;
+
+/* Free-list: slots of logically deleted records, loaded on first use */
+static uint32_t* free_slots = NULL;
+static uint32_t free_count = 0;
+static uint32_t free_capacity = 0;
+static bool free_list_loaded = false;
+
+/*
+ * Slot images of the open log group, written to the file once the
+ * log is synced. A group holds up to WAL_GROUP_COMMIT_RECORDS images,
+ * a transaction as many as it writes.
+ */
+static uint32_t* pending_slots = NULL;
+static Student_t* pending_images = NULL;
+static uint32_t pending_count = 0;
+static uint32_t pending_capacity = 0;
+static uint32_t pending_uncached = 0;  /* Held images the record cache had no room for */
+static bool uncommitted = false;    /* Changes not closed by a commit record yet */
+static bool unsynced = false;       /* Log records not forced to the disk yet */
+
+/* Open transaction: its changes form one group, closed only by Storage_Commit */
+static bool in_transaction = false;
+static DB_Header_t saved_header;    /* Header when the transaction began */
+static WAL_Savepoint_t savepoint;   /* Log end when the transaction began */
+
+/* ---------- Inter-process lock ---------- */
+static Platform_Lock_t db_lock;
+static FILE* probe_fp = NULL;       /* Unbuffered: every header read reaches the file */
+static bool lock_opened = false;
+static uint32_t lock_depth = 0;     /* Nested Storage_Lock calls */
+static Storage_Lock_Mode_t lock_mode;
+static const Storage_Derived_t* lock_derived = NULL;
+static uint32_t highest_epoch = 0;  /* Highest epoch seen, kept across reopens */
+static bool refreshing = false;     /* Reopening after another process wrote */
+
+static F_Return_t Sync_Group(void);
+
+static long Slot_Offset(uint32_t slot)
+{
+    return (long)(DB_HEADER_SIZE + (size_t)slot * sizeof(Student_t));
+}
+
+static uint32_t Header_Checksum(const DB_Header_t* h)
+{
+    return my_crc32(h, offsetof(DB_Header_t, checksum));
+}
+
+static void Init_Header(DB_Header_t* h)
+{
+    my_memset(h, 0, sizeof(DB_Header_t));
+    my_memcpy(h->magic, DB_MAGIC, sizeof(h->magic));
+    h->version = DB_FORMAT_VERSION;
+    h->header_size = DB_HEADER_SIZE;
+    h->id_size = (uint8_t)sizeof(uint32_t);
+    h->record_size = sizeof(Student_t);
+    h->name_length = MAX_NAME_LENGTH;
+    h->max_courses = MAX_COURSES;
+}
+
+/* Writes the header zero-padded to DB_HEADER_SIZE bytes */
+static F_Return_t Write_Header(FILE* fp, DB_Header_t* h)
+{
+    uint8_t block[DB_HEADER_SIZE] = { 0 };
+
+    h->checksum = Header_Checksum(h);
+    my_memcpy(block, h, sizeof(DB_Header_t));
+
+    if (fseek(fp, 0, SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(block, DB_HEADER_SIZE, 1, fp) != 1)
+        return F_FILE_WRITE_ERROR;
+    fflush(fp);
+    return F_OK;
+}
+
+/* Records a change: bumps the generation, the counters reach the file with the next commit */
+static F_Return_t Header_Changed(void)
+{
+    header.generation++;
+    uncommitted = true;
+    return F_OK;
+}
+
+/* Natural alignment of Student_t for a given layout descriptor */
+static void Compute_Layout(uint32_t id_size, uint32_t name_length, uint32_t max_courses, Record_Layout_t* layout)
+{
+    size_t offset = id_size;
+
+    layout->first_name = offset;
+    offset += name_length;
+    layout->last_name = offset;
+    offset += name_length;
+    offset = (offset + sizeof(float) - 1) / sizeof(float) * sizeof(float);
+    layout->gpa = offset;
+    offset += sizeof(float);
+    layout->courses = offset;
+    offset += max_courses;
+    layout->course_count = offset++;
+    layout->is_active = offset++;
+    layout->size = (offset + id_size - 1) / id_size * id_size;
+}
+
+/* True when Compute_Layout reproduces the compiler's Student_t */
+static bool Layout_Is_Predictable(void)
+{
+    Record_Layout_t layout;
+    Compute_Layout(sizeof(uint32_t), MAX_NAME_LENGTH, MAX_COURSES, &layout);
+
+    return layout.first_name == offsetof(Student_t, first_name) &&
+           layout.last_name == offsetof(Student_t, last_name) &&
+           layout.gpa == offsetof(Student_t, GPA) &&
+           layout.courses == offsetof(Student_t, courses) &&
+           layout.course_count == offsetof(Student_t, course_count) &&
+           layout.is_active == offsetof(Student_t, is_active) &&
+           layout.size == sizeof(Student_t);
+}
+
+/* Converts one record written with another layout descriptor */
+static void Convert_Record(const uint8_t* raw, const DB_Header_t* old, const Record_Layout_t* layout, Student_t* student)
+{
+    uint32_t name_length = (old->name_length < MAX_NAME_LENGTH) ? old->name_length : MAX_NAME_LENGTH;
+    uint32_t max_courses = (old->max_courses < MAX_COURSES) ? old->max_courses : MAX_COURSES;
+
+    my_memset(student, 0, sizeof(Student_t));
+    my_memcpy(&student->id, raw, sizeof(uint32_t));
+    my_memcpy(student->first_name, raw + layout->first_name, name_length);
+    my_memcpy(student->last_name, raw + layout->last_name, name_length);
+    student->first_name[MAX_NAME_LENGTH - 1] = '\0';
+    student->last_name[MAX_NAME_LENGTH - 1] = '\0';
+    my_memcpy(&student->GPA, raw + layout->gpa, sizeof(float));
+    my_memcpy(student->courses, raw + layout->courses, max_courses);
+    student->course_count = raw[layout->course_count];
+    if (student->course_count > max_courses)
+        student->course_count = (uint8_t)max_courses;
+    student->is_active = raw[layout->is_active] != 0;
+}
+
+/**
+ * @brief  Rewrites the open database file in the current format.
+ *
+ * @details
+ * - old == NULL: a headerless file of raw Student_t records.
+ * - Otherwise: a headered file whose layout descriptor differs
+ *   from this build, converted field by field.
+ * - The new file is written next to the old one and renamed over
+ *   it once complete; db_fp is closed on success.
+ */
+static F_Return_t Migrate_File(const DB_Header_t* old)
+{
+    Record_Layout_t layout;
+    DB_Header_t fresh;
+    Student_t student;
+    uint8_t raw[1024];
+    size_t record_size = sizeof(Student_t);
+    long data_offset = 0;
+    uint32_t remaining = 0xFFFFFFFFUL;
+    const char* temp_name = DB_FILE_NAME ".migrate";
+
+    if (old)
+    {
+        if (!Layout_Is_Predictable())
+            return F_FILE_READ_ERROR;
+        Compute_Layout(old->id_size, old->name_length, old->max_courses, &layout);
+        if (layout.size != old->record_size || layout.size > sizeof(raw))
+            return F_FILE_READ_ERROR;
+        record_size = layout.size;
+        data_offset = old->header_size;
+        remaining = old->record_count;
+    }
+
+    FILE* dest = fopen(temp_name, "wb");
+    if (!dest)
+        return F_FILE_OPEN_ERROR;
+
+    Init_Header(&fresh);
+    F_Return_t status = Write_Header(dest, &fresh);
+
+    fseek(db_fp, data_offset, SEEK_SET);
+    while (status == F_OK && remaining-- > 0 && fread(raw, record_size, 1, db_fp) == 1)
+    {
+        if (old)
+            Convert_Record(raw, old, &layout, &student);
+        else
+            my_memcpy(&student, raw, sizeof(Student_t));
+
+        if (fwrite(&student, sizeof(Student_t), 1, dest) != 1)
+        {
+            status = F_FILE_WRITE_ERROR;
+            break;
+        }
+        fresh.record_count++;
+        if (student.is_active)
+            fresh.live_count++;
+        else
+            fresh.dead_count++;
+    }
+
+    if (status == F_OK)
+        status = Write_Header(dest, &fresh);
+    fclose(dest);
+    if (status != F_OK)
+    {
+        remove(temp_name);
+        return status;
+    }
+
+    fclose(db_fp);
+    db_fp = NULL;
+    remove(DB_FILE_NAME);
+    if (rename(temp_name, DB_FILE_NAME) != 0)
+        return F_FILE_WRITE_ERROR;
+
+    printf("Database migrated to format version %u (%u records).\n", DB_FORMAT_VERSION, (unsigned)fresh.record_count);
+    return F_OK;
+}
+
+/* Recounts the records when the header counters can't be trusted */
+static F_Return_t Recount_Records(void)
+{
+    Student_t buffer[256];
+    size_t got;
+
+    fseek(db_fp, 0, SEEK_END);
+    header.record_count = (uint32_t)((ftell(db_fp) - DB_HEADER_SIZE) / sizeof(Student_t));
+    header.live_count = 0;
+
+    fseek(db_fp, DB_HEADER_SIZE, SEEK_SET);
+    while ((got = fread(buffer, sizeof(Student_t), 256, db_fp)) > 0)
+    {
+        for (size_t i = 0; i < got; i++)
+        {
+            if (buffer[i].is_active)
+                header.live_count++;
+        }
+    }
+    header.dead_count = header.record_count - header.live_count;
+    header.generation++;
+    return Write_Header(db_fp, &header);
+}
+
+/**
+ * @brief  Validates the header of the open file.
+ *
+ * @details
+ * - Empty file: writes a fresh header.
+ * - Current format: O(1), the counters come from the header.
+ * - Bad checksum: the counters are rebuilt with one scan.
+ * - Legacy headerless file or other record layout: migrated,
+ *   F_NOT_OK asks the caller to open the new file.
+ */
+static F_Return_t Load_Header(void)
+{
+    uint8_t block[DB_HEADER_SIZE];
+    DB_Header_t stored;
+    size_t got;
+
+    rewind(db_fp);
+    got = fread(block, 1, DB_HEADER_SIZE, db_fp);
+    my_memcpy(&stored, block, sizeof(DB_Header_t));
+
+    if (got == 0)
+    {
+        Init_Header(&header);
+        return Write_Header(db_fp, &header);
+    }
+
+    if (got < sizeof(DB_Header_t) || my_memcmp(stored.magic, DB_MAGIC, sizeof(stored.magic)) != 0)
+    {
+        /* ---------- Legacy file: raw Student_t records, no header ---------- */
+        fseek(db_fp, 0, SEEK_END);
+        if (ftell(db_fp) % sizeof(Student_t) != 0)
+        {
+            printf("Database file format not recognised.\n");
+            return F_FILE_READ_ERROR;
+        }
+        return (Migrate_File(NULL) == F_OK) ? F_NOT_OK : F_FILE_WRITE_ERROR;
+    }
+
+    if (stored.id_size != sizeof(uint32_t) || stored.version > DB_FORMAT_VERSION ||
+        stored.header_size != DB_HEADER_SIZE || got < DB_HEADER_SIZE)
+    {
+        printf("Database was written by an incompatible build.\n");
+        return F_FILE_READ_ERROR;
+    }
+
+    if (stored.checksum != Header_Checksum(&stored))
+    {
+        header = stored;
+        Init_Header(&stored);
+        if (header.record_size != stored.record_size ||
+            header.name_length != stored.name_length ||
+            header.max_courses != stored.max_courses)
+        {
+            printf("Database header is corrupted.\n");
+            return F_FILE_READ_ERROR;
+        }
+        printf("Database header checksum mismatch, recounting records...\n");
+        return Recount_Records();
+    }
+
+    if (stored.record_size != sizeof(Student_t) ||
+        stored.name_length != MAX_NAME_LENGTH ||
+        stored.max_courses != MAX_COURSES)
+    {
+        /* ---------- Other record layout ---------- */
+        return (Migrate_File(&stored) == F_OK) ? F_NOT_OK : F_FILE_WRITE_ERROR;
+    }
+
+    header = stored;
+    return F_OK;
+}
+
+static F_Return_t Push_Free_Slot(uint32_t slot)
+{
+    if (free_count == free_capacity)
+    {
+        uint32_t capacity = (free_capacity) ? 2 * free_capacity : 256;
+        uint32_t* grown = realloc(free_slots, capacity * sizeof(uint32_t));
+        if (!grown)
+            return F_NOT_OK;
+        free_slots = grown;
+        free_capacity = capacity;
+    }
+    free_slots[free_count++] = slot;
+    return F_OK;
+}
+
+static void Unmap_Records(void)
+{
+    Platform_Unmap_File(&db_map);
+    free(db_copy);
+    db_copy = NULL;
+    mapped_records = NULL;
+    mapped_count = 0;
+}
+
+/* Collects the free slots the first time one is needed */
+static F_Return_t Load_Free_List(void)
+{
+    Student_t buffer[256];
+    size_t got;
+    uint32_t slot = 0;
+
+    if (free_list_loaded)
+        return F_OK;
+    if (Sync_Group() != F_OK)
+        return F_FILE_WRITE_ERROR;
+
+    free_count = 0;
+    if (header.dead_count > 0)
+    {
+        fseek(db_fp, DB_HEADER_SIZE, SEEK_SET);
+        while (slot < header.record_count && (got = fread(buffer, sizeof(Student_t), 256, db_fp)) > 0)
+        {
+            for (size_t i = 0; i < got && slot < header.record_count; i++, slot++)
+            {
+                if (!buffer[i].is_active && Push_Free_Slot(slot) != F_OK)
+                    return F_NOT_OK;
+            }
+        }
+    }
+    free_list_loaded = true;
+    return F_OK;
+}
+
+/* Writes a slot image to the database file itself */
+static F_Return_t Write_Image(uint32_t slot, const Student_t* student)
+{
+    if (fseek(db_fp, Slot_Offset(slot), SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(student, sizeof(Student_t), 1, db_fp) != 1)
+        return F_FILE_WRITE_ERROR;
+
+    /* A heap copy does not follow the file, keep it in sync */
+    if (db_copy && slot < mapped_count)
+        db_copy[slot] = *student;
+    return F_OK;
+}
+
+/* Closes the open changes with a commit record carrying the header counters */
+static F_Return_t Log_Commit(void)
+{
+    WAL_Counters_t counters;
+
+    if (!uncommitted)
+        return F_OK;
+
+    counters.record_count = header.record_count;
+    counters.live_count = header.live_count;
+    counters.dead_count = header.dead_count;
+    counters.generation = header.generation;
+    uncommitted = false;
+    unsynced = true;
+    return WAL_Log_Commit(&counters);
+}
+
+/* Once the database file is durable the log can start over */
+static F_Return_t Checkpoint(void)
+{
+    if (Platform_Sync_File(db_fp) != 0)
+        return F_FILE_WRITE_ERROR;
+    return WAL_Reset();
+}
+
+/* Writes the held slot images and the header of a group whose log is synced */
+static F_Return_t Apply_Group(void)
+{
+    F_Return_t status = F_OK;
+
+    /* Write-back: the cached images of the group become clean */
+    for (uint32_t i = 0; i < pending_count && status == F_OK; i++)
+    {
+        status = Write_Image(pending_slots[i], &pending_images[i]);
+        Record_Cache_Mark_Clean(pending_slots[i]);
+    }
+    pending_count = 0;
+    pending_uncached = 0;
+
+    /* Also flushes the images, readers with their own streams see them */
+    if (status == F_OK)
+        status = Write_Header(db_fp, &header);
+    if (status == F_OK && WAL_Needs_Checkpoint())
+        status = Checkpoint();
+    return status;
+}
+
+/*
+ * Ends the log group: commits it, forces the log to the disk and
+ * only then writes the held slot images and header to the file.
+ */
+static F_Return_t Sync_Group(void)
+{
+    F_Return_t status;
+
+    if (!uncommitted && !unsynced)
+        return F_OK;
+
+    /* Only Storage_Commit may close the group of a transaction */
+    if (in_transaction)
+        return F_NOT_OK;
+
+    status = Log_Commit();
+    if (status == F_OK)
+        status = WAL_Flush(true);
+    if (status != F_OK)
+        return status;
+    unsynced = false;
+    return Apply_Group();
+}
+
+/* Makes room for one more held image */
+static F_Return_t Reserve_Image(void)
+{
+    if (pending_count == pending_capacity)
+    {
+        uint32_t capacity = (pending_capacity) ? 2 * pending_capacity : WAL_GROUP_COMMIT_RECORDS;
+        uint32_t* slots = realloc(pending_slots, capacity * sizeof(uint32_t));
+        if (slots)
+            pending_slots = slots;
+        Student_t* images = realloc(pending_images, capacity * sizeof(Student_t));
+        if (images)
+            pending_images = images;
+        if (!slots || !images)
+            return F_NOT_OK;
+        pending_capacity = capacity;
+    }
+    return F_OK;
+}
+
+/* Logs one slot write and holds its image until the group is synced; the caller updates the header */
+static F_Return_t Write_Slot(uint32_t slot, const Student_t* student)
+{
+    uint32_t i;
+    F_Return_t status;
+
+    /* A full group is synced before the next change starts */
+    if (pending_count >= WAL_GROUP_COMMIT_RECORDS && !in_transaction)
+    {
+        status = Sync_Group();
+        if (status != F_OK)
+            return status;
+    }
+
+    /* Room for the image first, a logged write must never lack it */
+    status = Reserve_Image();
+    if (status == F_OK)
+        status = WAL_Log_Slot(slot, student);
+    if (status != F_OK)
+        return status;
+    uncommitted = true;
+    unsynced = true;
+
+    for (i = 0; i < pending_count && pending_slots[i] != slot; i++)
+        ;
+    pending_slots[i] = slot;
+    pending_images[i] = *student;
+    if (i == pending_count)
+        pending_count++;
+
+    /* Readers find the change in the cache until it is written back */
+    if (Record_Cache_Put(slot, student, true) != F_OK)
+        pending_uncached++;
+
+    if (slot >= header.record_count)
+        header.record_count = slot + 1;
+    return F_OK;
+}
+
+static F_Return_t Redo_Slot(uint32_t slot, const Student_t* student, void* context)
+{
+    (void)context;
+    return Write_Image(slot, student);
+}
+
+static F_Return_t Redo_Commit(const WAL_Counters_t* counters, void* context)
+{
+    (void)context;
+    header.record_count = counters->record_count;
+    header.live_count = counters->live_count;
+    header.dead_count = counters->dead_count;
+    header.generation = counters->generation;
+    return F_OK;
+}
+
+/* Replays the groups committed before a crash */
+static F_Return_t Recover_From_Log(void)
+{
+    uint32_t groups = 0;
+    F_Return_t status = WAL_Replay(Redo_Slot, Redo_Commit, NULL, &groups);
+    if (status != F_OK)
+        return status;
+
+    /*
+     * Bulk appends are only logged by the commit that counts them.
+     * Uncommitted ones lie past the record count, where the next
+     * append overwrites them; the file is not truncated, since other
+     * processes may have it mapped.
+     */
+    if (groups > 0)
+    {
+        if (!refreshing)
+            printf("Recovered %u committed change groups from the write-ahead log.\n", (unsigned)groups);
+        status = Write_Header(db_fp, &header);
+        if (status == F_OK)
+            status = Checkpoint();
+        return status;
+    }
+    return WAL_Reset();
+}
+
+/**
+ * @brief  Opens the database file for record access.
+ *
+ * @details
+ * - Creates the database file if it does not exist.
+ * - Does nothing if the file is already open.
+ * - Takes the record counters from the file header in O(1).
+ * - Migrates legacy headerless files and files written with
+ *   another record layout to the current format.
+ * - Replays the groups a crash left committed in the write-ahead
+ *   log; uncommitted appends are left past the record count.
+ *
+ * @return F_OK if the file is ready, otherwise F_FILE_OPEN_ERROR.
+ */
+F_Return_t Storage_Open(void)
+{
+    F_Return_t status;
+
+    if (db_fp)
+        return F_OK;
+
+    do
+    {
+        /* "rb+" keeps existing data; fall back to "wb+" to create the file */
+        db_fp = fopen(DB_FILE_NAME, "rb+");
+        if (!db_fp)
+            db_fp = fopen(DB_FILE_NAME, "wb+");
+        if (!db_fp)
+            return F_FILE_OPEN_ERROR;
+
+        status = Load_Header();
+    } while (status == F_NOT_OK);   /* Migrated: open the new file */
+
+    if (status == F_OK)
+        status = WAL_Open();
+    if (status == F_OK)
+        status = Recover_From_Log();
+
+    if (status != F_OK)
+    {
+        /* Keep a log that could not be replayed for the next attempt */
+        WAL_Close();
+        Storage_Close();
+        return F_FILE_OPEN_ERROR;
+    }
+    if (header.epoch > highest_epoch)
+        highest_epoch = header.epoch;
+
+    probe_fp = fopen(DB_FILE_NAME, "rb");
+    if (probe_fp)
+        setvbuf(probe_fp, NULL, _IONBF, 0);
+    return F_OK;
+}
+
+/* Drops every open handle and in-memory state without writing anything */
+static void Release(void)
+{
+    WAL_Close();
+
+    free(pending_slots);
+    free(pending_images);
+    pending_slots = NULL;
+    pending_images = NULL;
+    pending_count = pending_capacity = 0;
+    pending_uncached = 0;
+    uncommitted = unsynced = false;
+    Record_Cache_Drop_From(0);
+
+    Unmap_Records();
+    if (db_fp)
+        fclose(db_fp);
+    db_fp = NULL;
+    if (probe_fp)
+        fclose(probe_fp);
+    probe_fp = NULL;
+
+    free(free_slots);
+    free_slots = NULL;
+    free_count = free_capacity = 0;
+    free_list_loaded = false;
+}
+
+/**
+ * @brief  Closes the database file.
+ *
+ * @details
+ * - Syncs the open log group and checkpoints the log, so a clean
+ *   close leaves every change in the file and an empty log.
+ * - Must be called before another stream reads, truncates or
+ *   replaces the database file; the next access reopens it.
+ */
+void Storage_Close(void)
+{
+    if (!db_fp)
+        return;
+
+    /* A clean close leaves every change in the file and an empty log */
+    Storage_Rollback();
+    if (Sync_Group() == F_OK)
+        Checkpoint();
+    Release();
+    Record_Cache_Clear();
+}
+
+/*
+ * Compares the header stored now with the one this process holds.
+ * The probe stream reads it: db_fp may still buffer older bytes.
+ */
+static bool Changed_Elsewhere(void)
+{
+    DB_Header_t stored;
+
+    if (!db_fp || !probe_fp)
+        return true;
+    if (fseek(probe_fp, 0, SEEK_SET) != 0 || fread(&stored, sizeof(DB_Header_t), 1, probe_fp) != 1)
+        return true;
+
+    return stored.generation != header.generation ||
+           stored.epoch != header.epoch ||
+           !WAL_Is_Current();
+}
+
+/* Reopens the file and everything derived from it; needs the exclusive lock */
+static F_Return_t Refresh(const Storage_Derived_t* derived)
+{
+    F_Return_t status;
+
+    if (derived && derived->discard)
+        derived->discard();
+
+    /* Replaying the log of a live writer is not a recovery worth reporting */
+    refreshing = (db_fp != NULL);
+    Release();
+    status = Storage_Open();
+    refreshing = false;
+
+    if (status == F_OK && derived && derived->reopen)
+        status = derived->reopen();
+    return status;
+}
+
+/**
+ * @brief  Takes the database lock shared between processes.
+ *
+ * @details
+ * - Shared holders only read; one exclusive holder reads and
+ *   writes while nobody else holds the lock.
+ * - Calls nest: inner calls reuse the outer lock, and an inner
+ *   exclusive request under a shared lock fails.
+ * - When another process changed the file since this process
+ *   last held the lock, drops the open file and derived state
+ *   and reopens them, under the exclusive lock.
+ *
+ * @param  mode    STORAGE_LOCK_SHARED or STORAGE_LOCK_EXCLUSIVE.
+ * @param  derived Hooks of the state derived from the file, may be NULL.
+ * @return F_OK once locked, otherwise error code.
+ */
+F_Return_t Storage_Lock(Storage_Lock_Mode_t mode, const Storage_Derived_t* derived)
+{
+    bool exclusive = (mode == STORAGE_LOCK_EXCLUSIVE);
+    F_Return_t status = F_OK;
+
+    if (lock_depth > 0)
+    {
+        if (exclusive && lock_mode != STORAGE_LOCK_EXCLUSIVE)
+            return F_NOT_OK;
+        lock_depth++;
+        return F_OK;
+    }
+
+    if (!lock_opened)
+    {
+        if (Platform_Open_Lock(DB_LOCK_FILE_NAME, &db_lock) != 0)
+            return F_FILE_OPEN_ERROR;
+        lock_opened = true;
+    }
+
+    while (1)
+    {
+        if (Platform_Lock_File(&db_lock, exclusive) != 0)
+            return F_FILE_OPEN_ERROR;
+        if (!Changed_Elsewhere())
+            break;
+
+        /* Reopening may replay the log and rebuild indexes: writers only */
+        if (!exclusive)
+        {
+            Platform_Unlock_File(&db_lock);
+            if (Platform_Lock_File(&db_lock, true) != 0)
+                return F_FILE_OPEN_ERROR;
+        }
+        status = Refresh(derived);
+        if (exclusive || status != F_OK)
+            break;
+
+        /* A writer may get in before the shared lock, check again */
+        Platform_Unlock_File(&db_lock);
+    }
+
+    if (status != F_OK)
+    {
+        Platform_Unlock_File(&db_lock);
+        return status;
+    }
+    lock_mode = mode;
+    lock_derived = derived;
+    lock_depth = 1;
+    return F_OK;
+}
+
+/**
+ * @brief  Releases the lock taken by the matching Storage_Lock.
+ *
+ * @details
+ * - The outermost exclusive unlock rolls back an abandoned
+ *   transaction, syncs the open log group and publishes the
+ *   derived state, so other processes find every change.
+ */
+void Storage_Unlock(void)
+{
+    if (lock_depth == 0 || --lock_depth > 0)
+        return;
+
+    if (lock_mode == STORAGE_LOCK_EXCLUSIVE && db_fp)
+    {
+        Storage_Rollback();
+        Sync_Group();
+        if (lock_derived && lock_derived->publish)
+            lock_derived->publish();
+    }
+    lock_derived = NULL;
+    Platform_Unlock_File(&db_lock);
+}
+
+/**
+ * @brief  Tells other processes that a derived file was rewritten.
+ *
+ * @details
+ * - Bumps the epoch in the file header; processes holding the
+ *   old file open reopen it at their next Storage_Lock.
+ *
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Touch(void)
+{
+    F_Return_t status;
+
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    /* The header must not carry the counters of an open group */
+    status = Sync_Group();
+    if (status != F_OK)
+        return status;
+
+    /* Above any epoch seen, even across a restored or cleared file */
+    if (header.epoch < highest_epoch)
+        header.epoch = highest_epoch;
+    highest_epoch = ++header.epoch;
+    return Write_Header(db_fp, &header);
+}
+
+/**
+ * @brief  Starts a transaction.
+ *
+ * @details
+ * - Syncs the open log group first, so the changes made until
+ *   Storage_Commit form a group of their own, however many.
+ * - Loads the free-list up front: inserts in the transaction
+ *   must not read the file.
+ * - Storage_Map, Storage_Read_Batch, Storage_Insert_Batch and
+ *   Storage_Compact fail until the transaction ends.
+ *
+ * @return F_OK if the transaction started, otherwise error code.
+ */
+F_Return_t Storage_Begin(void)
+{
+    F_Return_t status;
+
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+    if (in_transaction)
+        return F_NOT_OK;
+
+    status = Sync_Group();
+    if (status == F_OK)
+        status = Load_Free_List();
+    if (status != F_OK)
+        return status;
+
+    saved_header = header;
+    WAL_Savepoint(&savepoint);
+    in_transaction = true;
+    return F_OK;
+}
+
+/**
+ * @brief  Drops every change of the open transaction.
+ *
+ * @details
+ * - Discards the held slot images and their log records and
+ *   restores the header counters; the file was never touched.
+ * - Does nothing when no transaction is open.
+ */
+void Storage_Rollback(void)
+{
+    if (!in_transaction)
+        return;
+
+    in_transaction = false;
+    for (uint32_t i = 0; i < pending_count; i++)
+        Record_Cache_Drop(pending_slots[i]);
+    pending_count = 0;
+    pending_uncached = 0;
+    uncommitted = unsynced = false;
+    header = saved_header;
+    WAL_Rollback(&savepoint);
+
+    /* Slots taken and freed by the transaction: rescan on next use */
+    free_count = 0;
+    free_list_loaded = false;
+}
+
+/**
+ * @brief  Checks whether a transaction is open.
+ *
+ * @details
+ * - Still true after a Storage_Commit whose log write failed.
+ *
+ * @return true between Storage_Begin and its commit or rollback.
+ */
+bool Storage_In_Transaction(void)
+{
+    return in_transaction;
+}
+
+/**
+ * @brief  Commits the changes made since the last commit.
+ *
+ * @details
+ * - Closes them with a commit record in the write-ahead log.
+ * - With WAL_SYNC_ON_COMMIT the log is forced to the disk with
+ *   one append, together with every change waiting in the group,
+ *   and the changes are then written to the database file.
+ * - A transaction is always forced to the disk. If its log
+ *   cannot be written it stays open, to be rolled back.
+ *
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Commit(void)
+{
+    if (!db_fp)
+        return F_OK;
+
+    if (in_transaction)
+    {
+        /* One commit record and one sync for the whole transaction */
+        F_Return_t status = Log_Commit();
+        if (status == F_OK)
+            status = WAL_Flush(true);
+        if (status != F_OK)
+            return status;
+
+        in_transaction = false;
+        unsynced = false;
+        return Apply_Group();
+    }
+
+    F_Return_t status = Log_Commit();
+    if (status != F_OK || !unsynced)
+        return status;
+#if WAL_SYNC_ON_COMMIT
+    return Sync_Group();
+#else
+    return WAL_Flush(false);
+#endif
+}
+
+/**
+ * @brief  Returns the number of record slots in the database.
+ *
+ * @param  count Pointer to store the slot count.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Record_Count(uint32_t* count)
+{
+    if (!count)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    *count = header.record_count;
+    return F_OK;
+}
+
+/**
+ * @brief  Returns the change counter stored in the file header.
+ *
+ * @details
+ * - Derived files (indexes) store the generation they were built
+ *   for and rebuild themselves when it no longer matches.
+ *
+ * @param  generation Pointer to store the generation.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Get_Generation(uint32_t* generation)
+{
+    if (!generation)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    *generation = header.generation;
+    return F_OK;
+}
+
+/**
+ * @brief  Maps the whole database into memory as a record array.
+ *
+ * @details
+ * - Maps the file once and remaps it only when the slot count
+ *   changed since the last call.
+ * - Syncs the open log group first, so every change made before
+ *   the call is in the array.
+ * - The array stays valid until the next insert, compaction or
+ *   Storage_Close; later overwrites show up in it once synced.
+ * - Falls back to a heap copy if the file cannot be mapped.
+ *
+ * @param  records Pointer to store the first record, NULL if empty.
+ * @param  count   Pointer to store the number of records.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Map(const Student_t** records, uint32_t* count)
+{
+    if (!records || !count)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+    if (Sync_Group() != F_OK)
+        return F_FILE_WRITE_ERROR;
+
+    if (mapped_count != header.record_count || (header.record_count > 0 && !mapped_records))
+    {
+        Unmap_Records();
+        fflush(db_fp);
+
+        if (header.record_count > 0)
+        {
+            if (Platform_Map_File(DB_FILE_NAME, (size_t)Slot_Offset(header.record_count), &db_map) == 0)
+            {
+                mapped_records = (const Student_t*)((const uint8_t*)db_map.data + DB_HEADER_SIZE);
+            }
+            else
+            {
+                uint32_t got = 0;
+                db_copy = malloc(header.record_count * sizeof(Student_t));
+                if (!db_copy || Storage_Read_Batch(0, header.record_count, db_copy, &got) != F_OK)
+                {
+                    Unmap_Records();
+                    return F_FILE_READ_ERROR;
+                }
+                mapped_records = db_copy;
+            }
+        }
+        mapped_count = header.record_count;
+    }
+
+    *records = mapped_records;
+    *count = mapped_count;
+    return F_OK;
+}
+
+/**
+ * @brief  Reads the record stored in a slot.
+ *
+ * @details
+ * - Sees changes still held in the open log group.
+ * - Served from the record cache, then from the memory mapping
+ *   when the slot is mapped; records read from the file are cached.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Pointer to store the record.
+ * @return F_OK on success, otherwise F_FILE_READ_ERROR.
+ */
+F_Return_t Storage_Read(uint32_t slot, Student_t* student)
+{
+    if (!student)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    /* Popular records, and the changes of the open log group */
+    if (Record_Cache_Get(slot, student))
+        return F_OK;
+
+    /* Changes the cache had no room for are not in the file yet */
+    for (uint32_t i = 0; pending_uncached > 0 && i < pending_count; i++)
+    {
+        if (pending_slots[i] == slot)
+        {
+            *student = pending_images[i];
+            return F_OK;
+        }
+    }
+
+    /* The mapping shares the page cache with the stream, no syscall needed */
+    if (db_map.data && slot < mapped_count)
+    {
+        *student = mapped_records[slot];
+        return F_OK;
+    }
+
+    if (fseek(db_fp, Slot_Offset(slot), SEEK_SET) != 0)
+        return F_FILE_READ_ERROR;
+    if (fread(student, sizeof(Student_t), 1, db_fp) != 1)
+        return F_FILE_READ_ERROR;
+
+    /* Keep it for the next lookup, evicting a cold record if needed */
+    Record_Cache_Put(slot, student, false);
+    return F_OK;
+}
+
+/**
+ * @brief  Overwrites the record stored in a slot.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record to store.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t Storage_Write(uint32_t slot, const Student_t* student)
+{
+    F_Return_t status;
+
+    if (!student)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    status = Write_Slot(slot, student);
+    if (status != F_OK)
+        return status;
+    return Header_Changed();
+}
+
+/**
+ * @brief  Appends a record at the end of the database.
+ *
+ * @param  student Record to store.
+ * @param  slot    Pointer to store the slot the record was written to.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t Storage_Append(const Student_t* student, uint32_t* slot)
+{
+    F_Return_t status;
+
+    if (!student || !slot)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    *slot = header.record_count;
+    status = Write_Slot(*slot, student);
+    if (status != F_OK)
+        return status;
+
+    if (student->is_active)
+        header.live_count++;
+    else
+        header.dead_count++;
+    return Header_Changed();
+}
+
+/**
+ * @brief  Stores a new record, reusing a free slot when available.
+ *
+ * @details
+ * - Takes a slot from the free-list of deleted records first.
+ * - Appends at the end of the database if the free-list is empty.
+ *
+ * @param  student Record to store.
+ * @param  slot    Pointer to store the slot the record was written to.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t Storage_Insert(const Student_t* student, uint32_t* slot)
+{
+    F_Return_t status;
+
+    if (!student || !slot)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+    if (Load_Free_List() != F_OK)
+        return F_FILE_READ_ERROR;
+
+    if (free_count == 0)
+        return Storage_Append(student, slot);
+
+    *slot = free_slots[free_count - 1];
+    status = Write_Slot(*slot, student);
+    if (status != F_OK)
+        return status;
+
+    free_count--;
+    header.live_count++;
+    header.dead_count--;
+    return Header_Changed();
+}
+
+/**
+ * @brief  Reads a run of consecutive records with one read call.
+ *
+ * @param  first_slot First slot to read.
+ * @param  count      Maximum number of records to read.
+ * @param  students   Buffer with room for count records.
+ * @param  read_count Pointer to store the number of records read.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Read_Batch(uint32_t first_slot, uint32_t count, Student_t* students, uint32_t* read_count)
+{
+    if (!students || !read_count)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    if (Sync_Group() != F_OK)
+        return F_FILE_WRITE_ERROR;
+
+    *read_count = 0;
+    if (first_slot >= header.record_count)
+        return F_OK;
+    if (count > header.record_count - first_slot)
+        count = header.record_count - first_slot;
+
+    if (fseek(db_fp, Slot_Offset(first_slot), SEEK_SET) != 0)
+        return F_FILE_READ_ERROR;
+
+    *read_count = (uint32_t)fread(students, sizeof(Student_t), count, db_fp);
+    return (*read_count == count) ? F_OK : F_FILE_READ_ERROR;
+}
+
+/**
+ * @brief  Stores a batch of new records.
+ *
+ * @details
+ * - Fills free slots of deleted records first.
+ * - Appends the remaining records with a single write call.
+ *
+ * @param  students Records to store.
+ * @param  count    Number of records.
+ * @param  slots    Array to store the slot of every record, may be NULL.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t Storage_Insert_Batch(const Student_t* students, uint32_t count, uint32_t* slots)
+{
+    uint32_t done = 0;
+    uint32_t slot;
+    F_Return_t status;
+
+    if (!students)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+    if (in_transaction)
+        return F_NOT_OK;
+    if (Load_Free_List() != F_OK)
+        return F_FILE_READ_ERROR;
+
+    /* ---------- Reuse free slots one by one ---------- */
+    while (done < count && free_count > 0)
+    {
+        status = Storage_Insert(&students[done], &slot);
+        if (status != F_OK)
+            return status;
+        if (slots)
+            slots[done] = slot;
+        done++;
+    }
+    if (done == count)
+        return F_OK;
+
+    /* ---------- Append the rest in one write ---------- */
+    uint32_t remaining = count - done;
+    status = Sync_Group();
+    if (status != F_OK)
+        return status;
+    if (fseek(db_fp, Slot_Offset(header.record_count), SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(&students[done], sizeof(Student_t), remaining, db_fp) != remaining)
+        return F_FILE_WRITE_ERROR;
+
+    /*
+     * The appended slots lie past the committed record count, so
+     * they are not logged: they are made durable here and the
+     * commit that counts them follows. Recovery trims them if it
+     * never made it to the log.
+     */
+    if (Platform_Sync_File(db_fp) != 0)
+        return F_FILE_WRITE_ERROR;
+
+    for (uint32_t i = 0; i < remaining; i++)
+    {
+        if (slots)
+            slots[done + i] = header.record_count + i;
+        if (students[done + i].is_active)
+            header.live_count++;
+        else
+            header.dead_count++;
+    }
+    header.record_count += remaining;
+    Header_Changed();
+    return Sync_Group();
+}
+
+/**
+ * @brief  Writes a logically deleted record and frees its slot.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record with is_active cleared.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t Storage_Delete(uint32_t slot, const Student_t* student)
+{
+    F_Return_t status;
+
+    if (!student)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    status = Write_Slot(slot, student);
+    if (status != F_OK)
+        return status;
+
+    header.live_count--;
+    header.dead_count++;
+
+    /* An unloaded free-list picks the slot up when it is scanned */
+    if (free_list_loaded && Push_Free_Slot(slot) != F_OK)
+        return F_NOT_OK;
+    return Header_Changed();
+}
+
+/**
+ * @brief  Returns the number of live and dead record slots.
+ *
+ * @param  live Pointer to store the active record count.
+ * @param  dead Pointer to store the deleted record count.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Get_Counts(uint32_t* live, uint32_t* dead)
+{
+    if (!live || !dead)
+        return F_NOT_OK;
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    *live = header.live_count;
+    *dead = header.dead_count;
+    return F_OK;
+}
+
+/**
+ * @brief  Checks whether dead slots exceed the compaction threshold.
+ *
+ * @return true if more than COMPACTION_THRESHOLD_PERCENT of slots are dead.
+ */
+bool Storage_Needs_Compaction(void)
+{
+    uint32_t live, dead;
+
+    if (Storage_Get_Counts(&live, &dead) != F_OK || dead == 0)
+        return false;
+
+    return (uint64_t)dead * 100 > (uint64_t)(live + dead) * COMPACTION_THRESHOLD_PERCENT;
+}
+
+static int Compare_Slots(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief  Reclaims dead slots by moving tail records into holes.
+ *
+ * @details
+ * - Moves at most max_moves live records from the end of the file
+ *   into the lowest free slots.
+ * - Drops the dead slots left at the end of the file from the
+ *   record count. The file keeps its size, since other processes
+ *   may have it mapped, and later appends reuse the freed tail.
+ * - Reports every move through the relocate callback so indexes
+ *   can follow the record.
+ *
+ * @param  max_moves Maximum number of records to move in this step.
+ * @param  relocate  Callback for moved records, may be NULL.
+ * @param  moved     Pointer to store the number of records moved, may be NULL.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Compact(uint32_t max_moves, Storage_Relocate_t relocate, uint32_t* moved)
+{
+    Student_t student;
+    Student_t cleared = { 0 };      /* Inactive image left in a slot moved out of */
+    uint32_t moves = 0;
+    uint32_t head = 0;            /* Lowest free slot not yet filled */
+    F_Return_t status = F_OK;
+
+    if (Storage_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+    if (in_transaction)
+        return F_NOT_OK;
+    if (Load_Free_List() != F_OK)
+        return F_FILE_READ_ERROR;
+
+    /* Fill holes from the front, take records from the back */
+    qsort(free_slots, free_count, sizeof(uint32_t), Compare_Slots);
+
+    while (head < free_count)
+    {
+        /* Drop dead slots sitting at the end of the file */
+        if (free_slots[free_count - 1] == header.record_count - 1)
+        {
+            free_count--;
+            header.record_count--;
+            header.dead_count--;
+            continue;
+        }
+        if (moves == max_moves)
+            break;
+
+        uint32_t from = header.record_count - 1;
+        uint32_t to = free_slots[head];
+
+        /* Both writes of a move go in one group, with the counters they change */
+        if (pending_count + 2 > WAL_GROUP_COMMIT_RECORDS)
+            status = Sync_Group();
+        if (status == F_OK)
+            status = Storage_Read(from, &student);
+        if (status != F_OK)
+            break;
+        status = Write_Slot(to, &student);
+
+        /* In the same group, so a recount of the file never finds the record twice */
+        if (status == F_OK)
+            status = Write_Slot(from, &cleared);
+        if (status != F_OK)
+            break;
+
+        if (relocate)
+            relocate(&student, from, to);
+
+        head++;
+        header.record_count--;
+        header.dead_count--;
+        moves++;
+    }
+
+    /* Keep the unfilled holes on the free-list */
+    memmove(free_slots, &free_slots[head], (free_count - head) * sizeof(uint32_t));
+    free_count -= head;
+
+    /* The moves must be durable before their source slots are cut off */
+    if (Sync_Group() != F_OK && status == F_OK)
+        status = F_FILE_WRITE_ERROR;
+
+    /* Past the record count the slots are free space, whatever they hold */
+    Record_Cache_Drop_From(header.record_count);
+    if (Header_Changed() != F_OK && status == F_OK)
+        status = F_FILE_WRITE_ERROR;
+
+    if (moved)
+        *moved = moves;
+    return status;
+}
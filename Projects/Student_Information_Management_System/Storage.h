@@ -0,0 +1,339 @@
+#ifndef _Storage_H_
+#define _Storage_H_
+
+/* ============================================================
+ *  Record Storage
+ *
+ *  Description:
+ *  Record-addressed access to the student database file. Every
+ *  Student_t occupies one fixed-size slot, so a record can be
+ *  read or overwritten in place by seeking to its slot offset
+ *  instead of rewriting the whole file.
+ *
+ *  The file starts with a versioned header that describes the
+ *  record layout and keeps the live/dead counters, so opening
+ *  the database never scans the records.
+ *
+ *  Changes go through the write-ahead log first: slot writes
+ *  are logged and held in memory, and reach the file only after
+ *  Storage_Commit has forced their log group to the disk.
+ *  Between Storage_Begin and Storage_Commit the changes form a
+ *  single group, so they reach the file all together or, after
+ *  Storage_Rollback or a crash, not at all.
+ *
+ *  Point reads go through the record cache. The images held by
+ *  the open log group are pinned in it as dirty entries and are
+ *  marked clean once the group is written back to the file.
+ *
+ *  Several processes may open the same database. Storage_Lock
+ *  takes a lock on a file next to it: any number of readers
+ *  share it, a writer holds it alone, so no reader sees a half
+ *  written change. Each process notices the changes of the
+ *  others through the generation and epoch in the header and
+ *  the size of the log, and reopens the file when they moved.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define COMPACTION_THRESHOLD_PERCENT   30      /* Compact when more than 30% of slots are dead */
+#define COMPACTION_STEP_RECORDS        1024    /* Max records moved per compaction step */
+
+#define DB_MAGIC                       "SIMS"  /* First bytes of the database file */
+#define DB_FORMAT_VERSION              1       /* Current on-disk format */
+#define DB_HEADER_SIZE                 128     /* Bytes reserved for the header */
+#define DB_LOCK_FILE_NAME              "Students_Information.lck"
+
+/**
+ * @brief  Called by compaction for every live record it moves.
+ *
+ * @param  student  Record that was moved.
+ * @param  old_slot Slot the record was read from.
+ * @param  new_slot Slot the record now occupies.
+ */
+typedef void (*Storage_Relocate_t)(const Student_t* student, uint32_t old_slot, uint32_t new_slot);
+
+typedef enum
+{
+    STORAGE_LOCK_SHARED = 0,        /* Readers, any number at once */
+    STORAGE_LOCK_EXCLUSIVE          /* One writer, no reader */
+} Storage_Lock_Mode_t;
+
+/* Keeps the state derived from the database (indexes) in step across processes */
+typedef struct
+{
+    void (*discard)(void);          /* Drops it without writing anything */
+    F_Return_t (*reopen)(void);     /* Loads it for the reopened file */
+    void (*publish)(void);          /* Writes out what other processes read */
+} Storage_Derived_t;
+
+/**
+ * @brief  Opens the database file for record access.
+ *
+ * @details
+ * - Creates the database file if it does not exist.
+ * - Does nothing if the file is already open.
+ * - Takes the record counters from the file header in O(1).
+ * - Migrates legacy headerless files and files written with
+ *   another record layout to the current format.
+ * - Replays the groups a crash left committed in the write-ahead
+ *   log; uncommitted appends are left past the record count.
+ *
+ * @return F_OK if the file is ready, otherwise F_FILE_OPEN_ERROR.
+ */
+F_Return_t Storage_Open(void);
+
+/**
+ * @brief  Closes the database file.
+ *
+ * @details
+ * - Rolls back an open transaction.
+ * - Syncs the open log group and checkpoints the log, so a clean
+ *   close leaves every change in the file and an empty log.
+ * - Must be called before another stream reads, truncates or
+ *   replaces the database file; the next access reopens it.
+ */
+void Storage_Close(void);
+
+/**
+ * @brief  Takes the database lock shared between processes.
+ *
+ * @details
+ * - Shared holders only read; one exclusive holder reads and
+ *   writes while nobody else holds the lock.
+ * - Calls nest: inner calls reuse the outer lock, and an inner
+ *   exclusive request under a shared lock fails.
+ * - When another process changed the file since this process
+ *   last held the lock, drops the open file and derived state
+ *   and reopens them, under the exclusive lock.
+ *
+ * @param  mode    STORAGE_LOCK_SHARED or STORAGE_LOCK_EXCLUSIVE.
+ * @param  derived Hooks of the state derived from the file, may be NULL.
+ * @return F_OK once locked, otherwise error code.
+ */
+F_Return_t Storage_Lock(Storage_Lock_Mode_t mode, const Storage_Derived_t* derived);
+
+/**
+ * @brief  Releases the lock taken by the matching Storage_Lock.
+ *
+ * @details
+ * - The outermost exclusive unlock rolls back an abandoned
+ *   transaction, syncs the open log group and publishes the
+ *   derived state, so other processes find every change.
+ */
+void Storage_Unlock(void);
+
+/**
+ * @brief  Tells other processes that a derived file was rewritten.
+ *
+ * @details
+ * - Bumps the epoch in the file header; processes holding the
+ *   old file open reopen it at their next Storage_Lock.
+ *
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Touch(void);
+
+/**
+ * @brief  Starts a transaction.
+ *
+ * @details
+ * - Syncs the open log group first, so the changes made until
+ *   Storage_Commit form a group of their own, however many.
+ * - Loads the free-list up front: inserts in the transaction
+ *   must not read the file.
+ * - Storage_Map, Storage_Read_Batch, Storage_Insert_Batch and
+ *   Storage_Compact fail until the transaction ends.
+ *
+ * @return F_OK if the transaction started, otherwise error code.
+ */
+F_Return_t Storage_Begin(void);
+
+/**
+ * @brief  Drops every change of the open transaction.
+ *
+ * @details
+ * - Discards the held slot images and their log records and
+ *   restores the header counters; the file was never touched.
+ * - Does nothing when no transaction is open.
+ */
+void Storage_Rollback(void);
+
+/**
+ * @brief  Checks whether a transaction is open.
+ *
+ * @details
+ * - Still true after a Storage_Commit whose log write failed.
+ *
+ * @return true between Storage_Begin and its commit or rollback.
+ */
+bool Storage_In_Transaction(void);
+
+/**
+ * @brief  Commits the changes made since the last commit.
+ *
+ * @details
+ * - Closes them with a commit record in the write-ahead log.
+ * - With WAL_SYNC_ON_COMMIT the log is forced to the disk with
+ *   one append, together with every change waiting in the group,
+ *   and the changes are then written to the database file.
+ * - A transaction is always forced to the disk. If its log
+ *   cannot be written it stays open, to be rolled back.
+ *
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Commit(void);
+
+/**
+ * @brief  Returns the number of record slots in the database.
+ *
+ * @param  count Pointer to store the slot count.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Record_Count(uint32_t* count);
+
+/**
+ * @brief  Returns the change counter stored in the file header.
+ *
+ * @details
+ * - Derived files (indexes) store the generation they were built
+ *   for and rebuild themselves when it no longer matches.
+ *
+ * @param  generation Pointer to store the generation.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Get_Generation(uint32_t* generation);
+
+/**
+ * @brief  Maps the whole database into memory as a record array.
+ *
+ * @details
+ * - Maps the file once and remaps it only when the slot count
+ *   changed since the last call.
+ * - The array stays valid until the next insert, compaction or
+ *   Storage_Close; in-place overwrites show up in it directly.
+ * - Falls back to a heap copy if the file cannot be mapped.
+ *
+ * @param  records Pointer to store the first record, NULL if empty.
+ * @param  count   Pointer to store the number of records.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Map(const Student_t** records, uint32_t* count);
+
+/**
+ * @brief  Reads the record stored in a slot.
+ *
+ * @details
+ * - Sees changes still held in the open log group.
+ * - Served from the record cache, then from the memory mapping
+ *   when the slot is mapped; records read from the file are cached.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Pointer to store the record.
+ * @return F_OK on success, otherwise F_FILE_READ_ERROR.
+ */
+F_Return_t Storage_Read(uint32_t slot, Student_t* student);
+
+/**
+ * @brief  Overwrites the record stored in a slot.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record to store.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t Storage_Write(uint32_t slot, const Student_t* student);
+
+/**
+ * @brief  Appends a record at the end of the database.
+ *
+ * @param  student Record to store.
+ * @param  slot    Pointer to store the slot the record was written to.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t Storage_Append(const Student_t* student, uint32_t* slot);
+
+/**
+ * @brief  Reads a run of consecutive records with one read call.
+ *
+ * @param  first_slot First slot to read.
+ * @param  count      Maximum number of records to read.
+ * @param  students   Buffer with room for count records.
+ * @param  read_count Pointer to store the number of records read.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Read_Batch(uint32_t first_slot, uint32_t count, Student_t* students, uint32_t* read_count);
+
+/**
+ * @brief  Stores a batch of new records.
+ *
+ * @details
+ * - Fills free slots of deleted records first.
+ * - Appends the remaining records with a single write call.
+ *
+ * @param  students Records to store.
+ * @param  count    Number of records.
+ * @param  slots    Array to store the slot of every record, may be NULL.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t Storage_Insert_Batch(const Student_t* students, uint32_t count, uint32_t* slots);
+
+/**
+ * @brief  Stores a new record, reusing a free slot when available.
+ *
+ * @details
+ * - Takes a slot from the free-list of deleted records first.
+ * - Appends at the end of the database if the free-list is empty.
+ *
+ * @param  student Record to store.
+ * @param  slot    Pointer to store the slot the record was written to.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t Storage_Insert(const Student_t* student, uint32_t* slot);
+
+/**
+ * @brief  Writes a logically deleted record and frees its slot.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record with is_active cleared.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t Storage_Delete(uint32_t slot, const Student_t* student);
+
+/**
+ * @brief  Returns the number of live and dead record slots.
+ *
+ * @param  live Pointer to store the active record count.
+ * @param  dead Pointer to store the deleted record count.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Get_Counts(uint32_t* live, uint32_t* dead);
+
+/**
+ * @brief  Checks whether dead slots exceed the compaction threshold.
+ *
+ * @return true if more than COMPACTION_THRESHOLD_PERCENT of slots are dead.
+ */
+bool Storage_Needs_Compaction(void);
+
+/**
+ * @brief  Reclaims dead slots by moving tail records into holes.
+ *
+ * @details
+ * - Moves at most max_moves live records from the end of the file
+ *   into the lowest free slots.
+ * - Drops the dead slots left at the end of the file from the
+ *   record count. The file keeps its size, since other processes
+ *   may have it mapped, and later appends reuse the freed tail.
+ * - Reports every move through the relocate callback so indexes
+ *   can follow the record.
+ *
+ * @param  max_moves Maximum number of records to move in this step.
+ * @param  relocate  Callback for moved records, may be NULL.
+ * @param  moved     Pointer to store the number of records moved, may be NULL.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Storage_Compact(uint32_t max_moves, Storage_Relocate_t relocate, uint32_t* moved);
+
+#endif // !_Storage_H_
@@ -264,35 +264,21 @@ int my_strspn(const char* str1, const char* str2)
 *
 *This function returns a pointer to the first occurrence in haystack of any of the entire sequence of characters specified in needle, or a null pointer if the sequence is not present in haystack.
 */
-/*
 char* my_strstr(const char* haystack, const char* needle)
 {
-	uint8_t* temp1 = haystack; uint8_t* temp2 = needle;
-	if ((NULL == temp1) || (NULL == temp2)) {}
-	else if (my_strlen(temp1) < my_strlen(temp2)) { printf("temp2>"); return NULL; }
-	else
-	{
-		if (temp1 == temp2)return temp1;
+	const uint8_t* temp1 = haystack; const uint8_t* temp2 = needle;
+	if ((NULL == temp1) || (NULL == temp2)) return NULL;
+	if ('\0' == temp2[0]) return (char*)temp1;
 
-		for (int i = 0; i < my_strlen(temp1); i++)
-		{
-			if (temp1[i] == temp2[0])
-			{
-				for (int k = 0; k < my_strlen(temp2); k++)
-				{
-					if (temp1[i] == temp2[k])
-					{
-						if (k == my_strlen(temp2) - 1)  return temp2;
-						i++;
-						continue;
-					}
-					else break;
-				}
-			}
-		}
+	for (; '\0' != *temp1; temp1++)
+	{
+		int k = 0;
+		while (('\0' != temp2[k]) && (temp1[k] == temp2[k]))
+			k++;
+		if ('\0' == temp2[k]) return (char*)temp1;
 	}
 	return NULL;
-}*/
+}
 
 
 /**
@@ -438,3 +424,31 @@ char* my_strncpy(char* dest, const char* src, size_t n)
 
 	return dest;
 }
+
+/* Computes the CRC-32 (IEEE 802.3) checksum of a memory block */
+uint32_t my_crc32(const void* data, size_t lenght)
+{
+	static uint32_t table[256];
+	static bool table_ready = false;
+	const uint8_t* bytes = data;
+	uint32_t crc = 0xFFFFFFFFUL;
+
+	/* Build the lookup table on first use */
+	if (!table_ready)
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t value = i;
+			for (int bit = 0; bit < 8; bit++)
+				value = (value & 1) ? (0xEDB88320UL ^ (value >> 1)) : (value >> 1);
+			table[i] = value;
+		}
+		table_ready = true;
+	}
+
+	while (lenght--)
+	{
+		crc = table[(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+	}
+	return (crc ^ 0xFFFFFFFFUL) & 0xFFFFFFFFUL;
+}
@@ -54,6 +54,8 @@ char* my_strtok(char* str, const char* delim);
 
 int my_strxfrm(char* dest, const char* src, int lenght);
 
+uint32_t my_crc32(const void* data, size_t lenght);
+
 
 
 #endif // !_String_H_
\ No newline at end of file
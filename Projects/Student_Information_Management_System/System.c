@@ -1,4 +1,11 @@
 ﻿#include "System.h"
+#include "ID_Index.h"
+#include "ID_Filter.h"
+#include "Storage.h"
+#include "Import.h"
+#include "Export.h"
+#include "Indexes.h"
+#include "Query.h"
 
 
 const char* Course_Names[] = {
@@ -16,280 +23,200 @@ const char* Course_Names[] = {
 };
 
 
+/* The indexes follow the database file when another process changes it */
+static const Storage_Derived_t Index_State = { Indexes_Discard, Indexes_Open, Indexes_Publish };
+
+/* At shutdown the indexes left by another process are not worth loading */
+static const Storage_Derived_t Closing_State = { Indexes_Discard, NULL, NULL };
+
 /**
  * @brief  Initializes the student management system.
  *
  * @details
  * - Creates the database file if it does not exist.
- * - Prepares the system for file-based operations.
+ * - Opens the ID index, column store and course index, rebuilding
+ *   any that is missing or stale.
  *
  * @return F_OK if initialization succeeds, otherwise error code.
  */
 F_Return_t System_Init(void) {
-    
-    FILE* fptr = NULL;
 
     /*
-     * Open the main database file in append + binary mode.
+     * The first lock opens the main database file and loads the
+     * indexes, rebuilding the ones that are missing or stale.
      * - Creates the file if it does not exist.
      * - Does NOT erase existing data if the file already exists.
      */
-    fptr = fopen("Students_Information.db", "ab+");
-
-    /* Check if file opening failed */
-    if (fptr == NULL)
+    if (System_Lock(true) != F_OK)
     {
         /* Failed to create or open database file */
         return F_FILE_OPEN_ERROR;
     }
-
-    /*
-     * Close the database file.
-     * At this point, the database file is guaranteed to exist.
-     */
-    fclose(fptr);
+    System_Unlock();
 
     /* System initialized successfully */
     return F_OK;
 
 }
 
-/* Helper function to check if ID exists in DB */
-static F_Return_t Is_ID_In_DB(uint32_t id)
+/**
+ * @brief  Shuts down the student management system.
+ *
+ * @details
+ * - Flushes and closes the index files kept open by the system.
+ */
+void System_Deinit(void)
 {
-    FILE* fp = fopen("Students_Information.db", "rb");
-    if (!fp) {
-        printf("Database file not found!\n");
-        return F_NOT_OK;
-    }
-
-    Student_t temp;
-    while (fread(&temp, sizeof(Student_t), 1, fp) == 1)
-    {
-       // printf("Checking ID: %u\n", temp.id); // Debug print
-        if (temp.id == id && temp.is_active) {
-            fclose(fp);
-            return F_OK;
-        }
-    }
+    bool locked = (Storage_Lock(STORAGE_LOCK_EXCLUSIVE, &Closing_State) == F_OK);
 
-    fclose(fp);
-    return F_ID_NOT_FOUND;
+    Indexes_Close();
+    Storage_Close();
+    if (locked)
+        Storage_Unlock();
 }
 
-
 /**
- * @brief  Imports student records from an external text file.
+ * @brief  Locks the database against other processes.
  *
  * @details
- * - Reads student data line by line from the specified file.
- * - Validates each record and prevents duplicate IDs.
- * - Ensures no student exceeds MAX_COURSES by asking user input if needed.
- * - Stores students with at least one course into the binary database.
+ * - Any number of processes may hold the shared lock to read;
+ *   the exclusive lock is held by one writer alone.
+ * - Reloads the records and indexes first if another process
+ *   changed the database since this one last held the lock.
+ * - Calls nest; every successful call needs a System_Unlock.
  *
- * @param  import_file Path to the external input file.
- * @return F_OK if all records processed successfully, otherwise error code.
+ * @param  exclusive true to write, false to read.
+ * @return F_OK once locked, otherwise error code.
  */
-F_Return_t Add_Student_From_File(const char* import_file)
+F_Return_t System_Lock(bool exclusive)
 {
-    if (!import_file) 
-    {
-        return F_NOT_OK;
-    }
-    FILE* import_fp = fopen(import_file, "r");
-    if (!import_fp) 
-    {
-        return F_FILE_OPEN_ERROR;
-    }
-    FILE* db_fp = fopen("Students_Information.db", "ab+"); // append + read
-    if (!db_fp)
-    {
-        fclose(import_fp);
-        return F_FILE_OPEN_ERROR;
-    }
-
-    char line[512];
-    Student_t student;
-    F_Return_t status = F_OK;
-
-    while (fgets(line, sizeof(line), import_fp))
-    {
-        my_memset(&student, 0, sizeof(Student_t));
-        student.is_active = 1;
-
-        uint8_t duplicate_id = 0;
-        uint8_t invalid_courses_flag = 0;
-        uint8_t course_count_mismatch = 0;
-
-        uint32_t expected_courses = 0;
-        uint32_t valid_courses_count = 0;
-
-        /* ---------- Parse ID ---------- */
-        char* token = my_strtok(line, ",");
-        if (!token) continue;
-        student.id = (uint32_t)atoi(token);
+    return Storage_Lock(exclusive ? STORAGE_LOCK_EXCLUSIVE : STORAGE_LOCK_SHARED, &Index_State);
+}
 
-        /* ---------- Check Duplicate ID ---------- */
-        rewind(db_fp);
-        Student_t tmp;
-        while (fread(&tmp, sizeof(Student_t), 1, db_fp) == 1)
-        {
-            if (tmp.id == student.id && tmp.is_active)
-            {
-                duplicate_id = 1;
-                break;
-            }
-        }
+/**
+ * @brief  Releases the lock taken by the matching System_Lock.
+ */
+void System_Unlock(void)
+{
+    Storage_Unlock();
+}
 
-        /* ---------- First Name ---------- */
-        token = my_strtok(NULL, ",");
-        if (!token) continue;
-        my_strncpy(student.first_name, token, sizeof(student.first_name) - 1);
-
-        /* ---------- Last Name ---------- */
-        token = my_strtok(NULL, ",");
-        if (!token) continue;
-        my_strncpy(student.last_name, token, sizeof(student.last_name) - 1);
-
-        /* ---------- GPA ---------- */
-        token = my_strtok(NULL, ",");
-        if (!token) continue;
-        student.GPA = atof(token);
-        if (student.GPA < 0.0f || student.GPA > 4.0f)
-        {
-            printf("Invalid GPA %.2f for student ID %u\n", student.GPA, student.id);
-            continue;
-        }
+/* Helper to find the slot of an active student through the ID index */
+static F_Return_t Lookup_Student(uint32_t id, uint32_t* slot, Student_t* student)
+{
+    /* Most absent IDs are settled without touching the index or data file */
+    if (!ID_Filter_May_Contain(id))
+        return F_ID_NOT_FOUND;
 
-        /* ---------- Expected Course Count ---------- */
-        token = my_strtok(NULL, ",");
-        if (!token) continue;
-        expected_courses = (uint32_t)atoi(token);
-        if (expected_courses == 0 || expected_courses > MAX_COURSES)
-        {
-            printf("Invalid expected course count %u for student ID %u\n", expected_courses, student.id);
-            continue;
-        }
+    if (ID_Index_Find(id, slot) != F_OK)
+        return F_ID_NOT_FOUND;
 
-        /* ---------- Courses ---------- */
-        while ((token = my_strtok(NULL, ",")) != NULL)
-        {
-            uint32_t course_id = (uint32_t)atoi(token);
+    /* Verify the slot still holds this student before trusting it */
+    if (Storage_Read(*slot, student) != F_OK || student->id != id || !student->is_active)
+        return F_ID_NOT_FOUND;
 
-            /* Skip invalid range */
-            if (course_id < 1 || course_id > MAX_COURSE_ID)
-            {
-                printf("Invalid course ID %u for student ID %u\n", course_id, student.id);
-                invalid_courses_flag = 1;
-                continue;
-            }
+    return F_OK;
+}
 
-            /* Skip duplicate course in this student */
-            int duplicate = 0;
-            for (int i = 0; i < valid_courses_count; i++)
-            {
-                if (student.courses[i] == course_id)
-                {
-                    duplicate = 1;
-                    break;
-                }
-            }
-            if (duplicate)
-            {
-                printf("Duplicate course %u for student ID %u\n", course_id, student.id);
-                invalid_courses_flag = 1;
-                continue;
-            }
+/* Helper function to check if ID exists in DB */
+static F_Return_t Is_ID_In_DB(uint32_t id)
+{
+    Student_t temp;
+    uint32_t slot;
 
-            /* Add course if valid */
-            if (valid_courses_count < MAX_COURSES)
-            {
-                student.courses[valid_courses_count++] = course_id;
-            }
-            else
-            {
-                printf("Too many courses for student ID %u (max %d)\n", student.id, MAX_COURSES);
-                invalid_courses_flag = 1;
-            }
-        }
+    return Lookup_Student(id, &slot, &temp);
+}
 
-        student.course_count = valid_courses_count;
 
-        /* ---------- Final Validation ---------- */
-        if (duplicate_id || invalid_courses_flag || student.course_count != expected_courses)
-        {
-            printf("Skipping student ID %u due to errors:\n", student.id);
-            if (duplicate_id) printf("  - Duplicate ID in DB\n");
-            if (invalid_courses_flag) printf("  - Invalid courses detected\n");
-            if (student.course_count != expected_courses) printf("  - Course count mismatch (expected %u, got %u)\n", expected_courses, student.course_count);
-            continue;
-        }
+/**
+ * @brief  Imports student records from an external text file.
+ *
+ * @details
+ * - Parses the file in chunks on worker threads and stores the
+ *   records in file order.
+ * - Validates each record and prevents duplicate IDs, checking them
+ *   against an ID set built with one pass over the database.
+ * - Ensures no student exceeds MAX_COURSES.
+ * - Stores students with at least one course into the binary database
+ *   using batched writes.
+ * - Lists rejected records in a CSV reject file instead of on
+ *   the console.
+ * - Holds the write lock for the whole import, so readers in
+ *   other processes wait for it to finish.
+ *
+ * @param  import_file Path to the external input file.
+ * @param  reject_file Path of the reject file to create, NULL for none.
+ * @param  report      Filled with the import counters, may be NULL.
+ * @return F_OK if all records processed successfully, otherwise error code.
+ */
+F_Return_t Add_Student_From_File(const char* import_file, const char* reject_file, Import_Report_t* report)
+{
+    /* One writer for the whole import: readers never see half of it */
+    F_Return_t status = System_Lock(true);
+    if (status != F_OK)
+        return status;
+
+    /* The bulk import engine handles parsing, validation and batching */
+    status = Import_From_File(import_file, reject_file, report);
+    System_Unlock();
+    return status;
+}
 
-        /* ---------- Write Valid Student ---------- */
-        fwrite(&student, sizeof(Student_t), 1, db_fp);
-    }
 
-    fclose(import_fp);
-    fclose(db_fp);
+/* Add_Student_Manually, under the write lock */
+static F_Return_t Insert_Student(const Student_t* student)
+{
+    /* Check if ID already exists */
+    if (Is_ID_In_DB(student->id) == F_OK)
+        return F_ID_ALREADY_EXISTS;
 
-    printf("Student import completed.\n");
-    return status;
+    /* Append new student to database */
+    uint32_t slot;
+    F_Return_t status = Storage_Insert(student, &slot);
+    if (status == F_OK)
+        status = Storage_Commit();
+    if (status != F_OK)
+        return status;
+
+    /* Record the new slot in every index */
+    return Indexes_On_Insert(slot, student);
 }
 
-
 /**
  * @brief  Adds a single student to the database using a given Student_t structure.
  *
  * @details
- * - Checks if the student ID already exists in the database.
- * - Appends the student record to the binary database file if valid.
+ * - Validates the record with Validate_Student first.
+ * - Checks if the student ID already exists: the ID filter
+ *   clears most new IDs, the ID index confirms the others.
+ * - Stores the record in a free slot, or appends it if none is free.
+ * - Commits it through the write-ahead log before indexing it.
+ * - Records the new slot in the ID index.
  *
  * @param  student Pointer to the student structure to add.
- * @return F_OK if student is added successfully, or error code.
+ * @return F_OK if student is added successfully, F_INVALID_FIELD
+ *         for an invalid record, or error code.
  */
 F_Return_t Add_Student_Manually(const Student_t* student)
 {
-    if (!student)
-        return F_NOT_OK;
-
-    /* Open main database file in append binary mode */
-    FILE* db_fp = fopen("Students_Information.db", "ab");
-    if (!db_fp)
-        return F_FILE_OPEN_ERROR;
-
-    /* Check if ID already exists */
-
-    FILE* check_fp = fopen("Students_Information.db", "rb");
-    if (!check_fp)
-    {
-        fclose(db_fp);
-        return F_FILE_OPEN_ERROR;
-    }
-
-    Student_t temp;
-    while (fread(&temp, sizeof(Student_t), 1, check_fp) == 1)
-    {
-        if (temp.id == student->id && temp.is_active)
-        {
-            fclose(check_fp);
-            fclose(db_fp);
-            return F_ID_ALREADY_EXISTS;
-        }
-    }
-    fclose(check_fp);
+    F_Return_t status = Validate_Student(student);
+    if (status != F_OK)
+        return status;
 
-    /* Append new student to database */
-    fwrite(student, sizeof(Student_t), 1, db_fp);
-    fclose(db_fp);
+    status = System_Lock(true);
+    if (status != F_OK)
+        return status;
 
-    return F_OK;
+    status = Insert_Student(student);
+    System_Unlock();
+    return status;
 }
 
 /**
  * @brief  Searches for a student using their unique ID.
  *
  * @details
- * - Scans the database file record by record.
+ * - Looks up the record slot through the ID index.
  * - Returns the student data if found.
  *
  * @param  id      Student unique ID.
@@ -300,26 +227,65 @@ F_Return_t Find_Student_By_ID(uint32_t id, Student_t* student) {
     if (!student)
         return F_NOT_OK;
 
-    /* Open database file in read binary mode */
-    FILE* db_fp = fopen("Students_Information.db", "rb");
-    if (!db_fp)
-        return F_FILE_OPEN_ERROR;
+    /* Readers share the lock, a writer cannot change the record under them */
+    F_Return_t status = System_Lock(false);
+    if (status != F_OK)
+        return status;
 
+    /* Locate the record through the ID index instead of scanning */
     Student_t temp;
-    while (fread(&temp, sizeof(Student_t), 1, db_fp) == 1)
+    uint32_t slot;
+    status = Lookup_Student(id, &slot, &temp);
+    if (status == F_OK)
+        *student = temp;  /* Copy data to output */
+
+    System_Unlock();
+    return status;
+
+}
+/**
+ * @brief  Looks up many students by ID under one shared lock.
+ *
+ * @details
+ * - Finds every slot with one ordered pass over the ID index,
+ *   then reads and verifies each record.
+ *
+ * @param  ids      IDs to look up.
+ * @param  count    Number of IDs.
+ * @param  students Array of count students, filled where found.
+ * @param  results  Array of count statuses, F_OK or F_ID_NOT_FOUND.
+ * @return F_OK if the lookups ran, otherwise error code.
+ */
+F_Return_t Find_Students_By_IDs(const uint32_t* ids, uint32_t count, Student_t* students, F_Return_t* results)
+{
+    if (!ids || !students || !results)
+        return F_NOT_OK;
+    if (count == 0)
+        return F_OK;
+
+    uint32_t* slots = malloc(count * sizeof(uint32_t));
+    if (!slots)
+        return F_NOT_OK;
+
+    F_Return_t status = System_Lock(false);
+    if (status == F_OK)
     {
-        /* Check for matching ID and active student */
-        if (temp.id == id && temp.is_active)
+        status = ID_Index_Find_Many(ids, count, slots);
+        for (uint32_t i = 0; status == F_OK && i < count; i++)
         {
-            *student = temp;  /* Copy data to output */
-            fclose(db_fp);
-            return F_OK;
+            /* Same check as Lookup_Student: the slot must still hold the ID */
+            results[i] = F_ID_NOT_FOUND;
+            if (slots[i] != ID_INDEX_NO_SLOT && Storage_Read(slots[i], &students[i]) == F_OK &&
+                students[i].id == ids[i] && students[i].is_active)
+            {
+                results[i] = F_OK;
+            }
         }
+        System_Unlock();
     }
 
-    fclose(db_fp);
-    return F_ID_NOT_FOUND;
-
+    free(slots);
+    return status;
 }
 //  ************** Helper function to print students details********************
 /**
@@ -355,298 +321,417 @@ void Print_Student(const Student_t* student)
 
     printf("\n=============================================================================================================\n");
 }
+/* Prints every record a cursor yields, then closes it */
+static F_Return_t Print_Query(Query_Cursor_t* cursor, F_Return_t none_found)
+{
+    Student_t student;
+    F_Return_t found = none_found;
+
+    while (Query_Next(cursor, &student, NULL))
+    {
+        Print_Student(&student);
+        found = F_OK;  /* At least one student displayed */
+    }
+    Query_Close(cursor);
+    return found;
+}
+
 /**
  * @brief  Searches for students using their first name.
  *
  * @details
- * - Compares the given name with database records.
- * - Displays all matching students.
+ * - Matches names case-insensitively, ignoring surrounding spaces.
+ * - Looks the name up in the first name hash index, falling back
+ *   to the name column or the records if it is unavailable.
+ * - Displays all matching students, read through a query cursor.
  *
  * @param  fname First name to search for.
  * @return F_OK if at least one student is found.
  */
 F_Return_t Find_Student_By_First_Name(const char* fname) {
-    if (!fname)
-        return F_NOT_OK;
+    Query_Cursor_t cursor;
 
-    FILE* db_fp = fopen("Students_Information.db", "rb");
-    if (!db_fp)
-        return F_FILE_OPEN_ERROR;
+    F_Return_t status = Query_By_First_Name(&cursor, fname, 0, QUERY_NO_LIMIT);
+    if (status != F_OK)
+        return status;
+    return Print_Query(&cursor, F_FNAME_NOT_FOUND);
+}
 
-    Student_t temp;
-    F_Return_t found = F_ID_NOT_FOUND;
+/**
+ * @brief  Type-ahead search over first and last names.
+ *
+ * @details
+ * - Matches case-insensitively, ignoring surrounding spaces.
+ * - Intersects the trigram lists of the text, falling back to a
+ *   record scan when the index is unavailable.
+ * - Stops once max_ids IDs are collected, in database order.
+ *
+ * @param  text    Text to search for.
+ * @param  match   NAME_MATCH_PREFIX or NAME_MATCH_SUBSTRING.
+ * @param  ids     Array to store the IDs of matching students.
+ * @param  max_ids Capacity of ids.
+ * @param  found   Pointer to store the number of IDs stored.
+ * @return F_OK if at least one student is found, otherwise F_FNAME_NOT_FOUND.
+ */
+F_Return_t Search_Students_By_Name(const char* text, Name_Match_t match, uint32_t* ids, uint32_t max_ids, uint32_t* found) {
+    Query_Cursor_t cursor;
+    Student_t student;
 
-    while (fread(&temp, sizeof(Student_t), 1, db_fp) == 1)
-    {
-        if (temp.is_active && my_memcmp(temp.first_name, fname,my_strlen(fname)) == 0)
-        {
-            Print_Student(&temp);  /* Print matching student */
-            found = F_OK;          /* Mark that at least one student is found */
-        }
-    }
+    if (!text || !ids || !found || max_ids == 0)
+        return F_NOT_OK;
 
-    fclose(db_fp);
-    return found;
- 
+    *found = 0;
+    F_Return_t status = Query_By_Name(&cursor, text, match, 0, max_ids);
+    if (status != F_OK)
+        return status;
+
+    while (Query_Next(&cursor, &student, NULL))
+        ids[(*found)++] = student.id;
+    Query_Close(&cursor);
+
+    return (*found) ? F_OK : F_FNAME_NOT_FOUND;
 }
 
 /**
  * @brief  Retrieves all students registered in a specific course.
  *
  * @details
- * - Iterates through database records.
+ * - Walks the course bitmap through Get_Students_By_Courses.
  * - Displays students enrolled in the given course.
  *
  * @param  course Course identifier.
  * @return F_OK if students are found, otherwise F_COURSE_NOT_FOUND.
  */
 F_Return_t Get_Students_By_Course(Course_t course) {
-    FILE* db_fp = fopen("Students_Information.db", "rb");
-    if (!db_fp)
-        return F_FILE_OPEN_ERROR;
+    if ((uint32_t)course > MAX_COURSE_ID)
+        return F_COURSE_NOT_FOUND;
 
-    Student_t student;
-    uint8_t found = 0;
-
-    while (fread(&student, sizeof(Student_t), 1, db_fp) == 1)
-    {
-        if (!student.is_active)
-            continue;
+    return Get_Students_By_Courses((Course_Mask_t)(1u << course), 0);
+}
 
-        for (uint32_t i = 0; i < student.course_count; i++)
-        {
-            if (student.courses[i] ==(uint8_t)course)
-            {
-                Print_Student(&student);
-                found = 1;
-                break;   
-            }
-        }
-    }
+/**
+ * @brief  Retrieves students by a combination of courses.
+ *
+ * @details
+ * - Intersects the course bitmaps of all_of and subtracts those
+ *   of none_of, one 64-bit word at a time.
+ * - Falls back to testing the course column, or the records,
+ *   when the course index is unavailable.
+ * - Displays every matching student.
+ *
+ * @param  all_of  Courses the student must take (bit n = course n).
+ * @param  none_of Courses the student must not take.
+ * @return F_OK if students are found, otherwise F_COURSE_NOT_FOUND.
+ */
+F_Return_t Get_Students_By_Courses(Course_Mask_t all_of, Course_Mask_t none_of) {
+    Query_Cursor_t cursor;
 
-    fclose(db_fp);
+    F_Return_t status = Query_By_Courses(&cursor, all_of, none_of, 0, QUERY_NO_LIMIT);
+    if (status != F_OK)
+        return status;
+    return Print_Query(&cursor, F_COURSE_NOT_FOUND);
+}
 
-    return (found) ? F_OK : F_COURSE_NOT_FOUND;
+/**
+ * @brief  Retrieves the students whose GPA lies in a range.
+ *
+ * @details
+ * - Walks the GPA skip list from min_gpa, no scan or sort.
+ * - Displays students by increasing GPA, then ID.
+ *
+ * @param  min_gpa Lowest GPA in range.
+ * @param  max_gpa Highest GPA in range.
+ * @return F_OK if students are found, otherwise F_GPA_NOT_FOUND.
+ */
+F_Return_t Get_Students_By_GPA_Range(float min_gpa, float max_gpa) {
+    Query_Cursor_t cursor;
 
+    F_Return_t status = Query_By_GPA_Range(&cursor, min_gpa, max_gpa, 0, QUERY_NO_LIMIT);
+    if (status != F_OK)
+        return status;
+    return Print_Query(&cursor, F_GPA_NOT_FOUND);
 }
 
 /**
- * @brief  Updates an existing student record.
+ * @brief  Retrieves the students with the highest GPA.
  *
  * @details
- * - Searches for the student by ID.
- * - Updates the student information in the database.
- * - Rewrites the database file to preserve consistency.
+ * - Walks the GPA skip list backward from its tail.
+ * - Displays students by decreasing GPA.
  *
- * @param  id Student unique ID.
- * @return F_OK if update succeeds, otherwise error code.
+ * @param  count Number of students to display.
+ * @return F_OK if students are found, otherwise F_GPA_NOT_FOUND.
  */
-F_Return_t Update_Student(uint32_t id) {
-    FILE* db_fp = fopen("Students_Information.db", "rb");
-    if (!db_fp)
-        return F_FILE_OPEN_ERROR;
+F_Return_t Get_Top_Students_By_GPA(uint32_t count) {
+    Query_Cursor_t cursor;
 
-    FILE* temp_fp = fopen("Temp.db", "wb");
-    if (!temp_fp)
-    {
-        fclose(db_fp);
-        return F_FILE_OPEN_ERROR;
-    }
+    /* QUERY_NO_LIMIT would list everyone */
+    if (count == 0)
+        return F_GPA_NOT_FOUND;
 
-    Student_t temp;
-    F_Return_t found = F_ID_NOT_FOUND;
+    F_Return_t status = Query_Top_By_GPA(&cursor, 0, count);
+    if (status != F_OK)
+        return status;
+    return Print_Query(&cursor, F_GPA_NOT_FOUND);
+}
 
-    while (fread(&temp, sizeof(Student_t), 1, db_fp) == 1)
+/**
+ * @brief  Checks that a record holds only values the database accepts.
+ *
+ * @details
+ * - Both names set, GPA from 0.0 to 4.0, 1 to MAX_COURSES
+ *   courses, each from 1 to MAX_COURSE_ID and listed once.
+ * - The rules of the file import, applied to every other way in.
+ *
+ * @param  student Record to check; the ID is not checked.
+ * @return F_OK if valid, otherwise F_INVALID_FIELD.
+ */
+F_Return_t Validate_Student(const Student_t* student)
+{
+    if (!student)
+        return F_NOT_OK;
+    if (student->first_name[0] == '\0' || student->last_name[0] == '\0')
+        return F_INVALID_FIELD;
+    if (!(student->GPA >= 0.0f && student->GPA <= 4.0f))
+        return F_INVALID_FIELD;
+    if (student->course_count == 0 || student->course_count > MAX_COURSES)
+        return F_INVALID_FIELD;
+
+    for (uint8_t i = 0; i < student->course_count; i++)
     {
-        if (temp.id == id && temp.is_active)
-        {
-            found = F_OK;
-            char input[100];
-
-            printf("\nUpdating Student ID: %u\n", id);
-            printf("Leave field unchanged by entering 0 or empty.\n");
-
-            /* ---------- First Name ---------- */
-            printf("Current First Name: %s\nEnter new First Name: ", temp.first_name);
-            fgets(input, sizeof(input), stdin);
-            input[strcspn(input, "\n")] = 0; // remove newline
-            if (my_strlen(input) > 0 && my_memcmp(input, "0",my_strlen(input)) != 0)
-                strncpy(temp.first_name, input, sizeof(temp.first_name) - 1);
-
-            /* ---------- Last Name ---------- */
-            printf("Current Last Name: %s\nEnter new Last Name: ", temp.last_name);
-            fgets(input, sizeof(input), stdin);
-            input[strcspn(input, "\n")] = 0;
-            if (strlen(input) > 0 && my_memcmp(input, "0", my_strlen(input)) != 0)
-                my_strncpy(temp.last_name, input, sizeof(temp.last_name) - 1);
-
-            /* ---------- GPA ---------- */
-            printf("Current GPA: %.2f\nEnter new GPA: ", temp.GPA);
-            fgets(input, sizeof(input), stdin);
-            input[my_strcspn(input, "\n")] = 0;
-            if (my_strlen(input) > 0 && my_memcmp(input, "0", my_strlen(input)) != 0)
-            {
-                float gpa_val = atof(input);
-                if (gpa_val >= 0.0f && gpa_val <= 4.0f)
-                    temp.GPA = gpa_val;
-                else
-                    printf("Invalid GPA! Keeping previous value.\n");
-            }
-
-            /* ---------- Courses ---------- */
-            printf("Current Courses (%d): ", temp.course_count);
-            for (int i = 0; i < temp.course_count; i++)
-                printf("%u ", temp.courses[i]);
-            printf("\nEnter number of new courses : ");
-            fgets(input, sizeof(input), stdin);
-            input[my_strcspn(input, "\n")] = 0;
-            if (my_strlen(input) > 0 && my_memcmp(input, "0", my_strlen(input)) != 0)
-            {
-                int new_count = atoi(input);
-                if (new_count > 0 && new_count <= MAX_COURSES)
-                {
-                    temp.course_count = new_count;
-                    for (int i = 0; i < new_count; i++)
-                    {
-                        while (1)
-                        {
-                            printf("Enter course %d (1-%d): ", i + 1, MAX_COURSES);
-                            fgets(input, sizeof(input), stdin);
-                            int cid = atoi(input);
-                            if (cid >= 1 && cid <= MAX_COURSES)
-                            {
-                                temp.courses[i] = cid;
-                                break;
-                            }
-                            else
-                            {
-                                printf("Invalid Course ID. Try again.\n");
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    printf("Invalid number of courses. Keeping old courses.\n");
-                }
-            }
-
-            printf("Student ID %u updated successfully.\n", id);
-        }
-
-        /* ---------- Write record to temp file ---------- */
-        if (fwrite(&temp, sizeof(Student_t), 1, temp_fp) != 1)
+        if (student->courses[i] < 1 || student->courses[i] > MAX_COURSE_ID)
+            return F_INVALID_FIELD;
+        for (uint8_t j = 0; j < i; j++)
         {
-            fclose(db_fp);
-            fclose(temp_fp);
-            return F_NOT_OK;
+            if (student->courses[j] == student->courses[i])
+                return F_INVALID_FIELD;
         }
     }
+    return F_OK;
+}
 
-    fclose(db_fp);
-    fclose(temp_fp);
+/* Copies a new name into a record field, NUL-terminated */
+static void Set_Name(char* field, const char* name)
+{
+    my_strncpy(field, name, MAX_NAME_LENGTH - 1);
+    field[MAX_NAME_LENGTH - 1] = '\0';
+}
 
-    /* Replace original DB if updated */
-    if (found == F_OK)
-    {
-        remove("Students_Information.db");
-        if (rename("Temp.db", "Students_Information.db") != 0)
-            return F_NOT_OK;
-    }
-    else
+/**
+ * @brief  Applies the selected update values to a record and checks it.
+ *
+ * @details
+ * - The updated record must pass Validate_Student.
+ *
+ * @param  student Record to change.
+ * @param  fields  Update_Field_t bits of the fields to change.
+ * @param  values  New values of the selected fields.
+ * @return F_OK if the updated record is valid, otherwise F_INVALID_FIELD;
+ *         the record may be partly changed then.
+ */
+F_Return_t Merge_Student_Update(Student_t* student, Update_Mask_t fields, const Student_Update_t* values)
+{
+    if (!student || (!values && fields))
+        return F_NOT_OK;
+
+    if (fields & UPDATE_FIRST_NAME)
+        Set_Name(student->first_name, values->first_name);
+    if (fields & UPDATE_LAST_NAME)
+        Set_Name(student->last_name, values->last_name);
+    if (fields & UPDATE_GPA)
+        student->GPA = values->GPA;
+    if (fields & UPDATE_COURSES)
     {
-        remove("Temp.db");
+        /* A longer list would not fit the record */
+        if (values->course_count > MAX_COURSES)
+            return F_INVALID_FIELD;
+        my_memset(student->courses, 0, sizeof(student->courses));
+        my_memcpy(student->courses, values->courses, values->course_count);
+        student->course_count = values->course_count;
     }
 
-    return found;
+    /* The updated record must pass the rules of every other write */
+    return Validate_Student(student);
+}
+
+/* Update_Student, under the write lock */
+static F_Return_t Apply_Update(uint32_t id, Update_Mask_t fields, const Student_Update_t* values)
+{
+    Student_t temp;
+    uint32_t slot;
+
+    if (!values && fields)
+        return F_NOT_OK;
+
+    /* Locate the record slot instead of copying the whole database */
+    F_Return_t found = Lookup_Student(id, &slot, &temp);
+    if (found != F_OK)
+        return found;
+
+    if (fields == 0)
+        return F_OK;
+
+    Student_t previous = temp;
+    F_Return_t status = Merge_Student_Update(&temp, fields, values);
+    if (status != F_OK)
+        return status;
 
+    /* ---------- Overwrite only this record's slot ---------- */
+    if (Storage_Write(slot, &temp) != F_OK || Storage_Commit() != F_OK)
+        return F_FILE_WRITE_ERROR;
+    Indexes_On_Update(slot, &previous, &temp);
+
+    return F_OK;
 }
 
 /**
- * @brief  Deletes a student record from the database.
+ * @brief  Updates selected fields of an existing student record.
  *
  * @details
- * - Performs a logical delete by setting is_active flag.
- * - Preserves database integrity.
+ * - Locates the student's record slot through the ID index.
+ * - Validates the updated record with Validate_Student before
+ *   changing anything.
+ * - Overwrites only that record's slot, committed through the
+ *   write-ahead log, then re-indexes it.
+ * - Never prompts, so batch jobs can drive it.
  *
- * @param  id Student unique ID.
- * @return F_OK if deletion succeeds.
+ * @param  id     Student unique ID.
+ * @param  fields Update_Field_t bits of the fields to change.
+ * @param  values New values of the selected fields.
+ * @return F_OK if update succeeds, F_ID_NOT_FOUND, F_INVALID_FIELD,
+ *         otherwise error code.
  */
-F_Return_t Delete_Student(uint32_t id) {
-    FILE* db_fp = fopen("Students_Information.db", "rb");
-    if (!db_fp)
-        return F_FILE_OPEN_ERROR;
+F_Return_t Update_Student(uint32_t id, Update_Mask_t fields, const Student_Update_t* values)
+{
+    F_Return_t status = System_Lock(true);
+    if (status != F_OK)
+        return status;
 
-    FILE* temp_fp = fopen("Temp.db", "wb");
-    if (!temp_fp)
-    {
-        fclose(db_fp);
-        return F_FILE_OPEN_ERROR;
-    }
+    status = Apply_Update(id, fields, values);
+    System_Unlock();
+    return status;
+}
 
+/* Delete_Student, under the write lock */
+static F_Return_t Remove_Student(uint32_t id) {
     Student_t temp;
-    F_Return_t found = F_ID_NOT_FOUND;
+    uint32_t slot;
 
-    while (fread(&temp, sizeof(Student_t), 1, db_fp) == 1)
-    {
-        if (temp.id == id && temp.is_active)
-        {
-            temp.is_active = 0;  /* Logical delete */
-            found = F_OK;
-        }
+    F_Return_t found = Lookup_Student(id, &slot, &temp);
+    if (found != F_OK)
+        return found;
 
-        fwrite(&temp, sizeof(Student_t), 1, temp_fp);
-    }
+    /* Logical delete: flip is_active in place and free the slot */
+    temp.is_active = 0;
+    if (Storage_Delete(slot, &temp) != F_OK || Storage_Commit() != F_OK)
+        return F_FILE_WRITE_ERROR;
 
-    fclose(db_fp);
-    fclose(temp_fp);
+    Indexes_On_Delete(slot, &temp);
+    return found;
+}
 
-    if (found == F_OK)
-    {
-        remove("Students_Information.db");
-        rename("Temp.db", "Students_Information.db");
-    }
-    else
-    {
-        remove("Temp.db");
-    }
+/**
+ * @brief  Deletes a student record from the database.
+ *
+ * @details
+ * - Performs a logical delete by clearing is_active in place,
+ *   committed through the write-ahead log.
+ * - Removes the record from every index.
+ *
+ * @param  id Student unique ID.
+ * @return F_OK if deletion succeeds.
+ */
+F_Return_t Delete_Student(uint32_t id)
+{
+    F_Return_t status = System_Lock(true);
+    if (status != F_OK)
+        return status;
 
-    return found;
+    status = Remove_Student(id);
+    System_Unlock();
+    return status;
 }
 
 /**
  * @brief  Displays all active students in the database.
  *
  * @details
- * - Iterates through the database file.
- * - Prints all valid student records.
+ * - Streams the active records through a Query_All cursor.
+ * - Prints each one as it is yielded.
  *
  * @return F_OK if records are displayed successfully.
  */
 F_Return_t Show_All_Students(void) {
-    FILE* db_fp = fopen("Students_Information.db", "rb");
-    if (!db_fp) {
-        return F_FILE_OPEN_ERROR;
-    }
-    else {
-        /*Nothing*/
-    }
+    Query_Cursor_t cursor;
 
-    Student_t temp;
-    F_Return_t found = F_FILE_IS_EMPTY;
+    F_Return_t status = Query_All(&cursor, 0, QUERY_NO_LIMIT);
+    if (status != F_OK)
+        return status;
+    return Print_Query(&cursor, F_FILE_IS_EMPTY);
+}
 
-    while (fread(&temp, sizeof(Student_t), 1, db_fp) == 1)
+/**
+ * @brief  Writes every active student to a file.
+ *
+ * @details
+ * - Streams the records in slot order through one large buffer.
+ * - A CSV export of all columns is in the format
+ *   Add_Student_From_File reads.
+ * - Holds the read lock, so the export is a consistent snapshot.
+ *
+ * @param  export_file Path of the file to create.
+ * @param  format      EXPORT_FORMAT_CSV or EXPORT_FORMAT_BINARY.
+ * @param  columns     Export_Column_t bits of the fields to write.
+ * @param  exported    Set to the number of students written, may be NULL.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Export_Students(const char* export_file, Export_Format_t format, Export_Columns_t columns, uint32_t* exported)
+{
+    /* Writers wait, so the file is one state of the database */
+    F_Return_t status = System_Lock(false);
+    if (status != F_OK)
+        return status;
+
+    status = Export_To_File(export_file, format, columns, exported);
+    System_Unlock();
+    return status;
+}
+
+/**
+ * @brief  Reclaims space held by logically deleted records.
+ *
+ * @details
+ * - Does nothing unless more than COMPACTION_THRESHOLD_PERCENT of
+ *   the record slots are dead.
+ * - Moves at most max_moves records per call so the work can be
+ *   spread over several calls.
+ *
+ * @param  max_moves Maximum number of records to move in this call.
+ * @return F_OK if compaction ran or was not needed, otherwise error code.
+ */
+F_Return_t Compact_Database(uint32_t max_moves)
+{
+    uint32_t moved = 0, live = 0, dead = 0;
+
+    F_Return_t status = System_Lock(true);
+    if (status != F_OK)
+        return status;
+
+    if (!Storage_Needs_Compaction())
     {
-        if (temp.is_active)
-        {
-            Print_Student(&temp);
-            found = F_OK;  /* At least one student displayed */
-        }
+        System_Unlock();
+        printf("Compaction not needed.\n");
+        return F_OK;
     }
 
-    fclose(db_fp);
-    return found;
-
+    status = Storage_Compact(max_moves, Indexes_On_Move, &moved);
+    if (status == F_OK)
+        status = Storage_Commit();
+    Storage_Get_Counts(&live, &dead);
+    System_Unlock();
+    printf("Compaction moved %u records (%u active, %u deleted remaining).\n",
+           (unsigned)moved, (unsigned)live, (unsigned)dead);
+    return status;
 }
 
 /**
@@ -661,11 +746,22 @@ F_Return_t Show_All_Students(void) {
  */
 F_Return_t Delete_All_Students(void)
 {
-    FILE* db_fp = fopen("Students_Information.db", "wb");  // Open in write mode to erase all content
+    /* Other processes reload the emptied file at their next lock */
+    F_Return_t status = System_Lock(true);
+    if (status != F_OK)
+        return status;
+
+    Storage_Close();
+    FILE* db_fp = fopen(DB_FILE_NAME, "wb");  // Open in write mode to erase all content
     if (!db_fp)
+    {
+        System_Unlock();
         return F_FILE_OPEN_ERROR;
+    }
 
     fclose(db_fp);  // Close the file after clearing
+    Indexes_Rebuild();
+    System_Unlock();
 
     printf("All students have been deleted successfully.\n");
     return F_OK;
@@ -683,7 +779,7 @@ F_Return_t Delete_All_Students(void)
  */
 static F_Return_t Backup_Student_DB(void)
 {
-    FILE* src = fopen("Students_Information.db", "rb");
+    FILE* src = fopen(DB_FILE_NAME, "rb");
     if (!src) return F_FILE_OPEN_ERROR;
 
     FILE* dest = fopen("Backup_Students_Information.db", "wb");
@@ -728,17 +824,29 @@ F_Return_t Delete_All_Students_Safe(void)
     if (confirm != 'y' && confirm != 'Y')
         return F_NOT_OK;
 
-    // Backup before deletion
+    // No other process may write between the backup and the clear
+    if (System_Lock(true) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    // Backup before deletion, from a closed and checkpointed file
+    Storage_Close();
     if (Backup_Student_DB() != F_OK)
     {
+        System_Unlock();
         printf("Backup failed! Aborting deletion.\n");
         return F_NOT_OK;
     }
 
-    FILE* db_fp = fopen("Students_Information.db", "wb");  // Clear all content
-    if (!db_fp) return F_FILE_OPEN_ERROR;
+    FILE* db_fp = fopen(DB_FILE_NAME, "wb");  // Clear all content
+    if (!db_fp)
+    {
+        System_Unlock();
+        return F_FILE_OPEN_ERROR;
+    }
 
     fclose(db_fp);
+    Indexes_Rebuild();
+    System_Unlock();
     printf("All students have been deleted successfully.\n");
     return F_OK;
 }
@@ -762,9 +870,17 @@ F_Return_t Restore_Student_DB(void)
         return F_FILE_OPEN_ERROR;
     }
 
-    FILE* dest = fopen("Students_Information.db", "wb");
+    if (System_Lock(true) != F_OK)
+    {
+        fclose(src);
+        return F_FILE_OPEN_ERROR;
+    }
+
+    Storage_Close();
+    FILE* dest = fopen(DB_FILE_NAME, "wb");
     if (!dest)
     {
+        System_Unlock();
         fclose(src);
         return F_FILE_OPEN_ERROR;
     }
@@ -779,6 +895,10 @@ F_Return_t Restore_Student_DB(void)
     fclose(src);
     fclose(dest);
 
+    /* The restored file has different slots, rebuild every index */
+    Indexes_Rebuild();
+    System_Unlock();
+
     printf("Database restored from backup successfully.\n");
     return F_OK;
 }
\ No newline at end of file
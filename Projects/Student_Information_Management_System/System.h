@@ -1,4 +1,4 @@
-#ifndef STUDENT_SYSTEM_H
+﻿#ifndef STUDENT_SYSTEM_H
 #define STUDENT_SYSTEM_H
 
 
@@ -20,6 +20,7 @@
 #define MAX_NAME_LENGTH    50
 #define MAX_COURSES        10
 #define MAX_COURSE_ID      10
+#define DB_FILE_NAME       "Students_Information.db"
 
   /* ============================================================
    *                    Courses Enumeration
@@ -41,6 +42,20 @@ typedef enum
     COURSE_AI
 } Course_t;
 
+#if MAX_COURSE_ID >= 16
+#error "Course_Mask_t holds one bit per course ID, widen it for more courses"
+#endif
+
+/* One bit per course ID, bit n set when the student takes course n */
+typedef uint16_t Course_Mask_t;
+
+/* How a name search text is compared with the stored names */
+typedef enum
+{
+    NAME_MATCH_PREFIX = 0,    /* Name starts with the text */
+    NAME_MATCH_SUBSTRING      /* Name contains the text anywhere */
+} Name_Match_t;
+
 /* ============================================================
  *                Function Return Status Codes
  *
@@ -59,6 +74,9 @@ typedef enum
     F_FNAME_NOT_FOUND,        /* First name not found */
     F_COURSE_NOT_FOUND,       /* Course not found */
     F_FILE_IS_EMPTY,          /* DataBase  Empty */  
+    F_GPA_NOT_FOUND,          /* No student in the GPA range */
+    F_INVALID_FIELD,          /* Update value out of range */
+    F_CONNECTION_ERROR,       /* Server unreachable or connection lost */
 } F_Return_t;
 
 /* ============================================================
@@ -78,6 +96,100 @@ typedef struct
     bool is_active;                             /* Logical delete flag */
 } Student_t;
 
+/* ============================================================
+ *                    Student Update Values
+ *
+ *  Description:
+ *  New field values for Update_Student. Only the fields whose
+ *  bit is set in the update mask are read.
+ * ============================================================ */
+typedef enum
+{
+    UPDATE_FIRST_NAME = 1 << 0,
+    UPDATE_LAST_NAME  = 1 << 1,
+    UPDATE_GPA        = 1 << 2,
+    UPDATE_COURSES    = 1 << 3
+} Update_Field_t;
+
+/* Combination of Update_Field_t bits */
+typedef uint8_t Update_Mask_t;
+
+typedef struct
+{
+    char first_name[MAX_NAME_LENGTH];           /* New first name */
+    char last_name[MAX_NAME_LENGTH];            /* New last name */
+    float GPA;                                  /* New GPA, 0.0 to 4.0 */
+    uint8_t courses[MAX_COURSES];               /* New course list */
+    uint8_t course_count;                       /* 1 to MAX_COURSES */
+} Student_Update_t;
+
+/* ============================================================
+ *                    Import Report
+ *
+ *  Description:
+ *  Outcome of Add_Student_From_File. Every rejected record is
+ *  a row of the reject file: its line, its ID and the
+ *  Import_Error_t bits of everything wrong with it.
+ * ============================================================ */
+typedef enum
+{
+    IMPORT_ERROR_FORMAT           = 1 << 0,     /* Fewer than 5 fields */
+    IMPORT_ERROR_ID               = 1 << 1,     /* ID is not a number */
+    IMPORT_ERROR_NAME             = 1 << 2,     /* First or last name is empty */
+    IMPORT_ERROR_GPA              = 1 << 3,     /* GPA is not a number from 0 to 4 */
+    IMPORT_ERROR_COURSE_COUNT     = 1 << 4,     /* Course count is not from 1 to MAX_COURSES */
+    IMPORT_ERROR_COURSE_ID        = 1 << 5,     /* A course is not from 1 to MAX_COURSE_ID */
+    IMPORT_ERROR_DUPLICATE_COURSE = 1 << 6,     /* A course is listed twice */
+    IMPORT_ERROR_TOO_MANY_COURSES = 1 << 7,     /* More than MAX_COURSES courses */
+    IMPORT_ERROR_COUNT_MISMATCH   = 1 << 8,     /* Course count differs from the courses listed */
+    IMPORT_ERROR_DUPLICATE_ID     = 1 << 9      /* ID is in the database or earlier in the file */
+} Import_Error_t;
+
+#define IMPORT_ERROR_KINDS  10                  /* Bits of Import_Error_t */
+
+/* A record left out of the import */
+typedef struct
+{
+    uint64_t line;                              /* Line the record starts on */
+    uint32_t id;                                /* Student ID, 0 with IMPORT_ERROR_FORMAT or IMPORT_ERROR_ID */
+    uint32_t errors;                            /* Import_Error_t bits */
+} Import_Reject_t;
+
+typedef struct
+{
+    uint32_t imported;                          /* Students added */
+    uint32_t rejected;                          /* Records left out */
+    uint32_t error_counts[IMPORT_ERROR_KINDS];  /* Rejected records with each bit, lowest bit first */
+} Import_Report_t;
+
+/* ============================================================
+ *                    Export Columns
+ *
+ *  Description:
+ *  Fields written by Export_Students, always in this order.
+ *  EXPORT_COLUMN_COURSES writes the course count, then the
+ *  courses.
+ * ============================================================ */
+typedef enum
+{
+    EXPORT_FORMAT_CSV = 0,                      /* The format Add_Student_From_File reads */
+    EXPORT_FORMAT_BINARY                        /* Packed records, see Export.h */
+} Export_Format_t;
+
+typedef enum
+{
+    EXPORT_COLUMN_ID         = 1 << 0,
+    EXPORT_COLUMN_FIRST_NAME = 1 << 1,
+    EXPORT_COLUMN_LAST_NAME  = 1 << 2,
+    EXPORT_COLUMN_GPA        = 1 << 3,
+    EXPORT_COLUMN_COURSES    = 1 << 4
+} Export_Column_t;
+
+/* Combination of Export_Column_t bits */
+typedef uint8_t Export_Columns_t;
+
+#define EXPORT_COLUMNS_ALL  0x1F                /* Every column: a CSV export can be imported again */
+
 /* ============================================================
  *                    System API Functions
  * ============================================================ */
@@ -93,35 +205,78 @@ typedef struct
   */
 F_Return_t System_Init(void);
 
+/**
+ * @brief  Shuts down the student management system.
+ *
+ * @details
+ * - Flushes and closes the index files kept open by the system.
+ */
+void System_Deinit(void);
+
+/**
+ * @brief  Locks the database against other processes.
+ *
+ * @details
+ * - Any number of processes may hold the shared lock to read;
+ *   the exclusive lock is held by one writer alone.
+ * - Reloads the records and indexes first if another process
+ *   changed the database since this one last held the lock.
+ * - Calls nest; every successful call needs a System_Unlock.
+ * - The APIs below lock for themselves: use it only to keep
+ *   several calls consistent with each other.
+ *
+ * @param  exclusive true to write, false to read.
+ * @return F_OK once locked, otherwise error code.
+ */
+F_Return_t System_Lock(bool exclusive);
+
+/**
+ * @brief  Releases the lock taken by the matching System_Lock.
+ */
+void System_Unlock(void);
+
 /**
  * @brief  Imports student records from an external file.
  *
  * @details
  * - Reads student data from an external file.
  * - Validates records before inserting them into the main database.
- * - Prevents duplicate student IDs.
+ * - Prevents duplicate student IDs, both against the database and
+ *   within the import file itself.
+ * - Writes accepted records in large batches.
+ * - Lists rejected records in a CSV reject file instead of on
+ *   the console: line,id,errors,reasons with a header row.
+ * - Holds the write lock for the whole import, so readers in
+ *   other processes wait for it to finish.
  *
  * @param  import_file Path to the external input file.
+ * @param  reject_file Path of the reject file to create, NULL for none.
+ * @param  report      Filled with the import counters, may be NULL.
  * @return F_OK if import succeeds, otherwise error code.
  */
-F_Return_t Add_Student_From_File(const char* import_file);
+F_Return_t Add_Student_From_File(const char* import_file, const char* reject_file, Import_Report_t* report);
 
 /**
  * @brief  Adds a single student to the database using a given Student_t structure.
  *
  * @details
- * - Checks if the student ID already exists in the database.
- * - Appends the student record to the binary database file if valid.
+ * - Validates the record with Validate_Student first.
+ * - Checks if the student ID already exists: the ID filter
+ *   clears most new IDs, the ID index confirms the others.
+ * - Stores the record in a free slot, or appends it if none is free.
+ * - Commits it through the write-ahead log before indexing it.
+ * - Records the new slot in the ID index.
  *
  * @param  student Pointer to the student structure to add.
- * @return F_OK if student is added successfully, or error code.
+ * @return F_OK if student is added successfully, F_INVALID_FIELD
+ *         for an invalid record, or error code.
  */
 F_Return_t Add_Student_Manually(const Student_t* student);
 /**
  * @brief  Searches for a student using their unique ID.
  *
  * @details
- * - Scans the database file record by record.
+ * - Looks up the record slot through the ID index.
  * - Returns the student data if found.
  *
  * @param  id      Student unique ID.
@@ -130,23 +285,58 @@ F_Return_t Add_Student_Manually(const Student_t* student);
  */
 F_Return_t Find_Student_By_ID(uint32_t id, Student_t* student);
 
+/**
+ * @brief  Looks up many students by ID under one shared lock.
+ *
+ * @details
+ * - Finds every slot with one ordered pass over the ID index,
+ *   then reads and verifies each record.
+ *
+ * @param  ids      IDs to look up.
+ * @param  count    Number of IDs.
+ * @param  students Array of count students, filled where found.
+ * @param  results  Array of count statuses, F_OK or F_ID_NOT_FOUND.
+ * @return F_OK if the lookups ran, otherwise error code.
+ */
+F_Return_t Find_Students_By_IDs(const uint32_t* ids, uint32_t count, Student_t* students, F_Return_t* results);
+
 /**
  * @brief  Searches for students using their first name.
  *
  * @details
- * - Compares the given name with database records.
- * - Displays all matching students.
+ * - Matches names case-insensitively, ignoring surrounding spaces.
+ * - Looks the name up in the first name hash index, falling back
+ *   to the name column or the records if it is unavailable.
+ * - Displays all matching students, read through a query cursor.
  *
  * @param  fname First name to search for.
  * @return F_OK if at least one student is found.
  */
 F_Return_t Find_Student_By_First_Name(const char* fname);
 
+/**
+ * @brief  Type-ahead search over first and last names.
+ *
+ * @details
+ * - Matches case-insensitively, ignoring surrounding spaces.
+ * - Intersects the trigram lists of the text, falling back to a
+ *   record scan when the index is unavailable.
+ * - Stops once max_ids IDs are collected, in database order.
+ *
+ * @param  text    Text to search for.
+ * @param  match   NAME_MATCH_PREFIX or NAME_MATCH_SUBSTRING.
+ * @param  ids     Array to store the IDs of matching students.
+ * @param  max_ids Capacity of ids.
+ * @param  found   Pointer to store the number of IDs stored.
+ * @return F_OK if at least one student is found, otherwise F_FNAME_NOT_FOUND.
+ */
+F_Return_t Search_Students_By_Name(const char* text, Name_Match_t match, uint32_t* ids, uint32_t max_ids, uint32_t* found);
+
 /**
  * @brief  Retrieves all students registered in a specific course.
  *
  * @details
- * - Iterates through database records.
+ * - Walks the course bitmap through Get_Students_By_Courses.
  * - Displays students enrolled in the given course.
  *
  * @param  course Course identifier.
@@ -155,42 +345,162 @@ F_Return_t Find_Student_By_First_Name(const char* fname);
 F_Return_t Get_Students_By_Course(Course_t course);
 
 /**
- * @brief  Updates an existing student record.
+ * @brief  Retrieves students by a combination of courses.
  *
  * @details
- * - Searches for the student by ID.
- * - Updates the student information in the database.
- * - Rewrites the database file to preserve consistency.
+ * - Intersects the course bitmaps of all_of and subtracts those
+ *   of none_of, one 64-bit word at a time.
+ * - Falls back to testing the course column, or the records,
+ *   when the course index is unavailable.
+ * - Displays every matching student.
  *
- * @param  id Student unique ID.
- * @return F_OK if update succeeds, otherwise error code.
+ * @param  all_of  Courses the student must take (bit n = course n).
+ * @param  none_of Courses the student must not take.
+ * @return F_OK if students are found, otherwise F_COURSE_NOT_FOUND.
+ */
+F_Return_t Get_Students_By_Courses(Course_Mask_t all_of, Course_Mask_t none_of);
+
+/**
+ * @brief  Retrieves the students whose GPA lies in a range.
+ *
+ * @details
+ * - Walks the GPA skip list from min_gpa, no scan or sort.
+ * - Displays students by increasing GPA, then ID.
+ *
+ * @param  min_gpa Lowest GPA in range.
+ * @param  max_gpa Highest GPA in range.
+ * @return F_OK if students are found, otherwise F_GPA_NOT_FOUND.
  */
-F_Return_t Update_Student(uint32_t id);
+F_Return_t Get_Students_By_GPA_Range(float min_gpa, float max_gpa);
+
+/**
+ * @brief  Retrieves the students with the highest GPA.
+ *
+ * @details
+ * - Walks the GPA skip list backward from its tail.
+ * - Displays students by decreasing GPA.
+ *
+ * @param  count Number of students to display.
+ * @return F_OK if students are found, otherwise F_GPA_NOT_FOUND.
+ */
+F_Return_t Get_Top_Students_By_GPA(uint32_t count);
+
+/**
+ * @brief  Updates selected fields of an existing student record.
+ *
+ * @details
+ * - Locates the student's record slot through the ID index.
+ * - Validates the updated record with Validate_Student before
+ *   changing anything.
+ * - Overwrites only that record's slot, committed through the
+ *   write-ahead log, then re-indexes it.
+ * - Never prompts, so batch jobs can drive it.
+ *
+ * @param  id     Student unique ID.
+ * @param  fields Update_Field_t bits of the fields to change.
+ * @param  values New values of the selected fields.
+ * @return F_OK if update succeeds, F_ID_NOT_FOUND, F_INVALID_FIELD,
+ *         otherwise error code.
+ */
+F_Return_t Update_Student(uint32_t id, Update_Mask_t fields, const Student_Update_t* values);
+
+
+/**
+ * @brief  Checks that a record holds only values the database accepts.
+ *
+ * @details
+ * - Both names set, GPA from 0.0 to 4.0, 1 to MAX_COURSES
+ *   courses, each from 1 to MAX_COURSE_ID and listed once.
+ * - The rules of the file import, applied to every other way in.
+ *
+ * @param  student Record to check; the ID is not checked.
+ * @return F_OK if valid, otherwise F_INVALID_FIELD.
+ */
+F_Return_t Validate_Student(const Student_t* student);
+
+
+/**
+ * @brief  Applies the selected update values to a record and checks it.
+ *
+ * @details
+ * - The updated record must pass Validate_Student.
+ *
+ * @param  student Record to change.
+ * @param  fields  Update_Field_t bits of the fields to change.
+ * @param  values  New values of the selected fields.
+ * @return F_OK if the updated record is valid, otherwise F_INVALID_FIELD;
+ *         the record may be partly changed then.
+ */
+F_Return_t Merge_Student_Update(Student_t* student, Update_Mask_t fields, const Student_Update_t* values);
 
 /**
  * @brief  Deletes a student record from the database.
  *
  * @details
- * - Performs a logical delete by setting is_active flag.
- * - Preserves database integrity.
+ * - Performs a logical delete by clearing is_active in place,
+ *   committed through the write-ahead log.
+ * - Removes the ID from the ID index.
  *
  * @param  id Student unique ID.
  * @return F_OK if deletion succeeds.
  */
 F_Return_t Delete_Student(uint32_t id);
 
+/**
+ * @brief  Prints a single student record to the console.
+ *
+ * @details
+ * - The console consumer of the query cursors of Query.h.
+ *
+ * @param  student Pointer to the student struct to print.
+ */
+void Print_Student(const Student_t* student);
+
 /**
  * @brief  Displays all active students in the database.
  *
  * @details
- * - Iterates through the database file.
- * - Prints all valid student records.
+ * - Streams the active records through a Query_All cursor.
+ * - Prints each one as it is yielded.
  *
  * @return F_OK if records are displayed successfully.
  */
 F_Return_t Show_All_Students(void);
 
 
+/**
+ * @brief  Writes every active student to a file.
+ *
+ * @details
+ * - Streams the records in slot order through one large buffer.
+ * - A CSV export of all columns is in the format
+ *   Add_Student_From_File reads.
+ * - Holds the read lock, so the export is a consistent snapshot.
+ *
+ * @param  export_file Path of the file to create.
+ * @param  format      EXPORT_FORMAT_CSV or EXPORT_FORMAT_BINARY.
+ * @param  columns     Export_Column_t bits of the fields to write.
+ * @param  exported    Set to the number of students written, may be NULL.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Export_Students(const char* export_file, Export_Format_t format, Export_Columns_t columns, uint32_t* exported);
+
+
+/**
+ * @brief  Reclaims space held by logically deleted records.
+ *
+ * @details
+ * - Does nothing unless more than COMPACTION_THRESHOLD_PERCENT of
+ *   the record slots are dead.
+ * - Moves at most max_moves records per call so the work can be
+ *   spread over several calls.
+ *
+ * @param  max_moves Maximum number of records to move in this call.
+ * @return F_OK if compaction ran or was not needed, otherwise error code.
+ */
+F_Return_t Compact_Database(uint32_t max_moves);
+
+
 /**
  * @brief  Deletes all student records from the database safely.
  *
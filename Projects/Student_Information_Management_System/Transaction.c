@@ -0,0 +1,354 @@
+#include "Transaction.h"
+#include "Indexes.h"
+#include "ID_Index.h"
+#include "Storage.h"
+
+typedef enum
+{
+    OPERATION_ADD = 0,
+    OPERATION_UPDATE,
+    OPERATION_DELETE
+} Operation_Type_t;
+
+typedef struct
+{
+    Operation_Type_t type;
+    uint32_t slot;          /* Slot written at commit */
+    Student_t student;      /* Staged record, then the record written */
+    Student_t previous;     /* Record the change replaced */
+    Update_Mask_t fields;   /* Fields an update changes */
+    Student_Update_t values;
+} Operation_t;
+
+static Operation_t* operations = NULL;
+static uint32_t operation_count = 0;
+static uint32_t operation_capacity = 0;
+static bool transaction_open = false;
+
+/* ============================================================
+ *                    Latest Operation Table
+ *
+ *  Maps every ID touched by the commit so far to its last
+ *  operation, stored as index + 1 so that 0 marks an empty
+ *  bucket. Open addressing with linear probing.
+ * ============================================================ */
+typedef struct
+{
+    uint32_t id;
+    uint32_t operation;
+} Latest_Entry_t;
+
+static Latest_Entry_t* latest = NULL;
+static uint32_t latest_capacity = 0;    /* Always a power of two */
+
+static uint32_t Latest_Hash(uint32_t id)
+{
+    return (uint32_t)((id * 2654435761UL) & (latest_capacity - 1));
+}
+
+static F_Return_t Latest_Init(uint32_t expected)
+{
+    latest_capacity = 64;
+    while (latest_capacity < 2 * expected)
+        latest_capacity *= 2;
+
+    latest = calloc(latest_capacity, sizeof(Latest_Entry_t));
+    return (latest) ? F_OK : F_NOT_OK;
+}
+
+static void Latest_Free(void)
+{
+    free(latest);
+    latest = NULL;
+    latest_capacity = 0;
+}
+
+/* Returns the bucket of an ID, the empty one where it belongs if absent */
+static Latest_Entry_t* Latest_Find(uint32_t id)
+{
+    uint32_t i = Latest_Hash(id);
+    while (latest[i].operation != 0 && latest[i].id != id)
+        i = (i + 1) & (latest_capacity - 1);
+    return &latest[i];
+}
+
+/* ============================================================
+ *                    Staging
+ * ============================================================ */
+static F_Return_t Stage(Operation_Type_t type, const Student_t* student, Update_Mask_t fields, const Student_Update_t* values)
+{
+    Student_t updated;
+
+    if (!transaction_open)
+        return F_NOT_OK;
+
+    /* Staged records follow the same rules as every other write */
+    if (type == OPERATION_ADD && Validate_Student(student) != F_OK)
+        return F_INVALID_FIELD;
+
+    /* Early check on the record as it is now; the commit checks it again under the write lock */
+    if (type == OPERATION_UPDATE && Find_Student_By_ID(student->id, &updated) == F_OK &&
+        Merge_Student_Update(&updated, fields, values) != F_OK)
+        return F_INVALID_FIELD;
+
+    if (operation_count == operation_capacity)
+    {
+        uint32_t capacity = (operation_capacity) ? 2 * operation_capacity : TRANSACTION_MIN_CAPACITY;
+        Operation_t* grown = realloc(operations, capacity * sizeof(Operation_t));
+        if (!grown)
+            return F_NOT_OK;
+        operations = grown;
+        operation_capacity = capacity;
+    }
+
+    Operation_t* operation = &operations[operation_count++];
+    operation->type = type;
+    operation->student = *student;
+    operation->fields = fields;
+    if (values)
+        operation->values = *values;
+    return F_OK;
+}
+
+/* Current record of an ID, as left by the operations applied so far */
+static F_Return_t Current_Record(uint32_t id, uint32_t* slot, Student_t* student)
+{
+    const Latest_Entry_t* entry = Latest_Find(id);
+
+    if (entry->operation != 0)
+    {
+        const Operation_t* last = &operations[entry->operation - 1];
+        if (last->type == OPERATION_DELETE)
+            return F_ID_NOT_FOUND;
+        *slot = last->slot;
+        *student = last->student;
+        return F_OK;
+    }
+
+    if (ID_Index_Find(id, slot) != F_OK)
+        return F_ID_NOT_FOUND;
+
+    /* Storage_Read sees the slots written earlier in the transaction */
+    if (Storage_Read(*slot, student) != F_OK || student->id != id || !student->is_active)
+        return F_ID_NOT_FOUND;
+    return F_OK;
+}
+
+/* Writes one operation into the storage transaction */
+static F_Return_t Apply(uint32_t index)
+{
+    Operation_t* operation = &operations[index];
+    Student_t current;
+    uint32_t slot;
+    F_Return_t status;
+
+    F_Return_t found = Current_Record(operation->student.id, &slot, &current);
+
+    switch (operation->type)
+    {
+    case OPERATION_ADD:
+        if (found == F_OK)
+            return F_ID_ALREADY_EXISTS;
+        status = Storage_Insert(&operation->student, &operation->slot);
+        break;
+
+    case OPERATION_UPDATE:
+        if (found != F_OK)
+            return found;
+        operation->slot = slot;
+        operation->previous = current;
+
+        /* Only the staged fields change: the others keep what other processes committed */
+        operation->student = current;
+        status = Merge_Student_Update(&operation->student, operation->fields, &operation->values);
+        if (status == F_OK)
+            status = Storage_Write(slot, &operation->student);
+        break;
+
+    default:
+        if (found != F_OK)
+            return found;
+        operation->slot = slot;
+        operation->previous = current;
+        operation->student = current;
+        operation->student.is_active = 0;
+        status = Storage_Delete(slot, &operation->student);
+        break;
+    }
+
+    if (status == F_OK)
+    {
+        Latest_Entry_t* entry = Latest_Find(operation->student.id);
+        entry->id = operation->student.id;
+        entry->operation = index + 1;
+    }
+    return status;
+}
+
+/* Forwards a committed operation to the indexes */
+static F_Return_t Index(const Operation_t* operation)
+{
+    switch (operation->type)
+    {
+    case OPERATION_ADD:
+        return Indexes_On_Insert(operation->slot, &operation->student);
+    case OPERATION_UPDATE:
+        return Indexes_On_Update(operation->slot, &operation->previous, &operation->student);
+    default:
+        return Indexes_On_Delete(operation->slot, &operation->student);
+    }
+}
+
+/**
+ * @brief  Starts staging a transaction.
+ *
+ * @return F_OK if started, F_NOT_OK if a transaction is already open.
+ */
+F_Return_t Transaction_Begin(void)
+{
+    if (transaction_open)
+        return F_NOT_OK;
+
+    operation_count = 0;
+    transaction_open = true;
+    return F_OK;
+}
+
+/**
+ * @brief  Stages the addition of a new student.
+ *
+ * @details
+ * - The fields are checked by Validate_Student when staged.
+ * - The ID is checked at commit, against the database and the
+ *   operations staged before this one.
+ *
+ * @param  student Record to add.
+ * @return F_OK if staged, F_INVALID_FIELD, otherwise error code.
+ */
+F_Return_t Transaction_Add(const Student_t* student)
+{
+    if (!student)
+        return F_NOT_OK;
+    return Stage(OPERATION_ADD, student, 0, NULL);
+}
+
+/**
+ * @brief  Stages an update of selected fields of a student.
+ *
+ * @details
+ * - At commit the values are merged into the record as it is
+ *   then, under the write lock, so fields changed meanwhile by
+ *   other processes are kept.
+ * - The updated record must pass Validate_Student, checked when
+ *   staged and again at commit.
+ *
+ * @param  id     Student unique ID.
+ * @param  fields Update_Field_t bits of the fields to change.
+ * @param  values New values of the selected fields.
+ * @return F_OK if staged, F_INVALID_FIELD, otherwise error code.
+ */
+F_Return_t Transaction_Update(uint32_t id, Update_Mask_t fields, const Student_Update_t* values)
+{
+    Student_t student;
+
+    if (!values && fields)
+        return F_NOT_OK;
+
+    my_memset(&student, 0, sizeof(Student_t));
+    student.id = id;
+    return Stage(OPERATION_UPDATE, &student, fields, values);
+}
+
+/**
+ * @brief  Stages the logical delete of a student.
+ *
+ * @param  id Student unique ID.
+ * @return F_OK if staged, otherwise error code.
+ */
+F_Return_t Transaction_Delete(uint32_t id)
+{
+    Student_t student;
+
+    my_memset(&student, 0, sizeof(Student_t));
+    student.id = id;
+    return Stage(OPERATION_DELETE, &student, 0, NULL);
+}
+
+/**
+ * @brief  Applies every staged operation atomically.
+ *
+ * @details
+ * - Operations run in the order they were staged, each one
+ *   seeing the effect of the previous ones.
+ * - If any operation fails, nothing is written.
+ * - All records are logged as one group with one sync, then the
+ *   indexes are updated.
+ * - Holds the write lock throughout, so other processes see the
+ *   whole batch or none of it.
+ * - Ends the transaction whatever the outcome.
+ *
+ * @return F_OK if committed, F_ID_ALREADY_EXISTS, F_ID_NOT_FOUND or
+ *         F_INVALID_FIELD for a rejected operation, otherwise error code.
+ */
+F_Return_t Transaction_Commit(void)
+{
+    F_Return_t status;
+    bool committed = false;
+
+    if (!transaction_open)
+        return F_NOT_OK;
+    transaction_open = false;
+    if (operation_count == 0)
+        return F_OK;
+
+    /* Other processes see the whole batch or none of it */
+    status = System_Lock(true);
+    if (status != F_OK)
+    {
+        operation_count = 0;
+        return status;
+    }
+
+    status = Latest_Init(operation_count);
+    if (status == F_OK)
+        status = Storage_Begin();
+
+    /* ---------- Write every operation into one log group ---------- */
+    for (uint32_t i = 0; i < operation_count && status == F_OK; i++)
+        status = Apply(i);
+    if (status == F_OK)
+    {
+        status = Storage_Commit();
+        committed = !Storage_In_Transaction();
+    }
+
+    Latest_Free();
+    if (status != F_OK && !committed)
+    {
+        /* Nothing reached the log, the indexes were never touched */
+        Storage_Rollback();
+        System_Unlock();
+        operation_count = 0;
+        return status;
+    }
+
+    /* ---------- Committed, even if the file write failed: the log replays it ---------- */
+    for (uint32_t i = 0; i < operation_count; i++)
+    {
+        F_Return_t indexed = Index(&operations[i]);
+        if (indexed != F_OK && status == F_OK)
+            status = indexed;
+    }
+    System_Unlock();
+    operation_count = 0;
+    return status;
+}
+
+/**
+ * @brief  Discards the staged operations and ends the transaction.
+ */
+void Transaction_Rollback(void)
+{
+    transaction_open = false;
+    operation_count = 0;
+}
@@ -0,0 +1,91 @@
+#ifndef _Transaction_H_
+#define _Transaction_H_
+
+/* ============================================================
+ *  Batched Transactions
+ *
+ *  Description:
+ *  Stages several add, update and delete operations and applies
+ *  them together. Staging touches neither the database nor the
+ *  indexes; the commit checks every operation, writes them all
+ *  as one group of the write-ahead log with a single sync, and
+ *  only then updates the indexes. Either every staged change
+ *  reaches the database or none does.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define TRANSACTION_MIN_CAPACITY    64      /* Staged operations allocated up front */
+
+/**
+ * @brief  Starts staging a transaction.
+ *
+ * @return F_OK if started, F_NOT_OK if a transaction is already open.
+ */
+F_Return_t Transaction_Begin(void);
+
+/**
+ * @brief  Stages the addition of a new student.
+ *
+ * @details
+ * - The fields are checked by Validate_Student when staged.
+ * - The ID is checked at commit, against the database and the
+ *   operations staged before this one.
+ *
+ * @param  student Record to add.
+ * @return F_OK if staged, F_INVALID_FIELD, otherwise error code.
+ */
+F_Return_t Transaction_Add(const Student_t* student);
+
+/**
+ * @brief  Stages an update of selected fields of a student.
+ *
+ * @details
+ * - At commit the values are merged into the record as it is
+ *   then, under the write lock, so fields changed meanwhile by
+ *   other processes are kept.
+ * - The updated record must pass Validate_Student, checked when
+ *   staged and again at commit.
+ *
+ * @param  id     Student unique ID.
+ * @param  fields Update_Field_t bits of the fields to change.
+ * @param  values New values of the selected fields.
+ * @return F_OK if staged, F_INVALID_FIELD, otherwise error code.
+ */
+F_Return_t Transaction_Update(uint32_t id, Update_Mask_t fields, const Student_Update_t* values);
+
+/**
+ * @brief  Stages the logical delete of a student.
+ *
+ * @param  id Student unique ID.
+ * @return F_OK if staged, otherwise error code.
+ */
+F_Return_t Transaction_Delete(uint32_t id);
+
+/**
+ * @brief  Applies every staged operation atomically.
+ *
+ * @details
+ * - Operations run in the order they were staged, each one
+ *   seeing the effect of the previous ones.
+ * - If any operation fails, nothing is written.
+ * - All records are logged as one group with one sync, then the
+ *   indexes are updated.
+ * - Holds the write lock throughout, so other processes see the
+ *   whole batch or none of it.
+ * - Ends the transaction whatever the outcome.
+ *
+ * @return F_OK if committed, F_ID_ALREADY_EXISTS, F_ID_NOT_FOUND or
+ *         F_INVALID_FIELD for a rejected operation, otherwise error code.
+ */
+F_Return_t Transaction_Commit(void);
+
+/**
+ * @brief  Discards the staged operations and ends the transaction.
+ */
+void Transaction_Rollback(void);
+
+#endif // !_Transaction_H_
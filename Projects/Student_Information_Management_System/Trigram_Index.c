@@ -0,0 +1,599 @@
+#include "Trigram_Index.h"
+#include "Indexes.h"
+#include "Name_Index.h"
+#include "Storage.h"
+#include <string.h>
+
+/* ============================================================
+ *                    In-Memory Layout
+ *
+ *  Open-addressing table of posting lists keyed by the three
+ *  bytes of a trigram; key 0 marks a free bucket since names
+ *  never contain NUL. Every list holds record slots in
+ *  increasing order without duplicates.
+ *
+ *  On disk the header is followed, for every list, by its key,
+ *  its slot count and the slots.
+ * ============================================================ */
+#define TRIGRAM_PAD    0x01        /* Marks the start of a name */
+
+typedef struct
+{
+    uint32_t magic;                 /* TRIGRAM_INDEX_MAGIC */
+    uint32_t generation;            /* Database generation covered by the index */
+    uint32_t is_clean;              /* 1 when saved after the last change */
+    uint32_t list_count;            /* Lists stored in the file */
+    uint32_t stale;                 /* Removed records still present in lists */
+} Trigram_Index_Header_t;
+
+typedef struct
+{
+    uint32_t key;                   /* Trigram bytes, 0 if the bucket is free */
+    uint32_t count;                 /* Slots in the list */
+    uint32_t capacity;              /* Slots allocated */
+    uint32_t* slots;                /* Sorted record slots */
+} Trigram_List_t;
+
+static Trigram_List_t* table = NULL;
+static uint32_t table_capacity = 0;
+static Trigram_Index_Header_t index_header;
+static bool index_loaded = false;
+
+static uint32_t Trigram_Key(const uint8_t* text)
+{
+    return ((uint32_t)text[0] << 16) | ((uint32_t)text[1] << 8) | text[2];
+}
+
+static uint32_t Trigram_Hash(uint32_t key)
+{
+    uint32_t hash = (uint32_t)((key * 2654435761UL) & 0xFFFFFFFFUL);
+    return hash ^ (hash >> 16);
+}
+
+static void Free_Table(void)
+{
+    for (uint32_t i = 0; i < table_capacity; i++)
+        free(table[i].slots);
+    free(table);
+    table = NULL;
+    table_capacity = 0;
+    index_header.list_count = 0;
+}
+
+static F_Return_t Allocate_Table(uint32_t capacity)
+{
+    Trigram_List_t* fresh = calloc(capacity, sizeof(Trigram_List_t));
+    if (!fresh)
+        return F_NOT_OK;
+
+    Free_Table();
+    table = fresh;
+    table_capacity = capacity;
+    return F_OK;
+}
+
+/* Returns the bucket holding key, or the free bucket where it belongs */
+static Trigram_List_t* Find_Bucket(Trigram_List_t* buckets, uint32_t capacity, uint32_t key)
+{
+    uint32_t mask = capacity - 1;
+    uint32_t i = Trigram_Hash(key) & mask;
+
+    while (buckets[i].key != 0 && buckets[i].key != key)
+        i = (i + 1) & mask;
+    return &buckets[i];
+}
+
+/* Doubles the table, keeping the load factor at or below one half */
+static F_Return_t Grow_Table(void)
+{
+    uint32_t capacity = 2 * table_capacity;
+    Trigram_List_t* fresh = calloc(capacity, sizeof(Trigram_List_t));
+    if (!fresh)
+        return F_NOT_OK;
+
+    for (uint32_t i = 0; i < table_capacity; i++)
+    {
+        if (table[i].key != 0)
+            *Find_Bucket(fresh, capacity, table[i].key) = table[i];
+    }
+    free(table);
+    table = fresh;
+    table_capacity = capacity;
+    return F_OK;
+}
+
+/* Returns the list of a trigram, creating an empty one if needed */
+static Trigram_List_t* Get_List(uint32_t key)
+{
+    Trigram_List_t* list = Find_Bucket(table, table_capacity, key);
+    if (list->key != 0)
+        return list;
+
+    if (2 * (index_header.list_count + 1) > table_capacity)
+    {
+        if (Grow_Table() != F_OK)
+            return NULL;
+        list = Find_Bucket(table, table_capacity, key);
+    }
+    list->key = key;
+    index_header.list_count++;
+    return list;
+}
+
+/* First position at or after from whose slot is not below slot */
+static uint32_t Seek(const Trigram_List_t* list, uint32_t from, uint32_t slot)
+{
+    uint32_t low = from, high = from, step = 1;
+
+    /* Gallop ahead, then binary search the last step */
+    while (high < list->count && list->slots[high] < slot)
+    {
+        low = high + 1;
+        high += step;
+        step *= 2;
+    }
+    if (high > list->count)
+        high = list->count;
+
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if (list->slots[mid] < slot)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+static F_Return_t List_Add(Trigram_List_t* list, uint32_t slot)
+{
+    uint32_t pos = list->count;
+
+    /* Slots mostly arrive in increasing order, only search otherwise */
+    if (pos > 0 && list->slots[pos - 1] >= slot)
+    {
+        pos = Seek(list, 0, slot);
+        if (list->slots[pos] == slot)
+            return F_OK;
+    }
+
+    if (list->count == list->capacity)
+    {
+        uint32_t capacity = (list->capacity) ? 2 * list->capacity : 4;
+        uint32_t* grown = realloc(list->slots, capacity * sizeof(uint32_t));
+        if (!grown)
+            return F_NOT_OK;
+        list->slots = grown;
+        list->capacity = capacity;
+    }
+
+    memmove(&list->slots[pos + 1], &list->slots[pos], (list->count - pos) * sizeof(uint32_t));
+    list->slots[pos] = slot;
+    list->count++;
+    return F_OK;
+}
+
+/* Adds a slot under every trigram of a padded, normalized name */
+static F_Return_t Add_Name(uint32_t slot, const char* name)
+{
+    uint8_t padded[MAX_NAME_LENGTH + 2];
+
+    padded[0] = TRIGRAM_PAD;
+    padded[1] = TRIGRAM_PAD;
+    Name_Normalize(name, (char*)&padded[2]);
+
+    for (uint32_t i = 0; padded[i + 2] != '\0'; i++)
+    {
+        Trigram_List_t* list = Get_List(Trigram_Key(&padded[i]));
+        if (!list || List_Add(list, slot) != F_OK)
+            return F_NOT_OK;
+    }
+    return F_OK;
+}
+
+static F_Return_t Add_Record(uint32_t slot, const Student_t* student)
+{
+    F_Return_t status = Add_Name(slot, student->first_name);
+    if (status == F_OK)
+        status = Add_Name(slot, student->last_name);
+    return status;
+}
+
+static F_Return_t Write_Header(FILE* fp)
+{
+    if (fseek(fp, 0, SEEK_SET) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (fwrite(&index_header, sizeof(Trigram_Index_Header_t), 1, fp) != 1)
+        return F_FILE_WRITE_ERROR;
+    return F_OK;
+}
+
+/* Writes every list and stamps the file clean for the current generation */
+static F_Return_t Save_Index(void)
+{
+    FILE* fp = fopen(TRIGRAM_INDEX_FILE_NAME, "wb");
+    if (!fp)
+        return F_FILE_OPEN_ERROR;
+
+    index_header.magic = TRIGRAM_INDEX_MAGIC;
+    index_header.is_clean = 0;
+    Storage_Get_Generation(&index_header.generation);
+
+    F_Return_t status = Write_Header(fp);
+    for (uint32_t i = 0; i < table_capacity && status == F_OK; i++)
+    {
+        const Trigram_List_t* list = &table[i];
+        if (list->key == 0)
+            continue;
+
+        if (fwrite(&list->key, sizeof(uint32_t), 1, fp) != 1 ||
+            fwrite(&list->count, sizeof(uint32_t), 1, fp) != 1 ||
+            fwrite(list->slots, sizeof(uint32_t), list->count, fp) != list->count)
+            status = F_FILE_WRITE_ERROR;
+    }
+    if (status == F_OK)
+    {
+        index_header.is_clean = 1;
+        status = Write_Header(fp);
+    }
+    fclose(fp);
+    return status;
+}
+
+/* Reads clean lists written for the current generation */
+static F_Return_t Load_Index(void)
+{
+    Trigram_Index_Header_t stored;
+    uint32_t generation = 0;
+    uint32_t capacity = TRIGRAM_TABLE_MIN_CAPACITY;
+    F_Return_t status = F_OK;
+
+    if (Storage_Get_Generation(&generation) != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    FILE* fp = fopen(TRIGRAM_INDEX_FILE_NAME, "rb");
+    if (!fp)
+        return F_FILE_OPEN_ERROR;
+
+    if (fread(&stored, sizeof(stored), 1, fp) != 1 || stored.magic != TRIGRAM_INDEX_MAGIC ||
+        !stored.is_clean || stored.generation != generation)
+    {
+        fclose(fp);
+        return F_FILE_READ_ERROR;
+    }
+
+    while (capacity < 2 * stored.list_count)
+        capacity *= 2;
+    if (Allocate_Table(capacity) != F_OK)
+    {
+        fclose(fp);
+        return F_NOT_OK;
+    }
+
+    for (uint32_t i = 0; i < stored.list_count && status == F_OK; i++)
+    {
+        uint32_t key = 0, count = 0;
+        Trigram_List_t* list = NULL;
+
+        if (fread(&key, sizeof(uint32_t), 1, fp) != 1 || fread(&count, sizeof(uint32_t), 1, fp) != 1 ||
+            key == 0 || count == 0)
+            status = F_FILE_READ_ERROR;
+        if (status == F_OK)
+        {
+            list = Get_List(key);
+            if (!list || list->count != 0 || !(list->slots = malloc(count * sizeof(uint32_t))))
+                status = F_NOT_OK;
+        }
+        if (status == F_OK)
+        {
+            list->capacity = count;
+            list->count = count;
+            if (fread(list->slots, sizeof(uint32_t), count, fp) != count)
+                status = F_FILE_READ_ERROR;
+        }
+    }
+    fclose(fp);
+
+    if (status != F_OK)
+    {
+        Free_Table();
+        return status;
+    }
+    index_header = stored;
+    return F_OK;
+}
+
+/**
+ * @brief  Checks a record against a normalized search text.
+ *
+ * @param  student    Record to check.
+ * @param  normalized Search text passed through Name_Normalize.
+ * @param  match      Prefix or substring matching.
+ * @return true if the first or last name matches.
+ */
+bool Trigram_Index_Matches(const Student_t* student, const char* normalized, Name_Match_t match)
+{
+    char name[MAX_NAME_LENGTH];
+    int length = my_strlen(normalized);
+
+    for (int field = 0; field < 2; field++)
+    {
+        Name_Normalize((field == 0) ? student->first_name : student->last_name, name);
+
+        if (match == NAME_MATCH_PREFIX)
+        {
+            if (my_strlen(name) >= length && my_memcmp(name, normalized, length) == 0)
+                return true;
+        }
+        else if (my_strstr(name, normalized) != NULL)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief  Rebuilds the lists from the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t Trigram_Index_Rebuild(void)
+{
+    Student_t buffer[256];
+    uint32_t record_count = 0, got = 0;
+    F_Return_t status;
+
+    status = Storage_Record_Count(&record_count);
+    if (status == F_OK)
+        status = Allocate_Table(TRIGRAM_TABLE_MIN_CAPACITY);
+    if (status != F_OK)
+        return status;
+    index_header.stale = 0;
+    index_loaded = true;
+
+    for (uint32_t slot = 0; slot < record_count; slot += got)
+    {
+        status = Storage_Read_Batch(slot, 256, buffer, &got);
+        if (status != F_OK || got == 0)
+            break;
+
+        for (uint32_t i = 0; i < got && status == F_OK; i++)
+        {
+            if (buffer[i].is_active)
+                status = Add_Record(slot + i, &buffer[i]);
+        }
+    }
+
+    if (status != F_OK)
+        return status;
+    return Save_Index();
+}
+
+/**
+ * @brief  Loads the trigram index, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the lists from the database file when the index
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the index is ready, otherwise error code.
+ */
+F_Return_t Trigram_Index_Open(void)
+{
+    if (index_loaded)
+        return F_OK;
+
+    if (Load_Index() == F_OK)
+    {
+        index_loaded = true;
+        return F_OK;
+    }
+
+    FILE* fp = fopen(TRIGRAM_INDEX_FILE_NAME, "rb");
+    if (fp)
+    {
+        fclose(fp);
+        printf("Name search index is stale, rebuilding...\n");
+    }
+    return Trigram_Index_Rebuild();
+}
+
+/**
+ * @brief  Saves the lists, stamps the index clean and frees them.
+ */
+void Trigram_Index_Close(void)
+{
+    if (!index_loaded)
+        return;
+
+    /* A clean index on disk already matches memory, it only needs the current generation */
+    if (index_header.is_clean)
+        Trigram_Index_Flush();
+    else
+        Save_Index();
+
+    Free_Table();
+    index_loaded = false;
+}
+
+/**
+ * @brief  Stamps an unchanged search index file with the current generation.
+ *
+ * @details
+ * - Lets other processes load the lists after a change that
+ *   left the names alone, instead of rebuilding them.
+ * - Does nothing if the lists are not loaded or changed since
+ *   they were saved; Trigram_Index_Close saves them then.
+ */
+void Trigram_Index_Flush(void)
+{
+    if (index_loaded && index_header.is_clean)
+        Indexes_Stamp_Generation(TRIGRAM_INDEX_FILE_NAME, &index_header, sizeof(Trigram_Index_Header_t), &index_header.generation);
+}
+
+/**
+ * @brief  Frees the lists without saving them.
+ */
+void Trigram_Index_Discard(void)
+{
+    if (!index_loaded)
+        return;
+
+    Free_Table();
+    index_loaded = false;
+}
+
+/**
+ * @brief  Adds the slot of an active record under its name trigrams.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Trigram_Index_Insert(uint32_t slot, const Student_t* student)
+{
+    if (!student)
+        return F_NOT_OK;
+
+    F_Return_t status = Trigram_Index_Open();
+    if (status == F_OK)
+        status = Indexes_Mark_Dirty(NULL, TRIGRAM_INDEX_FILE_NAME, &index_header, sizeof(Trigram_Index_Header_t), &index_header.is_clean);
+    if (status == F_OK)
+        status = Add_Record(slot, student);
+    return status;
+}
+
+/**
+ * @brief  Records that a slot no longer holds its indexed names.
+ *
+ * @details
+ * - Entries are not removed from the lists right away; queries
+ *   check every candidate against the record anyway.
+ * - Once stale records outnumber the live ones the lists are
+ *   rebuilt on the next query.
+ *
+ * @param  slot Record slot number.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Trigram_Index_Remove(uint32_t slot)
+{
+    (void)slot;
+
+    F_Return_t status = Trigram_Index_Open();
+    if (status == F_OK)
+        status = Indexes_Mark_Dirty(NULL, TRIGRAM_INDEX_FILE_NAME, &index_header, sizeof(Trigram_Index_Header_t), &index_header.is_clean);
+    if (status == F_OK)
+        index_header.stale++;
+    return status;
+}
+
+/**
+ * @brief  Visits the active students whose first or last name
+ *         starts with, or contains, the given text.
+ *
+ * @details
+ * - The text is normalized like Name_Normalize.
+ * - Substrings shorter than three characters have no trigram,
+ *   those are answered by walking the records until the visitor
+ *   stops.
+ * - Slots are visited in increasing order.
+ *
+ * @param  text    Text to search for.
+ * @param  match   Prefix or substring matching.
+ * @param  visit   Callback for every matching slot.
+ * @param  context Pointer forwarded to the callback.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Trigram_Index_Query(const char* text, Name_Match_t match, Trigram_Index_Visit_t visit, void* context)
+{
+    uint8_t padded[MAX_NAME_LENGTH + 2];
+    const char* wanted = (const char*)&padded[2];
+    const Trigram_List_t* lists[MAX_NAME_LENGTH];
+    uint32_t cursors[MAX_NAME_LENGTH];
+    uint32_t list_count = 0;
+    const Student_t* records = NULL;
+    uint32_t record_count = 0, live = 0, dead = 0;
+    F_Return_t status;
+
+    if (!text || !visit)
+        return F_NOT_OK;
+
+    padded[0] = TRIGRAM_PAD;
+    padded[1] = TRIGRAM_PAD;
+    Name_Normalize(text, (char*)&padded[2]);
+    int length = my_strlen(wanted);
+    if (length == 0)
+        return F_NOT_OK;
+
+    status = Trigram_Index_Open();
+    if (status == F_OK)
+        status = Storage_Get_Counts(&live, &dead);
+
+    /* Drop the entries of removed records once they dominate the lists */
+    if (status == F_OK && index_header.stale > TRIGRAM_STALE_MIN && index_header.stale > live)
+        status = Trigram_Index_Rebuild();
+    if (status == F_OK)
+        status = Storage_Map(&records, &record_count);
+    if (status != F_OK)
+        return status;
+
+    if (match != NAME_MATCH_PREFIX && length < 3)
+    {
+        for (uint32_t slot = 0; slot < record_count; slot++)
+        {
+            if (records[slot].is_active && Trigram_Index_Matches(&records[slot], wanted, match) &&
+                !visit(slot, context))
+                break;
+        }
+        return F_OK;
+    }
+
+    /* A prefix also covers the padding, a substring only its own text */
+    const uint8_t* grams = (match == NAME_MATCH_PREFIX) ? padded : &padded[2];
+    uint32_t gram_count = (match == NAME_MATCH_PREFIX) ? (uint32_t)length : (uint32_t)length - 2;
+
+    for (uint32_t i = 0; i < gram_count; i++)
+    {
+        const Trigram_List_t* list = Find_Bucket(table, table_capacity, Trigram_Key(&grams[i]));
+        if (list->key == 0)
+            return F_OK;
+
+        bool repeated = false;
+        for (uint32_t j = 0; j < list_count; j++)
+            repeated = repeated || (lists[j] == list);
+        if (!repeated)
+            lists[list_count++] = list;
+    }
+
+    /* Drive the intersection from the shortest list */
+    for (uint32_t i = 1; i < list_count; i++)
+    {
+        const Trigram_List_t* list = lists[i];
+        uint32_t j = i;
+        for (; j > 0 && lists[j - 1]->count > list->count; j--)
+            lists[j] = lists[j - 1];
+        lists[j] = list;
+    }
+    my_memset(cursors, 0, sizeof(cursors));
+
+    for (uint32_t i = 0; i < lists[0]->count; i++)
+    {
+        uint32_t slot = lists[0]->slots[i];
+        bool in_all = true;
+
+        for (uint32_t j = 1; j < list_count && in_all; j++)
+        {
+            cursors[j] = Seek(lists[j], cursors[j], slot);
+            if (cursors[j] == lists[j]->count)
+                return F_OK;
+            in_all = (lists[j]->slots[cursors[j]] == slot);
+        }
+
+        /* Lists may still hold removed or renamed records */
+        if (in_all && slot < record_count && records[slot].is_active &&
+            Trigram_Index_Matches(&records[slot], wanted, match) && !visit(slot, context))
+            break;
+    }
+    return F_OK;
+}
@@ -0,0 +1,128 @@
+#ifndef _Trigram_Index_H_
+#define _Trigram_Index_H_
+
+/* ============================================================
+ *  Name Trigram Index
+ *
+ *  Description:
+ *  Maps every three-character sequence (trigram) of the
+ *  normalized first and last names to the sorted slots of the
+ *  students containing it. Names are padded with two marker
+ *  characters in front, so a prefix of any length is a set of
+ *  trigrams as well. A query intersects the lists of its
+ *  trigrams and checks the few surviving candidates against the
+ *  records, so type-ahead search never scans the database.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define TRIGRAM_INDEX_FILE_NAME    "Students_Information.tri"
+#define TRIGRAM_INDEX_MAGIC        0x49525453UL    /* "STRI" */
+#define TRIGRAM_TABLE_MIN_CAPACITY 4096            /* Lists in an empty table */
+#define TRIGRAM_STALE_MIN          1024            /* Stale records tolerated before a purge */
+
+/**
+ * @brief  Called by Trigram_Index_Query for every matching slot.
+ *
+ * @param  slot    Record slot of a matching student.
+ * @param  context Pointer passed to Trigram_Index_Query.
+ * @return true to continue, false to stop the query.
+ */
+typedef bool (*Trigram_Index_Visit_t)(uint32_t slot, void* context);
+
+/**
+ * @brief  Checks a record against a normalized search text.
+ *
+ * @param  student    Record to check.
+ * @param  normalized Search text passed through Name_Normalize.
+ * @param  match      Prefix or substring matching.
+ * @return true if the first or last name matches.
+ */
+bool Trigram_Index_Matches(const Student_t* student, const char* normalized, Name_Match_t match);
+
+/**
+ * @brief  Loads the trigram index, rebuilding it when needed.
+ *
+ * @details
+ * - Rebuilds the lists from the database file when the index
+ *   file is missing, was not closed cleanly, or was built for a
+ *   different generation of the database.
+ *
+ * @return F_OK if the index is ready, otherwise error code.
+ */
+F_Return_t Trigram_Index_Open(void);
+
+/**
+ * @brief  Saves the lists, stamps the index clean and frees them.
+ */
+void Trigram_Index_Close(void);
+
+/**
+ * @brief  Stamps an unchanged search index file with the current generation.
+ *
+ * @details
+ * - Lets other processes load the lists after a change that
+ *   left the names alone, instead of rebuilding them.
+ * - Does nothing if the lists are not loaded or changed since
+ *   they were saved; Trigram_Index_Close saves them then.
+ */
+void Trigram_Index_Flush(void);
+
+/**
+ * @brief  Frees the lists without saving them.
+ */
+void Trigram_Index_Discard(void);
+
+/**
+ * @brief  Rebuilds the lists from the database file.
+ *
+ * @return F_OK if the rebuild succeeds, otherwise error code.
+ */
+F_Return_t Trigram_Index_Rebuild(void);
+
+/**
+ * @brief  Adds the slot of an active record under its name trigrams.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Record stored in that slot.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Trigram_Index_Insert(uint32_t slot, const Student_t* student);
+
+/**
+ * @brief  Records that a slot no longer holds its indexed names.
+ *
+ * @details
+ * - Entries are not removed from the lists right away; queries
+ *   check every candidate against the record anyway.
+ * - Once stale records outnumber the live ones the lists are
+ *   rebuilt on the next query.
+ *
+ * @param  slot Record slot number.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Trigram_Index_Remove(uint32_t slot);
+
+/**
+ * @brief  Visits the active students whose first or last name
+ *         starts with, or contains, the given text.
+ *
+ * @details
+ * - The text is normalized like Name_Normalize.
+ * - Substrings shorter than three characters have no trigram,
+ *   those are answered by walking the records until the visitor
+ *   stops.
+ * - Slots are visited in increasing order.
+ *
+ * @param  text    Text to search for.
+ * @param  match   Prefix or substring matching.
+ * @param  visit   Callback for every matching slot.
+ * @param  context Pointer forwarded to the callback.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t Trigram_Index_Query(const char* text, Name_Match_t match, Trigram_Index_Visit_t visit, void* context);
+
+#endif // !_Trigram_Index_H_
@@ -0,0 +1,353 @@
+#include "WAL.h"
+#include "Platform.h"
+
+/* ============================================================
+ *                    Log Record Layout
+ *
+ *  Every record is a fixed header followed by its payload: the
+ *  slot number and slot image for WAL_RECORD_SLOT, the header
+ *  counters for WAL_RECORD_COMMIT. Sequence numbers start at 1
+ *  after every reset, so stale bytes past a torn write can
+ *  never pass for the next record.
+ * ============================================================ */
+#define WAL_RECORD_SLOT      1
+#define WAL_RECORD_COMMIT    2
+
+typedef struct
+{
+    uint32_t magic;                 /* WAL_RECORD_MAGIC */
+    uint32_t type;                  /* WAL_RECORD_SLOT or WAL_RECORD_COMMIT */
+    uint32_t lsn;                   /* Sequence number in the log */
+    uint32_t length;                /* Payload bytes */
+    uint32_t checksum;              /* CRC-32 of the record with this field zeroed */
+} WAL_Record_Header_t;
+
+typedef struct
+{
+    uint32_t slot;
+    Student_t student;
+} WAL_Slot_Record_t;
+
+static FILE* wal_fp = NULL;
+static long wal_size = 0;           /* Bytes already in the file */
+static uint32_t next_lsn = 1;
+
+/* Records waiting for the next flush */
+static uint8_t* log_buffer = NULL;
+static size_t buffered = 0;
+static size_t buffer_capacity = 0;
+
+static F_Return_t Append_Record(uint32_t type, const void* payload, uint32_t length)
+{
+    WAL_Record_Header_t record;
+    size_t needed = buffered + sizeof(record) + length;
+
+    if (!wal_fp)
+        return F_FILE_OPEN_ERROR;
+
+    if (needed > buffer_capacity)
+    {
+        size_t capacity = (buffer_capacity) ? buffer_capacity : 4096;
+        while (capacity < needed)
+            capacity *= 2;
+
+        uint8_t* grown = realloc(log_buffer, capacity);
+        if (!grown)
+            return F_NOT_OK;
+        log_buffer = grown;
+        buffer_capacity = capacity;
+    }
+
+    record.magic = WAL_RECORD_MAGIC;
+    record.type = type;
+    record.lsn = next_lsn++;
+    record.length = length;
+    record.checksum = 0;
+
+    uint8_t* at = log_buffer + buffered;
+    my_memcpy(at, &record, sizeof(record));
+    my_memcpy(at + sizeof(record), payload, length);
+
+    record.checksum = my_crc32(at, sizeof(record) + length);
+    my_memcpy(at, &record, sizeof(record));
+    buffered = needed;
+    return F_OK;
+}
+
+/**
+ * @brief  Opens the log file, creating it if needed.
+ *
+ * @return F_OK if the log is ready, otherwise F_FILE_OPEN_ERROR.
+ */
+F_Return_t WAL_Open(void)
+{
+    if (wal_fp)
+        return F_OK;
+
+    /* "rb+" keeps a log left by a crash; fall back to "wb+" to create it */
+    wal_fp = fopen(WAL_FILE_NAME, "rb+");
+    if (!wal_fp)
+        wal_fp = fopen(WAL_FILE_NAME, "wb+");
+    if (!wal_fp)
+        return F_FILE_OPEN_ERROR;
+
+    fseek(wal_fp, 0, SEEK_END);
+    wal_size = ftell(wal_fp);
+    next_lsn = 1;
+    buffered = 0;
+    return F_OK;
+}
+
+/**
+ * @brief  Closes the log file, dropping records not yet flushed.
+ */
+void WAL_Close(void)
+{
+    if (!wal_fp)
+        return;
+
+    fclose(wal_fp);
+    wal_fp = NULL;
+
+    free(log_buffer);
+    log_buffer = NULL;
+    buffered = buffer_capacity = 0;
+}
+
+/**
+ * @brief  Replays every committed group found in the log.
+ *
+ * @details
+ * - Stops at the first record that is torn, fails its checksum
+ *   or breaks the sequence; records after the last commit are
+ *   discarded.
+ * - Redo is idempotent, replaying a group twice is harmless.
+ *
+ * @param  redo_slot   Callback for every slot image.
+ * @param  redo_commit Callback for every commit.
+ * @param  context     Pointer forwarded to the callbacks.
+ * @param  groups      Pointer to store the number of groups replayed.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t WAL_Replay(WAL_Redo_Slot_t redo_slot, WAL_Redo_Commit_t redo_commit, void* context, uint32_t* groups)
+{
+    uint8_t raw[sizeof(WAL_Record_Header_t) + sizeof(WAL_Slot_Record_t)];
+    WAL_Record_Header_t record;
+    WAL_Slot_Record_t* group = NULL;
+    uint32_t group_count = 0, group_capacity = 0;
+    uint32_t expected_lsn = 1;
+    F_Return_t status = F_OK;
+
+    if (!redo_slot || !redo_commit || !groups)
+        return F_NOT_OK;
+    if (WAL_Open() != F_OK)
+        return F_FILE_OPEN_ERROR;
+
+    *groups = 0;
+    rewind(wal_fp);
+
+    while (status == F_OK && fread(&record, sizeof(record), 1, wal_fp) == 1)
+    {
+        uint32_t expected_length = (record.type == WAL_RECORD_SLOT) ? sizeof(WAL_Slot_Record_t) :
+                                   (record.type == WAL_RECORD_COMMIT) ? sizeof(WAL_Counters_t) : 0;
+
+        if (record.magic != WAL_RECORD_MAGIC || record.lsn != expected_lsn ||
+            expected_length == 0 || record.length != expected_length ||
+            fread(raw + sizeof(record), record.length, 1, wal_fp) != 1)
+            break;
+
+        uint32_t checksum = record.checksum;
+        record.checksum = 0;
+        my_memcpy(raw, &record, sizeof(record));
+        if (my_crc32(raw, sizeof(record) + record.length) != checksum)
+            break;
+        expected_lsn++;
+
+        if (record.type == WAL_RECORD_SLOT)
+        {
+            if (group_count == group_capacity)
+            {
+                uint32_t capacity = (group_capacity) ? 2 * group_capacity : WAL_GROUP_COMMIT_RECORDS;
+                WAL_Slot_Record_t* grown = realloc(group, capacity * sizeof(WAL_Slot_Record_t));
+                if (!grown)
+                {
+                    status = F_NOT_OK;
+                    break;
+                }
+                group = grown;
+                group_capacity = capacity;
+            }
+            my_memcpy(&group[group_count++], raw + sizeof(record), sizeof(WAL_Slot_Record_t));
+            continue;
+        }
+
+        /* ---------- Commit: the group is complete, apply it ---------- */
+        WAL_Counters_t counters;
+        my_memcpy(&counters, raw + sizeof(record), sizeof(counters));
+
+        for (uint32_t i = 0; i < group_count && status == F_OK; i++)
+            status = redo_slot(group[i].slot, &group[i].student, context);
+        if (status == F_OK)
+            status = redo_commit(&counters, context);
+        if (status == F_OK)
+            (*groups)++;
+        group_count = 0;
+    }
+
+    free(group);
+    return status;
+}
+
+/**
+ * @brief  Buffers the redo record of one slot write.
+ *
+ * @param  slot    Record slot number.
+ * @param  student New slot image.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t WAL_Log_Slot(uint32_t slot, const Student_t* student)
+{
+    WAL_Slot_Record_t payload;
+
+    if (!student)
+        return F_NOT_OK;
+
+    my_memset(&payload, 0, sizeof(payload));
+    payload.slot = slot;
+    payload.student = *student;
+    return Append_Record(WAL_RECORD_SLOT, &payload, sizeof(payload));
+}
+
+/**
+ * @brief  Buffers a commit record closing the current group.
+ *
+ * @param  counters Header counters after the group.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t WAL_Log_Commit(const WAL_Counters_t* counters)
+{
+    if (!counters)
+        return F_NOT_OK;
+    return Append_Record(WAL_RECORD_COMMIT, counters, sizeof(WAL_Counters_t));
+}
+
+/**
+ * @brief  Appends the buffered records to the log file.
+ *
+ * @details
+ * - One write call for the whole buffer.
+ * - With sync set the file is also flushed to the disk, after
+ *   which the buffered changes survive a crash.
+ *
+ * @param  sync Force the log to stable storage.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t WAL_Flush(bool sync)
+{
+    if (!wal_fp)
+        return F_FILE_OPEN_ERROR;
+
+    if (buffered > 0)
+    {
+        if (fseek(wal_fp, wal_size, SEEK_SET) != 0 ||
+            fwrite(log_buffer, 1, buffered, wal_fp) != buffered)
+            return F_FILE_WRITE_ERROR;
+        wal_size += (long)buffered;
+        buffered = 0;
+    }
+
+    if (sync)
+        return (Platform_Sync_File(wal_fp) == 0) ? F_OK : F_FILE_WRITE_ERROR;
+    return (fflush(wal_fp) == 0) ? F_OK : F_FILE_WRITE_ERROR;
+}
+
+/**
+ * @brief  Checks whether the log has grown past WAL_CHECKPOINT_BYTES.
+ *
+ * @return true if a checkpoint is due.
+ */
+bool WAL_Needs_Checkpoint(void)
+{
+    return wal_size >= WAL_CHECKPOINT_BYTES;
+}
+
+/**
+ * @brief  Checks that the log file ends where this process left it.
+ *
+ * @details
+ * - Another process writing to the log changes its size.
+ *
+ * @return true if the log is open and nobody else changed its size.
+ */
+bool WAL_Is_Current(void)
+{
+    if (!wal_fp || fseek(wal_fp, 0, SEEK_END) != 0)
+        return false;
+    return ftell(wal_fp) == wal_size;
+}
+
+/**
+ * @brief  Records the current end of the log.
+ *
+ * @details
+ * - Must be taken with no records buffered, right after a flush.
+ *
+ * @param  savepoint Pointer to store the log position.
+ */
+void WAL_Savepoint(WAL_Savepoint_t* savepoint)
+{
+    savepoint->size = wal_size;
+    savepoint->lsn = next_lsn;
+}
+
+/**
+ * @brief  Drops every record logged after a savepoint.
+ *
+ * @details
+ * - Discards buffered records and cuts off any that already
+ *   reached the file, so the sequence numbers continue from the
+ *   savepoint.
+ *
+ * @param  savepoint Position taken with WAL_Savepoint.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t WAL_Rollback(const WAL_Savepoint_t* savepoint)
+{
+    if (!wal_fp || !savepoint)
+        return F_FILE_OPEN_ERROR;
+
+    buffered = 0;
+    next_lsn = savepoint->lsn;
+
+    /* A failed flush may have left records in the file, even past wal_size */
+    if (fseek(wal_fp, 0, SEEK_END) != 0)
+        return F_FILE_WRITE_ERROR;
+    if (ftell(wal_fp) <= savepoint->size)
+        return F_OK;
+
+    if (Platform_Truncate_File(wal_fp, savepoint->size) != 0 || Platform_Sync_File(wal_fp) != 0)
+        return F_FILE_WRITE_ERROR;
+    wal_size = savepoint->size;
+    return F_OK;
+}
+
+/**
+ * @brief  Empties the log once its changes are durable in the database.
+ *
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t WAL_Reset(void)
+{
+    if (!wal_fp)
+        return F_FILE_OPEN_ERROR;
+
+    buffered = 0;
+    next_lsn = 1;
+    if (wal_size == 0)
+        return F_OK;
+
+    if (Platform_Truncate_File(wal_fp, 0) != 0 || Platform_Sync_File(wal_fp) != 0)
+        return F_FILE_WRITE_ERROR;
+    wal_size = 0;
+    return F_OK;
+}
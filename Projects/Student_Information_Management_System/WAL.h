@@ -0,0 +1,171 @@
+#ifndef _WAL_H_
+#define _WAL_H_
+
+/* ============================================================
+ *  Write-Ahead Log
+ *
+ *  Description:
+ *  Append-only log of the changes made to the database file.
+ *  Every slot write becomes a small checksummed redo record
+ *  holding the new slot image, and every commit a record
+ *  holding the header counters it leaves behind. Records are
+ *  buffered in memory and reach the disk with one sequential
+ *  append and one sync per commit group, before the database
+ *  file itself is touched. After a crash the committed groups
+ *  are replayed into the database file; a torn or uncommitted
+ *  tail is ignored.
+ * ============================================================ */
+
+#include"System.h"
+
+/* ============================================================
+ *                    Configuration Macros
+ * ============================================================ */
+#define WAL_FILE_NAME              "Students_Information.wal"
+#define WAL_RECORD_MAGIC           0x4C415753UL    /* "SWAL" */
+#define WAL_GROUP_COMMIT_RECORDS   256             /* Slot writes held before the group is synced */
+#define WAL_CHECKPOINT_BYTES       (4L * 1024 * 1024)  /* Log size that triggers a checkpoint */
+#define WAL_SYNC_ON_COMMIT         1               /* 0: commits wait for the group to fill */
+
+/* Header counters restored by a committed group */
+typedef struct
+{
+    uint32_t record_count;
+    uint32_t live_count;
+    uint32_t dead_count;
+    uint32_t generation;
+} WAL_Counters_t;
+
+/* Log position a rolled back transaction returns to */
+typedef struct
+{
+    long size;
+    uint32_t lsn;
+} WAL_Savepoint_t;
+
+/**
+ * @brief  Called by WAL_Replay for every slot image of a committed group.
+ *
+ * @param  slot    Record slot number.
+ * @param  student Slot image to write.
+ * @param  context Pointer passed to WAL_Replay.
+ * @return F_OK to continue, otherwise error code.
+ */
+typedef F_Return_t (*WAL_Redo_Slot_t)(uint32_t slot, const Student_t* student, void* context);
+
+/**
+ * @brief  Called by WAL_Replay once a group's slot images are applied.
+ *
+ * @param  counters Header counters committed with the group.
+ * @param  context  Pointer passed to WAL_Replay.
+ * @return F_OK to continue, otherwise error code.
+ */
+typedef F_Return_t (*WAL_Redo_Commit_t)(const WAL_Counters_t* counters, void* context);
+
+/**
+ * @brief  Opens the log file, creating it if needed.
+ *
+ * @return F_OK if the log is ready, otherwise F_FILE_OPEN_ERROR.
+ */
+F_Return_t WAL_Open(void);
+
+/**
+ * @brief  Closes the log file, dropping records not yet flushed.
+ */
+void WAL_Close(void);
+
+/**
+ * @brief  Replays every committed group found in the log.
+ *
+ * @details
+ * - Stops at the first record that is torn, fails its checksum
+ *   or breaks the sequence; records after the last commit are
+ *   discarded.
+ * - Redo is idempotent, replaying a group twice is harmless.
+ *
+ * @param  redo_slot   Callback for every slot image.
+ * @param  redo_commit Callback for every commit.
+ * @param  context     Pointer forwarded to the callbacks.
+ * @param  groups      Pointer to store the number of groups replayed.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t WAL_Replay(WAL_Redo_Slot_t redo_slot, WAL_Redo_Commit_t redo_commit, void* context, uint32_t* groups);
+
+/**
+ * @brief  Buffers the redo record of one slot write.
+ *
+ * @param  slot    Record slot number.
+ * @param  student New slot image.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t WAL_Log_Slot(uint32_t slot, const Student_t* student);
+
+/**
+ * @brief  Buffers a commit record closing the current group.
+ *
+ * @param  counters Header counters after the group.
+ * @return F_OK on success, otherwise error code.
+ */
+F_Return_t WAL_Log_Commit(const WAL_Counters_t* counters);
+
+/**
+ * @brief  Appends the buffered records to the log file.
+ *
+ * @details
+ * - One write call for the whole buffer.
+ * - With sync set the file is also flushed to the disk, after
+ *   which the buffered changes survive a crash.
+ *
+ * @param  sync Force the log to stable storage.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t WAL_Flush(bool sync);
+
+/**
+ * @brief  Checks whether the log has grown past WAL_CHECKPOINT_BYTES.
+ *
+ * @return true if a checkpoint is due.
+ */
+bool WAL_Needs_Checkpoint(void);
+
+/**
+ * @brief  Checks that the log file ends where this process left it.
+ *
+ * @details
+ * - Another process writing to the log changes its size.
+ *
+ * @return true if the log is open and nobody else changed its size.
+ */
+bool WAL_Is_Current(void);
+
+/**
+ * @brief  Records the current end of the log.
+ *
+ * @details
+ * - Must be taken with no records buffered, right after a flush.
+ *
+ * @param  savepoint Pointer to store the log position.
+ */
+void WAL_Savepoint(WAL_Savepoint_t* savepoint);
+
+/**
+ * @brief  Drops every record logged after a savepoint.
+ *
+ * @details
+ * - Discards buffered records and cuts off any that already
+ *   reached the file, so the sequence numbers continue from the
+ *   savepoint.
+ *
+ * @param  savepoint Position taken with WAL_Savepoint.
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t WAL_Rollback(const WAL_Savepoint_t* savepoint);
+
+/**
+ * @brief  Empties the log once its changes are durable in the database.
+ *
+ * @return F_OK on success, otherwise F_FILE_WRITE_ERROR.
+ */
+F_Return_t WAL_Reset(void);
+
+#endif // !_WAL_H_
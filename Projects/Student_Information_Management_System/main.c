@@ -1,10 +1,33 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include "App.h"
+#include "Server.h"
+#include <stdlib.h>
+#include <string.h>
 
-int main() {
+/*
+ * Without arguments runs the interactive menu. Otherwise:
+ *   --server [address]           serve the database
+ *   --bench [address] [seconds]  measure a server's lookups per second
+ *   --export file [csv|binary] [columns]
+ *                                write the active students to a file
+ */
+int main(int argc, char* argv[]) {
+
+	const char* address = (argc > 2) ? argv[2] : SERVER_DEFAULT_ADDRESS;
+
+	if (argc > 1 && strcmp(argv[1], "--server") == 0)
+		return (Server_Run(address) == F_OK) ? 0 : 1;
+
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+		App_Benchmark(address, (argc > 3) ? atof(argv[3]) : 5.0);
+		return 0;
+	}
+
+	if (argc > 2 && strcmp(argv[1], "--export") == 0)
+		return (App_Export(argv[2], (argc > 3) ? argv[3] : "csv", (argc > 4) ? argv[4] : NULL) == F_OK) ? 0 : 1;
 
 	App_System();
 
 	return 0;
-}
\ No newline at end of file
+}